@@ -1,8 +1,9 @@
 # qtractor.pro
 #
 TEMPLATE = subdirs
-SUBDIRS = src qtractor_vst_scan
+SUBDIRS = src qtractor_vst_scan qtractor_plugin_host
 
 qtractor_vst_scan.file = src/qtractor_vst_scan.pro
+qtractor_plugin_host.file = src/qtractor_plugin_host.pro
 
-src.depends = qtractor_vst_scan
+src.depends = qtractor_vst_scan qtractor_plugin_host
@@ -331,6 +331,8 @@ bool qtractorAudioClip::openAudioFile ( const QString& sFilename, int iMode )
 			sFilename, pBuff->timeStretch());
 		if (bWrite)
 			pBuff->setPeak(m_pPeak);
+		else // Get peak file (re)created in the background, if due...
+			m_pPeak->schedule();
 	}
 
 	// Clip name should be clear about it all.
@@ -0,0 +1,145 @@
+// qtractorAudioDelay.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2016, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAudioDelay.h"
+
+#include <string.h>
+
+
+//----------------------------------------------------------------------------
+// qtractorAudioDelay -- Audio delay-line (latency compensation).
+
+// Largest clamped delay request (global).
+static qtractorAtomic g_iClampedDelay;
+
+
+// Constructor.
+qtractorAudioDelay::qtractorAudioDelay (void)
+	: m_iChannels(0), m_ppBuffers(NULL), m_iIndex(0), m_iDelay(0)
+{
+}
+
+
+// Destructor.
+qtractorAudioDelay::~qtractorAudioDelay (void)
+{
+	setChannels(0);
+}
+
+
+// Channel count (re)allocation (non-RT).
+void qtractorAudioDelay::setChannels ( unsigned short iChannels )
+{
+	if (m_ppBuffers) {
+		for (unsigned short i = 0; i < m_iChannels; ++i)
+			delete [] m_ppBuffers[i];
+		delete [] m_ppBuffers;
+		m_ppBuffers = NULL;
+	}
+
+	m_iChannels = iChannels;
+	m_iIndex = 0;
+	m_iDelay = 0;
+
+	if (m_iChannels > 0) {
+		m_ppBuffers = new float * [m_iChannels];
+		for (unsigned short i = 0; i < m_iChannels; ++i)
+			m_ppBuffers[i] = new float [MaxDelay];
+		reset();
+	}
+}
+
+
+// Clear delay-line contents.
+void qtractorAudioDelay::reset (void)
+{
+	for (unsigned short i = 0; i < m_iChannels; ++i)
+		::memset(m_ppBuffers[i], 0, MaxDelay * sizeof(float));
+
+	m_iIndex = 0;
+}
+
+
+// Delay-line processor (RT; buffers may be the same).
+void qtractorAudioDelay::process ( float **ppIBuffer, float **ppOBuffer,
+	unsigned int nframes, unsigned long iDelay )
+{
+	if (iDelay >= MaxDelay) {
+		// Not silently: keep note for later report...
+		int iClamped = ATOMIC_GET(&g_iClampedDelay);
+		while (iClamped < int(iDelay)
+			&& !ATOMIC_CAS(&g_iClampedDelay, iClamped, int(iDelay)))
+			iClamped = ATOMIC_GET(&g_iClampedDelay);
+		iDelay = MaxDelay - 1;
+	}
+
+	// Starting over from a plain pass-thru?
+	if (iDelay != m_iDelay) {
+		if (m_iDelay == 0)
+			reset();
+		m_iDelay = iDelay;
+	}
+
+	if (m_iDelay == 0) {
+		if (ppOBuffer != ppIBuffer) {
+			for (unsigned short i = 0; i < m_iChannels; ++i)
+				::memcpy(ppOBuffer[i], ppIBuffer[i], nframes * sizeof(float));
+		}
+		return;
+	}
+
+	const unsigned int iMask = MaxDelay - 1;
+
+	for (unsigned short i = 0; i < m_iChannels; ++i) {
+		const float *pIBuffer = ppIBuffer[i];
+		float *pOBuffer = ppOBuffer[i];
+		float *pDelay   = m_ppBuffers[i];
+		unsigned int w = m_iIndex;
+		unsigned int r = (w - m_iDelay) & iMask;
+		for (unsigned int n = 0; n < nframes; ++n) {
+			pDelay[w] = pIBuffer[n];
+			pOBuffer[n] = pDelay[r];
+			++w &= iMask;
+			++r &= iMask;
+		}
+	}
+
+	m_iIndex = (m_iIndex + nframes) & iMask;
+}
+
+
+// Largest delay requested beyond MaxDelay, since last asked (non-RT).
+unsigned long qtractorAudioDelay::clampReport (void)
+{
+	// Report only once, while it stays the same...
+	static unsigned long s_iClampedDelay = 0;
+
+	const unsigned long iClampedDelay
+		= (unsigned long) ATOMIC_TAZ(&g_iClampedDelay);
+	if (iClampedDelay == s_iClampedDelay)
+		return 0;
+
+	s_iClampedDelay = iClampedDelay;
+	return iClampedDelay;
+}
+
+
+// end of qtractorAudioDelay.cpp
@@ -0,0 +1,80 @@
+// qtractorAudioDelay.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2016, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorAudioDelay_h
+#define __qtractorAudioDelay_h
+
+#include "qtractorAtomic.h"
+
+
+//----------------------------------------------------------------------------
+// qtractorAudioDelay -- Audio delay-line (latency compensation).
+
+class qtractorAudioDelay
+{
+public:
+
+	// Constructor.
+	qtractorAudioDelay();
+
+	// Destructor.
+	~qtractorAudioDelay();
+
+	// Maximum delay (in frames; power of two).
+	enum { MaxDelay = (1 << 14) };
+
+	// Channel count (re)allocation (non-RT).
+	void setChannels(unsigned short iChannels);
+	unsigned short channels() const
+		{ return m_iChannels; }
+
+	// Current delay (in frames).
+	unsigned long delay() const
+		{ return m_iDelay; }
+
+	// Clear delay-line contents.
+	void reset();
+
+	// Delay-line processor (RT; buffers may be the same).
+	void process(float **ppIBuffer, float **ppOBuffer,
+		unsigned int nframes, unsigned long iDelay);
+
+	// In-place delay-line processor (RT).
+	void process(float **ppBuffer, unsigned int nframes, unsigned long iDelay)
+		{ process(ppBuffer, ppBuffer, nframes, iDelay); }
+
+	// Largest delay requested beyond MaxDelay, since last asked
+	// (non-RT; zero if none or already reported).
+	static unsigned long clampReport();
+
+private:
+
+	// Instance variables.
+	unsigned short m_iChannels;
+	float        **m_ppBuffers;
+	unsigned int   m_iIndex;
+	unsigned long  m_iDelay;
+};
+
+
+#endif  // __qtractorAudioDelay_h
+
+// end of qtractorAudioDelay.h
@@ -34,6 +34,7 @@
 #include "qtractorMidiEngine.h"
 #include "qtractorMidiManager.h"
 #include "qtractorPlugin.h"
+#include "qtractorInsertPlugin.h"
 #include "qtractorClip.h"
 
 #include "qtractorCurveFile.h"
@@ -57,6 +58,9 @@
 #include <QApplication>
 #include <QProgressBar>
 #include <QDomDocument>
+#include <QThread>
+#include <QSemaphore>
+#include <QFile>
 
 #if defined(__SSE__)
 
@@ -137,6 +141,31 @@ static inline void std_buffer_add (
 }
 
 
+//----------------------------------------------------------------------
+// Audio-export range of a process cycle, as shifted by the path latency:
+// returns the number of frames to write, starting at the given offset.
+//
+
+static inline unsigned int qtractor_export_frames (
+	unsigned long iFrameStart, unsigned int nframes,
+	unsigned long iExportStart, unsigned long iExportEnd,
+	unsigned int& iOffset )
+{
+	const unsigned long iFrameEnd = iFrameStart + nframes;
+
+	iOffset = 0;
+
+	if (iFrameEnd <= iExportStart || iFrameStart >= iExportEnd)
+		return 0;
+
+	if (iFrameStart < iExportStart)
+		iOffset = iExportStart - iFrameStart;
+
+	return (iFrameEnd > iExportEnd ? iExportEnd : iFrameEnd)
+		- (iFrameStart + iOffset);
+}
+
+
 //----------------------------------------------------------------------
 // qtractorAudioExportBuffer -- name tells all: audio export buffer.
 //
@@ -153,6 +182,7 @@ public:
 		m_iBufferSize = iBufferSize;
 
 		m_ppBuffer = new float * [m_iChannels];
+		m_ppOffset = new float * [m_iChannels];
 
 		for (unsigned short i = 0; i < m_iChannels; ++i)
 			m_ppBuffer[i] = new float [iBufferSize];
@@ -171,6 +201,7 @@ public:
 		for (unsigned short i = 0; i < m_iChannels; ++i)
 			delete m_ppBuffer[i];
 
+		delete [] m_ppOffset;
 		delete [] m_ppBuffer;
 	}
 
@@ -184,6 +215,15 @@ public:
 	float **buffer() const
 		{ return m_ppBuffer; }
 
+	// Mix-down buffer, from some frame offset.
+	float **buffer(unsigned int iOffset)
+	{
+		for (unsigned short i = 0; i < m_iChannels; ++i)
+			m_ppOffset[i] = m_ppBuffer[i] + iOffset;
+
+		return m_ppOffset;
+	}
+
 	// Prepare mix-down buffer.
 	void process_prepare(unsigned int nframes)
 	{
@@ -204,8 +244,9 @@ private:
 	unsigned short m_iChannels;
 	unsigned int m_iBufferSize;
 
-	// Mix-down buffer.
+	// Mix-down buffer (and offset pointers).
 	float **m_ppBuffer;
+	float **m_ppOffset;
 
 	// Mix-down buffer processor.
 	void (*m_pfnBufferAdd)(float **, float **, unsigned int,
@@ -213,6 +254,149 @@ private:
 };
 
 
+//----------------------------------------------------------------------
+// qtractorAudioExportStem -- per-track stem export file writer.
+//
+// Rendered blocks are handed over through a bounded ring and get
+// written (and encoded) to file on their own thread, so that many
+// stems may be written concurrently in one single export pass.
+
+class qtractorAudioExportStem : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorAudioExportStem(qtractorAudioFile *pFile,
+		unsigned short iChannels, unsigned int iBufferSize,
+		unsigned int iBlocks = 16)
+		: QThread(), m_pFile(pFile), m_iChannels(iChannels),
+			m_iBufferSize(iBufferSize), m_iExportStart(0), m_iExportEnd(0),
+			m_iBlocks(iBlocks),
+			m_iWrite(0), m_iRead(0), m_free(iBlocks), m_used(0)
+	{
+		m_pppBlocks = new float ** [m_iBlocks];
+		m_piFrames  = new unsigned int [m_iBlocks];
+		for (unsigned int k = 0; k < m_iBlocks; ++k) {
+			m_pppBlocks[k] = new float * [m_iChannels];
+			for (unsigned short i = 0; i < m_iChannels; ++i)
+				m_pppBlocks[k][i] = new float [m_iBufferSize];
+			m_piFrames[k] = 0;
+		}
+	}
+
+	// Destructor.
+	~qtractorAudioExportStem()
+	{
+		close();
+
+		for (unsigned int k = 0; k < m_iBlocks; ++k) {
+			for (unsigned short i = 0; i < m_iChannels; ++i)
+				delete [] m_pppBlocks[k][i];
+			delete [] m_pppBlocks[k];
+		}
+		delete [] m_piFrames;
+		delete [] m_pppBlocks;
+
+		if (m_pFile)
+			delete m_pFile;
+	}
+
+	// Export range, already shifted by this stem path latency.
+	void setExportRange(unsigned long iExportStart, unsigned long iExportEnd)
+		{ m_iExportStart = iExportStart; m_iExportEnd = iExportEnd; }
+
+	// Queue the export range part of a process cycle.
+	void process(float **ppBuffer, unsigned short iChannels,
+		unsigned long iFrameStart, unsigned int nframes)
+	{
+		unsigned int iOffset = 0;
+		nframes = qtractor_export_frames(iFrameStart, nframes,
+			m_iExportStart, m_iExportEnd, iOffset);
+		if (nframes > 0)
+			write(ppBuffer, iChannels, nframes, iOffset);
+	}
+
+	// Queue one rendered block for writing
+	// (blocks while the writer lags behind).
+	void write(float **ppBuffer, unsigned short iChannels,
+		unsigned int nframes, unsigned int iOffset = 0)
+	{
+		if (nframes > m_iBufferSize)
+			nframes = m_iBufferSize;
+
+		m_free.acquire();
+
+		float **ppBlock = m_pppBlocks[m_iWrite];
+		const unsigned int nbytes = nframes * sizeof(float);
+		for (unsigned short i = 0; i < m_iChannels; ++i) {
+			if (i < iChannels)
+				::memcpy(ppBlock[i], ppBuffer[i] + iOffset, nbytes);
+			else
+				::memset(ppBlock[i], 0, nbytes);
+		}
+		m_piFrames[m_iWrite] = nframes;
+
+		++m_iWrite %= m_iBlocks;
+		m_used.release();
+	}
+
+	// Flush pending blocks and close the file.
+	void close()
+	{
+		if (isRunning()) {
+			// Zero-length block is the end-of-stem mark...
+			m_free.acquire();
+			m_piFrames[m_iWrite] = 0;
+			++m_iWrite %= m_iBlocks;
+			m_used.release();
+			QThread::wait();
+		}
+
+		if (m_pFile)
+			m_pFile->close();
+	}
+
+protected:
+
+	// The main thread executive.
+	void run()
+	{
+		for (;;) {
+			m_used.acquire();
+			const unsigned int nframes = m_piFrames[m_iRead];
+			if (nframes > 0)
+				m_pFile->write(m_pppBlocks[m_iRead], nframes);
+			++m_iRead %= m_iBlocks;
+			m_free.release();
+			if (nframes == 0)
+				break;
+		}
+	}
+
+private:
+
+	// Instance variables.
+	qtractorAudioFile *m_pFile;
+
+	unsigned short m_iChannels;
+	unsigned int   m_iBufferSize;
+
+	unsigned long  m_iExportStart;
+	unsigned long  m_iExportEnd;
+
+	// Block ring buffer.
+	unsigned int   m_iBlocks;
+	float       ***m_pppBlocks;
+	unsigned int  *m_piFrames;
+
+	unsigned int   m_iWrite;
+	unsigned int   m_iRead;
+
+	QSemaphore     m_free;
+	QSemaphore     m_used;
+};
+
+
 //----------------------------------------------------------------------
 // qtractorAudioEngine_process -- JACK client process callback.
 //
@@ -393,6 +577,22 @@ static int qtractorAudioEngine_sync (
 }
 
 
+#ifdef CONFIG_JACK_LATENCY
+//----------------------------------------------------------------------
+// qtractorAudioEngine_latency -- JACK latency callback.
+//
+
+static void qtractorAudioEngine_latency (
+	jack_latency_callback_mode_t mode, void *pvArg )
+{
+	qtractorAudioEngine *pAudioEngine
+		= static_cast<qtractorAudioEngine *> (pvArg);
+
+	pAudioEngine->latencyCallback(mode);
+}
+#endif
+
+
 #ifdef CONFIG_JACK_METADATA
 //----------------------------------------------------------------------
 // qtractorAudioEngine_property_change -- JACK property change callabck
@@ -431,6 +631,12 @@ qtractorAudioEngine::qtractorAudioEngine ( qtractorSession *pSession )
 	// Audio-export freewheeling (internal) state.
 	m_bFreewheel = false;
 
+	m_iDenormalsState = -1;
+
+	// Latency compensation state.
+	m_iMaxLatency = 0;
+	ATOMIC_SET(&m_latencyChanged, 0);
+
 	// Common audio buffer sync thread.
 	m_pSyncThread = NULL;
 
@@ -439,8 +645,11 @@ qtractorAudioEngine::qtractorAudioEngine ( qtractorSession *pSession )
 	m_pExportFile  = NULL;
 	m_pExportBuses = NULL;
 	m_pExportBuffer = NULL;
+	m_pExportStems = NULL;
+	m_pExportStemsEx = NULL;
 	m_iExportStart = 0;
 	m_iExportEnd   = 0;
+	m_iExportLatency = 0;
 	m_bExportDone  = true;
 
 	// Audio metronome stuff.
@@ -661,6 +870,12 @@ bool qtractorAudioEngine::activate (void)
 	jack_set_freewheel_callback(m_pJackClient,
 		qtractorAudioEngine_freewheel, this);
 
+#ifdef CONFIG_JACK_LATENCY
+	// Set JACK latency callback (compensation report).
+	jack_set_latency_callback(m_pJackClient,
+		qtractorAudioEngine_latency, this);
+#endif
+
 #ifdef CONFIG_JACK_SESSION
 	// Set JACK session event callback.
 	if (jack_set_session_callback) {
@@ -809,6 +1024,23 @@ void qtractorAudioEngine::clean (void)
 		m_pExportFile = NULL;
 	}
 
+	if (m_pExportStems) {
+		qDeleteAll(*m_pExportStems);
+		delete m_pExportStems;
+		m_pExportStems = NULL;
+	}
+
+	if (m_pExportStemsEx) {
+		delete m_pExportStemsEx;
+		m_pExportStemsEx = NULL;
+	}
+
+	// Parallel plugin instance workers are JACK threads too.
+	qtractorPlugin::deleteInstancePool();
+
+	// Dormant plugins wake-up worker goes too.
+	qtractorPlugin::deleteWakeThread();
+
 	// Close the JACK client, finally.
 	if (m_pJackClient) {
 		jack_client_close(m_pJackClient);
@@ -831,6 +1063,9 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 	// Reset buffer offset.
 	m_iBufferOffset = 0;
 
+	// Plugin output guard wants no denormals around...
+	qtractorPluginList::updateDenormalsZero(&m_iDenormalsState);
+
 	// Are we actually freewheeling for export?...
 	// notice that freewheeling has no RT requirements.
 	if (m_bFreewheel) {
@@ -880,6 +1115,9 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 			pAudioBus->process_monitor(nframes);
 	}
 
+	// Latency compensation (path delays) update...
+	updateLatency();
+
 	// The owned buses too, if any...
 	if (m_bMetroBus && m_pMetroBus)
 		m_pMetroBus->process_prepare(nframes);
@@ -949,6 +1187,8 @@ int qtractorAudioEngine::process ( unsigned int nframes )
 						pOutputBus->buffer_prepare(nframes, pInputBus);
 						if (pPluginList->isActivated())
 							pPluginList->process(pOutputBus->buffer(), nframes);
+						pPluginList->process_latency(pOutputBus->buffer(),
+							nframes, pOutputBus->trackLatency());
 						pAudioMonitor->process(pOutputBus->buffer(), nframes);
 						pOutputBus->buffer_commit(nframes);
 						++iOutputBus;
@@ -1101,12 +1341,19 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 			pAudioBusEx->process_prepare(nframes);
 	}
 
+	// Latency compensation (path delays) update...
+	updateLatency();
+
 	// This the legal process cycle frame range...
 	const unsigned long iFrameStart = pAudioCursor->frame();
 	const unsigned long iFrameEnd   = iFrameStart + nframes;
 
+	// Latency compensation: rendering runs past the export
+	// range, as much as output is delayed (maximum path latency)...
+	const unsigned long iExportEnd = m_iExportEnd + m_iExportLatency;
+
 	// Write output bus buffers to export audio file...
-	if (iFrameStart < m_iExportEnd && iFrameEnd > m_iExportStart) {
+	if (iFrameStart < iExportEnd && iFrameEnd > m_iExportStart) {
 		// Prepare mix-down buffer...
 		m_pExportBuffer->process_prepare(nframes);
 		// Force/sync every audio clip approaching...
@@ -1115,35 +1362,76 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 		qtractorLv2Plugin::updateTime(m_pJackClient);
 	#endif
 	#endif
+		// Render MIDI tracks first, feeding their plugin managers
+		// directly with this very same block events, sample-accurate
+		// and independent of the MIDI output queue timing...
+		int iTrack = 0;
+		qtractorTrack *pTrack = pSession->tracks().first();
+		for ( ; pTrack; pTrack = pTrack->next()) {
+			if (pTrack->trackType() == qtractorTrack::Midi)
+				pTrack->process_export(pAudioCursor->clip(iTrack),
+					iFrameStart, iFrameEnd);
+			++iTrack;
+		}
 		// MIDI plugin manager processing...
 		qtractorMidiManager *pMidiManager
 			= pSession->midiManagers().first();
 		while (pMidiManager) {
 			pMidiManager->process(iFrameStart, iFrameEnd);
+			// Instrument track stem, if any...
+			qtractorAudioBus *pAudioBus = pMidiManager->audioOutputBus();
+			if (m_pExportStemsEx && pAudioBus) {
+				qtractorAudioExportStem *pStem
+					= m_pExportStemsEx->value(pMidiManager, NULL);
+				if (pStem) {
+					pStem->process(pMidiManager->isAudioOutputBus()
+						? pAudioBus->out() : pAudioBus->buffer(),
+						pAudioBus->channels(), iFrameStart, nframes);
+				}
+			}
 			pMidiManager = pMidiManager->next();
 		}
-		// Perform all tracks processing...
-		int iTrack = 0;
-		for (qtractorTrack *pTrack = pSession->tracks().first();
-				pTrack; pTrack = pTrack->next()) {
-			pTrack->process_export(pAudioCursor->clip(iTrack),
-				iFrameStart, iFrameEnd);
+		// Perform all remaining (audio) tracks processing...
+		iTrack = 0;
+		pTrack = pSession->tracks().first();
+		for ( ; pTrack; pTrack = pTrack->next()) {
+			if (pTrack->trackType() != qtractorTrack::Midi) {
+				pTrack->process_export(pAudioCursor->clip(iTrack),
+					iFrameStart, iFrameEnd);
+				// Audio track stem, if any...
+				qtractorAudioBus *pAudioBus
+					= static_cast<qtractorAudioBus *> (pTrack->outputBus());
+				if (m_pExportStems && pAudioBus) {
+					qtractorAudioExportStem *pStem
+						= m_pExportStems->value(pTrack, NULL);
+					if (pStem) {
+						pStem->process(pAudioBus->buffer(),
+							pAudioBus->channels(), iFrameStart, nframes);
+					}
+				}
+			}
 			++iTrack;
 		}
 		// Prepare advance for next cycle...
 		pAudioCursor->seek(iFrameEnd);
-		// Check end-of-export...
-		if (iFrameEnd > m_iExportEnd)
-			nframes -= (iFrameEnd - m_iExportEnd);
+		// Mix-down gets the export range, shifted by latency...
+		unsigned int iOffset = 0;
+		const unsigned int iExportFrames = qtractor_export_frames(
+			iFrameStart, nframes, m_iExportStart + m_iExportLatency,
+			iExportEnd, iOffset);
 		// Commit the output buses...
 		iter.toFront();
 		while (iter.hasNext()) {
 			qtractorAudioBus *pExportBus = iter.next();
 			pExportBus->process_commit(nframes);
-			m_pExportBuffer->process_add(pExportBus, nframes);
+			if (iExportFrames > 0)
+				m_pExportBuffer->process_add(pExportBus, iExportFrames, iOffset);
 		}
 		// Write to export file...
-		m_pExportFile->write(m_pExportBuffer->buffer(), nframes);
+		if (iExportFrames > 0) {
+			m_pExportFile->write(
+				m_pExportBuffer->buffer(iOffset), iExportFrames);
+		}
 		// HACK! Freewheeling observers update (non RT safe!)...
 		qtractorSubject::flushQueue(false);
 	} else {
@@ -1187,6 +1475,188 @@ void qtractorAudioEngine::process_export ( unsigned int nframes )
 }
 
 
+// Latency compensation (path delays) update (RT).
+void qtractorAudioEngine::updateLatency (void)
+{
+	qtractorSession *pSession = session();
+	if (pSession == NULL)
+		return;
+
+	qtractorBus *pBus;
+	qtractorAudioBus *pAudioBus;
+
+	// Reset all output path latencies...
+	for (pBus = buses().first(); pBus; pBus = pBus->next()) {
+		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus)
+			pAudioBus->resetLatency();
+	}
+
+	for (pBus = busesEx().first(); pBus; pBus = pBus->next()) {
+		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus)
+			pAudioBus->resetLatency();
+	}
+
+	// Audio track paths: maximum latency per output bus...
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		if (pTrack->trackType() != qtractorTrack::Audio)
+			continue;
+		pAudioBus = static_cast<qtractorAudioBus *> (pTrack->outputBus());
+		if (pAudioBus)
+			pAudioBus->updateTrackLatency(
+				pTrack->pluginList()->updateLatency());
+	}
+
+	// MIDI instrument paths, likewise...
+	qtractorMidiManager *pMidiManager = pSession->midiManagers().first();
+	for ( ; pMidiManager; pMidiManager = pMidiManager->next()) {
+		pAudioBus = pMidiManager->audioOutputBus();
+		if (pAudioBus)
+			pAudioBus->updateTrackLatency(
+				pMidiManager->pluginList()->updateLatency());
+	}
+
+	// Audio aux-send paths: arriving at the aux-send bus
+	// with the plugin-chain latency upstream of the send...
+	for (qtractorTrack *pTrack = pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		if (pTrack->trackType() == qtractorTrack::Audio)
+			updateAuxSendLatency(pTrack->pluginList());
+	}
+
+	pMidiManager = pSession->midiManagers().first();
+	for ( ; pMidiManager; pMidiManager = pMidiManager->next())
+		updateAuxSendLatency(pMidiManager->pluginList());
+
+	// Output buses alignment: the longest path wins...
+	unsigned long iMaxLatency = 0;
+
+	for (pBus = buses().first(); pBus; pBus = pBus->next()) {
+		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus && (pAudioBus->busMode() & qtractorBus::Output)) {
+			const unsigned long iLatency = pAudioBus->updateOutputLatency();
+			if (iMaxLatency < iLatency)
+				iMaxLatency = iLatency;
+		}
+	}
+
+	for (pBus = busesEx().first(); pBus; pBus = pBus->next()) {
+		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus && (pAudioBus->busMode() & qtractorBus::Output)) {
+			const unsigned long iLatency = pAudioBus->updateOutputLatency();
+			if (iMaxLatency < iLatency)
+				iMaxLatency = iLatency;
+		}
+	}
+
+	for (pBus = buses().first(); pBus; pBus = pBus->next()) {
+		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus && (pAudioBus->busMode() & qtractorBus::Output))
+			pAudioBus->setOutputDelay(
+				iMaxLatency - pAudioBus->outputLatency());
+	}
+
+	for (pBus = busesEx().first(); pBus; pBus = pBus->next()) {
+		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus && (pAudioBus->busMode() & qtractorBus::Output))
+			pAudioBus->setOutputDelay(
+				iMaxLatency - pAudioBus->outputLatency());
+	}
+
+	// Ports latency are to be reported (later)...
+	if (m_iMaxLatency != iMaxLatency) {
+		m_iMaxLatency = iMaxLatency;
+		ATOMIC_SET(&m_latencyChanged, 1);
+	}
+}
+
+
+// Latency compensation: aux-send paths of a plugin-chain (RT).
+void qtractorAudioEngine::updateAuxSendLatency ( qtractorPluginList *pList )
+{
+	if (pList == NULL || !pList->isActivated())
+		return;
+
+	for (qtractorPlugin *pPlugin = pList->first();
+			pPlugin; pPlugin = pPlugin->next()) {
+		qtractorPluginType *pType = pPlugin->type();
+		if (pType->typeHint() != qtractorPluginType::AuxSend
+			|| pType->index() == 0 // MIDI aux-send.
+			|| !pPlugin->isActivated())
+			continue;
+		qtractorAudioAuxSendPlugin *pAudioAuxSendPlugin
+			= static_cast<qtractorAudioAuxSendPlugin *> (pPlugin);
+		qtractorAudioBus *pAudioBus = pAudioAuxSendPlugin->audioBus();
+		if (pAudioBus)
+			pAudioBus->updateTrackLatency(pAudioAuxSendPlugin->latencyBefore());
+	}
+}
+
+
+// Have JACK recompute port latencies,
+// if compensation has changed (non-RT).
+void qtractorAudioEngine::updateLatencyRange (void)
+{
+	if (!ATOMIC_TAZ(&m_latencyChanged))
+		return;
+
+#ifdef CONFIG_JACK_LATENCY
+	if (m_pJackClient)
+		jack_recompute_total_latencies(m_pJackClient);
+#endif
+}
+
+
+#ifdef CONFIG_JACK_LATENCY
+
+// JACK latency callback (ports latency range report):
+// the compensation delay adds up to whatever path
+// goes through any of our own (output) buses.
+void qtractorAudioEngine::latencyCallback ( jack_latency_callback_mode_t mode )
+{
+	qtractorBus *pBus;
+	qtractorAudioBus *pAudioBus;
+
+	jack_latency_range_t range;
+	range.min = jack_nframes_t(-1);
+	range.max = 0;
+
+	for (pBus = buses().first(); pBus; pBus = pBus->next()) {
+		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus)
+			pAudioBus->getLatencyRange(mode, range);
+	}
+
+	for (pBus = busesEx().first(); pBus; pBus = pBus->next()) {
+		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus)
+			pAudioBus->getLatencyRange(mode, range);
+	}
+
+	if (range.min > range.max)
+		range.min = range.max = 0;
+
+	range.min += m_iMaxLatency;
+	range.max += m_iMaxLatency;
+
+	for (pBus = buses().first(); pBus; pBus = pBus->next()) {
+		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus)
+			pAudioBus->setLatencyRange(mode, range);
+	}
+
+	for (pBus = busesEx().first(); pBus; pBus = pBus->next()) {
+		pAudioBus = static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus)
+			pAudioBus->setLatencyRange(mode, range);
+	}
+}
+
+#endif	// CONFIG_JACK_LATENCY
+
+
 // Document element methods.
 bool qtractorAudioEngine::loadElement (
 	qtractorDocument *pDocument, QDomElement *pElement )
@@ -1342,7 +1812,8 @@ bool qtractorAudioEngine::isExporting (void) const
 // Audio-export method.
 bool qtractorAudioEngine::fileExport (
 	const QString& sExportPath, const QList<qtractorAudioBus *>& exportBuses,
-	unsigned long iExportStart, unsigned long iExportEnd )
+	unsigned long iExportStart, unsigned long iExportEnd,
+	const QHash<qtractorTrack *, QString>& exportStems )
 {
 	// No simultaneous or foul exports...
 	if (!isActivated() || isPlaying() || isExporting())
@@ -1389,6 +1860,79 @@ bool qtractorAudioEngine::fileExport (
 		return false;
 	}
 
+	// Go open all track stem files too, if any...
+	QStringList stemPaths;
+	QHash<qtractorTrack *, qtractorAudioExportStem *> *pExportStems = NULL;
+	QHash<qtractorMidiManager *, qtractorAudioExportStem *> *pExportStemsEx = NULL;
+	if (!exportStems.isEmpty()) {
+		pExportStems = new QHash<qtractorTrack *, qtractorAudioExportStem *> ();
+		pExportStemsEx = new QHash<qtractorMidiManager *, qtractorAudioExportStem *> ();
+		QHash<qtractorTrack *, QString>::ConstIterator iter
+			= exportStems.constBegin();
+		const QHash<qtractorTrack *, QString>::ConstIterator& iter_end
+			= exportStems.constEnd();
+		for ( ; iter != iter_end; ++iter) {
+			qtractorTrack *pTrack = iter.key();
+			const QString& sStemPath = iter.value();
+			// Audio tracks are tapped on their output bus buffer,
+			// MIDI tracks only through their instrument plugins...
+			qtractorAudioBus *pStemBus = NULL;
+			qtractorMidiManager *pMidiManager = NULL;
+			if (pTrack->trackType() == qtractorTrack::Audio) {
+				pStemBus = static_cast<qtractorAudioBus *> (pTrack->outputBus());
+			} else {
+				pMidiManager = (pTrack->pluginList())->midiManager();
+				if (pMidiManager)
+					pStemBus = pMidiManager->audioOutputBus();
+			}
+			if (pStemBus == NULL)
+				continue;
+			const unsigned short iStemChannels = pStemBus->channels();
+			qtractorAudioFile *pStemFile
+				= qtractorAudioFileFactory::createAudioFile(
+					sStemPath, iStemChannels, sampleRate());
+			if (pStemFile
+				&& !pStemFile->open(sStemPath, qtractorAudioFile::Write)) {
+				delete pStemFile;
+				pStemFile = NULL;
+			}
+			// Bail out if any one of them fails,
+			// leaving no stray files behind...
+			if (pStemFile == NULL) {
+				qDeleteAll(*pExportStems);
+				delete pExportStems;
+				delete pExportStemsEx;
+				delete pExportFile;
+				QStringListIterator path(stemPaths);
+				while (path.hasNext())
+					QFile::remove(path.next());
+				QFile::remove(sExportPath);
+				return false;
+			}
+			stemPaths.append(sStemPath);
+			qtractorAudioExportStem *pStem = new qtractorAudioExportStem(
+				pStemFile, iStemChannels, bufferSize());
+			// Stems are shifted by their own path latency; dedicated
+			// instrument buses are tapped past their own output chain
+			// (plugins and alignment delay) so shifted the whole way...
+			unsigned long iStemLatency = pStemBus->trackLatency();
+			if (pMidiManager && pMidiManager->isAudioOutputBus()) {
+				iStemLatency = pStemBus->outputLatency()
+					+ pStemBus->outputDelay();
+			}
+			pStem->setExportRange(
+				iExportStart + iStemLatency, iExportEnd + iStemLatency);
+			pExportStems->insert(pTrack, pStem);
+			if (pMidiManager)
+				pExportStemsEx->insert(pMidiManager, pStem);
+			pStem->start();
+		}
+	}
+
+	// Dormant plugins must not get instantiated while
+	// freewheeling, by activation automation (real-time)...
+	pSession->wakeAutomatedPlugins();
+
 	// We'll be busy...
 	pSession->lock();
 
@@ -1400,8 +1944,11 @@ bool qtractorAudioEngine::fileExport (
 	m_pExportBuses = new QList<qtractorAudioBus *> (exportBuses);
 	m_pExportFile  = pExportFile;
 	m_pExportBuffer = new qtractorAudioExportBuffer(iChannels, bufferSize());
+	m_pExportStems = pExportStems;
+	m_pExportStemsEx = pExportStemsEx;
 	m_iExportStart = iExportStart;
 	m_iExportEnd   = iExportEnd;
+	m_iExportLatency = m_iMaxLatency;
 	m_bExportDone  = false;
 
 	// Prepare and show some progress...
@@ -1449,6 +1996,16 @@ bool qtractorAudioEngine::fileExport (
 	// May close the file...
 	m_pExportFile->close();
 
+	// Flush and close all track stem files...
+	if (m_pExportStems) {
+		QHash<qtractorTrack *, qtractorAudioExportStem *>::ConstIterator iter
+			= m_pExportStems->constBegin();
+		const QHash<qtractorTrack *, qtractorAudioExportStem *>::ConstIterator&
+			iter_end = m_pExportStems->constEnd();
+		for ( ; iter != iter_end; ++iter)
+			iter.value()->close();
+	}
+
 	// Restore session at ease...
 	pSession->setLoop(iLoopStart, iLoopEnd);
 	pSession->setPlayHead(iPlayHead);
@@ -1467,6 +2024,13 @@ bool qtractorAudioEngine::fileExport (
 	delete m_pExportBuses;
 	delete m_pExportFile;
 
+	if (m_pExportStems) {
+		qDeleteAll(*m_pExportStems);
+		delete m_pExportStems;
+	}
+	if (m_pExportStemsEx)
+		delete m_pExportStemsEx;
+
 	// Made some progress...
 	pProgressBar->hide();
 
@@ -1474,8 +2038,11 @@ bool qtractorAudioEngine::fileExport (
 	m_pExportBuses = NULL;
 	m_pExportFile  = NULL;
 	m_pExportBuffer = NULL;
+	m_pExportStems = NULL;
+	m_pExportStemsEx = NULL;
 	m_iExportStart = 0;
 	m_iExportEnd   = 0;
+	m_iExportLatency = 0;
 	m_bExportDone  = true;
 
 	// Back to business..
@@ -2081,6 +2648,10 @@ qtractorAudioBus::qtractorAudioBus (
 
 	m_bEnabled  = false;
 
+	m_iTrackLatency  = 0;
+	m_iOutputLatency = 0;
+	m_iOutputDelay   = 0;
+
 #if defined(__SSE__)
 	if (sse_enabled())
 		m_pfnBufferAdd = sse_buffer_add;
@@ -2213,6 +2784,10 @@ bool qtractorAudioBus::open (void)
 		m_ppYBuffer[i] = NULL;
 	}
 
+	// Output latency compensation delay-line...
+	if (busMode & qtractorBus::Output)
+		m_outputDelay.setChannels(m_iChannels);
+
 	// Update monitor subject names...
 	qtractorAudioBus::updateBusName();
 
@@ -2301,6 +2876,9 @@ void qtractorAudioBus::close (void)
 		delete [] m_ppYBuffer;
 		m_ppYBuffer = NULL;
 	}
+
+	// Free latency compensation delay-line.
+	m_outputDelay.setChannels(0);
 }
 
 
@@ -2499,11 +3077,26 @@ void qtractorAudioBus::process_commit ( unsigned int nframes )
 
 	if (m_pOPluginList && m_pOPluginList->isActivated())
 		m_pOPluginList->process(m_ppOBuffer, nframes);
+	if (m_outputDelay.channels() == m_iChannels)
+		m_outputDelay.process(m_ppOBuffer, nframes, m_iOutputDelay);
 	if (m_pOAudioMonitor)
 		m_pOAudioMonitor->process(m_ppOBuffer, nframes);
 }
 
 
+// Output path latency: maximum track latency plus
+// the output plugin-chain latency (RT).
+unsigned long qtractorAudioBus::updateOutputLatency (void)
+{
+	m_iOutputLatency = m_iTrackLatency;
+
+	if (m_pOPluginList)
+		m_iOutputLatency += m_pOPluginList->updateLatency();
+
+	return m_iOutputLatency;
+}
+
+
 // Bus-buffering methods.
 void qtractorAudioBus::buffer_prepare (
 	unsigned int nframes, qtractorAudioBus *pInputBus )
@@ -2728,6 +3321,47 @@ unsigned int qtractorAudioBus::latency_out (void) const
 }
 
 
+#ifdef CONFIG_JACK_LATENCY
+
+// JACK latency range helpers (latency callback).
+void qtractorAudioBus::getLatencyRange (
+	jack_latency_callback_mode_t mode, jack_latency_range_t& range ) const
+{
+	jack_port_t **ppPorts
+		= (mode == JackCaptureLatency ? m_ppIPorts : m_ppOPorts);
+	if (ppPorts == NULL)
+		return;
+
+	jack_latency_range_t port_range;
+	for (unsigned int i = 0; i < m_iChannels; ++i) {
+		if (ppPorts[i] == NULL)
+			continue;
+		jack_port_get_latency_range(ppPorts[i], mode, &port_range);
+		if (range.min > port_range.min)
+			range.min = port_range.min;
+		if (range.max < port_range.max)
+			range.max = port_range.max;
+	}
+}
+
+void qtractorAudioBus::setLatencyRange (
+	jack_latency_callback_mode_t mode, const jack_latency_range_t& range ) const
+{
+	jack_port_t **ppPorts
+		= (mode == JackCaptureLatency ? m_ppOPorts : m_ppIPorts);
+	if (ppPorts == NULL)
+		return;
+
+	jack_latency_range_t port_range = range;
+	for (unsigned int i = 0; i < m_iChannels; ++i) {
+		if (ppPorts[i])
+			jack_port_set_latency_range(ppPorts[i], mode, &port_range);
+	}
+}
+
+#endif	// CONFIG_JACK_LATENCY
+
+
 // Create plugin-list properly.
 qtractorPluginList *qtractorAudioBus::createPluginList ( int iFlags ) const
 {
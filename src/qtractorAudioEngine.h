@@ -25,9 +25,12 @@
 #include "qtractorAtomic.h"
 #include "qtractorEngine.h"
 
+#include "qtractorAudioDelay.h"
+
 #include <jack/jack.h>
 
 #include <QObject>
+#include <QHash>
 
 
 // Forward declarations.
@@ -36,6 +39,8 @@ class qtractorAudioBuffer;
 class qtractorAudioMonitor;
 class qtractorAudioFile;
 class qtractorAudioExportBuffer;
+class qtractorAudioExportStem;
+class qtractorMidiManager;
 class qtractorPluginList;
 class qtractorCurveList;
 
@@ -142,10 +147,13 @@ public:
 	void setExporting(bool bExporting);
 	bool isExporting() const;
 
-	// Audio-export method.
+	// Audio-export method (optionally, along with
+	// one separate stem file per track, in one pass).
 	bool fileExport(const QString& sExportPath,
 		const QList<qtractorAudioBus *>& exportBuses,
-		unsigned long iExportStart = 0, unsigned long iExportEnd = 0);
+		unsigned long iExportStart = 0, unsigned long iExportEnd = 0,
+		const QHash<qtractorTrack *, QString>& exportStems
+			= QHash<qtractorTrack *, QString> ());
 
 	// Special track-immediate methods.
 	void trackMute(qtractorTrack *pTrack, bool bMute);
@@ -217,6 +225,19 @@ public:
     // Reset all audio monitoring...
     void resetAllMonitors();
 
+	// Latency compensation: maximum (output) path latency.
+	unsigned long maxLatency() const
+		{ return m_iMaxLatency; }
+
+	// Have JACK recompute port latencies,
+	// if compensation has changed (non-RT).
+	void updateLatencyRange();
+
+#ifdef CONFIG_JACK_LATENCY
+	// JACK latency callback (ports latency range report).
+	void latencyCallback(jack_latency_callback_mode_t mode);
+#endif
+
 protected:
 
 	// Concrete device (de)activation methods.
@@ -241,6 +262,10 @@ protected:
 	// Freewheeling process cycle executive (needed for export).
 	void process_export(unsigned int nframes);
 
+	// Latency compensation (path delays) update (RT).
+	void updateLatency();
+	void updateAuxSendLatency(qtractorPluginList *pList);
+
 private:
 
 	// Special event notifier proxy object.
@@ -266,6 +291,14 @@ private:
 	// Audio-export freewheeling (internal) state.
 	bool m_bFreewheel;
 
+	// Saved flush-to-zero/denormals-are-zero state (process thread).
+	int m_iDenormalsState;
+
+	// Latency compensation: maximum (output) path latency
+	// and whether it has changed since last reported (RT).
+	unsigned long  m_iMaxLatency;
+	qtractorAtomic m_latencyChanged;
+
 	// Common audio buffer sync thread.
 	qtractorAudioBufferThread *m_pSyncThread;
 
@@ -274,11 +307,16 @@ private:
 	qtractorAudioFile   *m_pExportFile;
 	unsigned long        m_iExportStart;
 	unsigned long        m_iExportEnd;
+	unsigned long        m_iExportLatency;
 	volatile bool        m_bExportDone;
 
 	QList<qtractorAudioBus *> *m_pExportBuses;
 	qtractorAudioExportBuffer *m_pExportBuffer;
 
+	// Audio-export track stems (audio tracks and MIDI instruments).
+	QHash<qtractorTrack *, qtractorAudioExportStem *> *m_pExportStems;
+	QHash<qtractorMidiManager *, qtractorAudioExportStem *> *m_pExportStemsEx;
+
 	// Audio metronome stuff.
 	bool                 m_bMetronome;
 	bool                 m_bMetroBus;
@@ -382,6 +420,32 @@ public:
 	unsigned int latency_in()  const;
 	unsigned int latency_out() const;
 
+	// Latency compensation methods (RT).
+	void resetLatency()
+		{ m_iTrackLatency = 0; }
+	void updateTrackLatency(unsigned long iLatency)
+		{ if (m_iTrackLatency < iLatency) m_iTrackLatency = iLatency; }
+	unsigned long trackLatency() const
+		{ return m_iTrackLatency; }
+
+	unsigned long updateOutputLatency();
+	unsigned long outputLatency() const
+		{ return m_iOutputLatency; }
+	void setOutputDelay(unsigned long iOutputDelay)
+		{ m_iOutputDelay = iOutputDelay; }
+	unsigned long outputDelay() const
+		{ return m_iOutputDelay; }
+
+#ifdef CONFIG_JACK_LATENCY
+	// JACK latency range helpers (latency callback):
+	// get merges from this bus ports upstream, set applies
+	// to the ones downstream (capture: in -> out; playback: out -> in).
+	void getLatencyRange(jack_latency_callback_mode_t mode,
+		jack_latency_range_t& range) const;
+	void setLatencyRange(jack_latency_callback_mode_t mode,
+		const jack_latency_range_t& range) const;
+#endif
+
 	// Retrieve/restore client:port connections;
 	// return the effective number of connection attempts...
 	int updateConnects(BusMode busMode,
@@ -438,6 +502,14 @@ private:
 	// (r/w access should be atomic)
 	bool m_bEnabled;
 
+	// Latency compensation state: maximum track (path)
+	// latency and output alignment delay-line.
+	unsigned long m_iTrackLatency;
+	unsigned long m_iOutputLatency;
+	unsigned long m_iOutputDelay;
+
+	qtractorAudioDelay m_outputDelay;
+
 	// Buffer mix-down processor.
 	void (*m_pfnBufferAdd)(float **, float **, unsigned int,
 		unsigned short, unsigned short, unsigned int);
@@ -442,13 +442,9 @@ bool qtractorAudioPeakFile::openRead (void)
 	if (m_bWaitSync)
 		return false;
 
-	// Need some preliminary file information...
-	QFileInfo fileInfo(m_sFilename);
-	QFileInfo peakInfo(m_peakFile.fileName());
 	// Have we a peak file up-to-date,
 	// or must the peak file be (re)created?
-	if (!peakInfo.exists() || peakInfo.created() < fileInfo.created()) {
-	//	|| peakInfo.lastModified() < fileInfo.lastModified()) {
+	if (isOutOfDate()) {
 		qtractorSession *pSession = qtractorSession::getInstance();
 		if (pSession) {
 			qtractorAudioPeakFactory *pPeakFactory
@@ -492,6 +488,35 @@ bool qtractorAudioPeakFile::openRead (void)
 }
 
 
+// Whether the peak file is missing or out-of-date.
+bool qtractorAudioPeakFile::isOutOfDate (void) const
+{
+	// Need some preliminary file information...
+	QFileInfo fileInfo(m_sFilename);
+	QFileInfo peakInfo(m_peakFile.fileName());
+
+	return (!peakInfo.exists() || peakInfo.created() < fileInfo.created());
+	//	|| peakInfo.lastModified() < fileInfo.lastModified());
+}
+
+
+// Have the peak file (re)created ahead, on the peak thread,
+// if missing or out-of-date (eg. while loading a session).
+void qtractorAudioPeakFile::schedule (void)
+{
+	if (m_openMode != None || m_bWaitSync || !isOutOfDate())
+		return;
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession) {
+		qtractorAudioPeakFactory *pPeakFactory
+			= pSession->audioPeakFactory();
+		if (pPeakFactory)
+			pPeakFactory->sync(this);
+	}
+}
+
+
 // Free all attended resources for this peak file.
 void qtractorAudioPeakFile::closeRead (void)
 {
@@ -80,6 +80,9 @@ public:
 	Frame *read(unsigned long iPeakOffset, unsigned int iPeakFrames);
 	void closeRead();
 
+	// Have the peak file (re)created ahead, if missing or out-of-date.
+	void schedule();
+
 	// Write peak from audio frame methods.
 	bool openWrite(unsigned short iChannels, unsigned int iSampleRate);
 	void write(float **ppAudioFrames, unsigned int iAudioFrames);
@@ -101,6 +104,9 @@ protected:
 	// Internal creational methods.
 	void writeFrame();
 
+	// Whether the peak file is missing or out-of-date.
+	bool isOutOfDate() const;
+
 	// Read frames from peak file into local buffer cache.
 	unsigned int readBuffer(unsigned int iBuffOffset,
 		unsigned long iPeakOffset, unsigned int iPeakFrames);
@@ -178,6 +184,9 @@ public:
 		{ return m_pPeakFile->read(iPeakOffset, iPeakFrames); }
 	void closeRead() { m_pPeakFile->closeRead(); }
 
+	// Have the peak file (re)created ahead.
+	void schedule() { m_pPeakFile->schedule(); }
+
 	// Write peak from audio frame methods.
 	bool openWrite(unsigned short iChannels, unsigned int iSampleRate)
 		{ return m_pPeakFile->openWrite(iChannels, iSampleRate); }
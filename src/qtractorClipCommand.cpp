@@ -820,6 +820,36 @@ bool qtractorClipCommand::undo (void)
 }
 
 
+// Approximate memory footprint: removed clips are held in full.
+unsigned long qtractorClipCommand::size (void) const
+{
+	unsigned long iSize = qtractorCommand::size();
+
+	QListIterator<Item *> iter(m_items);
+	while (iter.hasNext()) {
+		Item *pItem = iter.next();
+		iSize += sizeof(Item)
+			+ (pItem->filename.size() + pItem->clipName.size()) * sizeof(QChar);
+		if (pItem->command == RemoveClip && pItem->clip && pItem->track) {
+			if (pItem->track->trackType() == qtractorTrack::Midi) {
+				qtractorMidiClip *pMidiClip
+					= static_cast<qtractorMidiClip *> (pItem->clip);
+				qtractorMidiSequence *pSeq = pMidiClip->sequence();
+				iSize += sizeof(qtractorMidiClip);
+				if (pSeq)
+					iSize += pSeq->events().count() * sizeof(qtractorMidiEvent);
+			} else {
+				iSize += sizeof(qtractorAudioClip);
+			}
+		}
+		if (pItem->editCommand)
+			iSize += pItem->editCommand->size();
+	}
+
+	return iSize;
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorClipTakeCommand - declaration.
 //
@@ -1114,6 +1144,22 @@ bool qtractorClipToolCommand::undo (void)
 }
 
 
+// Approximate memory footprint.
+unsigned long qtractorClipToolCommand::size (void) const
+{
+	unsigned long iSize = qtractorCommand::size();
+
+	QListIterator<qtractorMidiEditCommand *> iter(m_midiEditCommands);
+	while (iter.hasNext()) {
+		qtractorMidiEditCommand *pMidiEditCommand = iter.next();
+		if (pMidiEditCommand)
+			iSize += pMidiEditCommand->size();
+	}
+
+	return iSize;
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorClipRecordExCommand - implementation.
 //
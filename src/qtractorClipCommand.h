@@ -97,6 +97,9 @@ public:
 	bool redo();
 	bool undo();
 
+	// Approximate memory footprint.
+	unsigned long size() const;
+
 protected:
 
 	// Common executive method.
@@ -254,6 +257,9 @@ public:
 	bool redo();
 	bool undo();
 
+	// Approximate memory footprint.
+	unsigned long size() const;
+
 private:
 
 	// Instance variables.
@@ -19,6 +19,7 @@
 
 *****************************************************************************/
 
+#include "qtractorAbout.h"
 #include "qtractorCommand.h"
 
 #include <QAction>
@@ -34,6 +35,9 @@ qtractorCommandList::qtractorCommandList (void)
 {
 	m_pLastCommand = NULL;
 
+	m_iSize = 0;
+	m_iMaxSize = 0;
+
 	m_commands.setAutoDelete(true);
 }
 
@@ -50,6 +54,9 @@ void qtractorCommandList::clear (void)
 	m_commands.clear();
 
 	m_pLastCommand = NULL;
+
+	m_sizes.clear();
+	m_iSize = 0;
 }
 
 
@@ -74,7 +81,7 @@ void qtractorCommandList::removeLastCommand (void)
 {
 	if (m_pLastCommand) {
 		qtractorCommand *pPrevCommand = m_pLastCommand->prev();
-		m_commands.remove(m_pLastCommand);
+		removeCommand(m_pLastCommand);
 		m_pLastCommand = pPrevCommand;
 	}
 }
@@ -105,7 +112,7 @@ bool qtractorCommandList::push ( qtractorCommand *pCommand )
 	qtractorCommand *pNextCommand = nextCommand();
 	while (pNextCommand) {
 		qtractorCommand *pLateCommand = pNextCommand->next();
-		m_commands.remove(pNextCommand);
+		removeCommand(pNextCommand);
 		pNextCommand = pLateCommand;
 	}
 
@@ -116,6 +123,14 @@ bool qtractorCommandList::push ( qtractorCommand *pCommand )
 	m_commands.append(pCommand);
 	m_pLastCommand = m_commands.last();
 
+	// Account for it...
+	const unsigned long iSize = pCommand->size();
+	m_sizes.insert(pCommand, iSize);
+	m_iSize += iSize;
+
+	// Stay within budget, if any...
+	evictCommands();
+
 	return (m_pLastCommand != NULL);
 }
 
@@ -168,6 +183,63 @@ bool qtractorCommandList::redo (void)
 }
 
 
+// Remove and account for a command, whatever its place.
+void qtractorCommandList::removeCommand ( qtractorCommand *pCommand )
+{
+	m_iSize -= m_sizes.take(pCommand);
+
+	m_commands.remove(pCommand);
+}
+
+
+// Evict oldest commands while over the memory budget;
+// the current (last) command is always kept though.
+void qtractorCommandList::evictCommands (void)
+{
+	if (m_iMaxSize < 1)
+		return;
+
+	int iEvicted = 0;
+
+	while (m_iSize > m_iMaxSize) {
+		qtractorCommand *pCommand = m_commands.first();
+		if (pCommand == NULL || m_pLastCommand == NULL
+			|| pCommand == m_pLastCommand)
+			break;
+		removeCommand(pCommand);
+		++iEvicted;
+	}
+
+#ifdef CONFIG_DEBUG
+	if (iEvicted > 0) {
+		qDebug("qtractorCommandList[%p]::evictCommands() evicted=%d size=%lu",
+			this, iEvicted, m_iSize);
+	}
+#endif
+}
+
+
+// Memory budget (in bytes, 0=unlimited) accessors.
+void qtractorCommandList::setMaxSize ( unsigned long iMaxSize )
+{
+	m_iMaxSize = iMaxSize;
+
+	evictCommands();
+}
+
+unsigned long qtractorCommandList::maxSize (void) const
+{
+	return m_iMaxSize;
+}
+
+
+// Current history memory footprint (in bytes).
+unsigned long qtractorCommandList::size (void) const
+{
+	return m_iSize;
+}
+
+
 // Command action update helper.
 void qtractorCommandList::updateAction (
 	QAction *pAction, qtractorCommand *pCommand ) const
@@ -26,6 +26,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QHash>
 
 // Forward declarations.
 class QAction;
@@ -78,6 +79,11 @@ public:
 	virtual bool redo() = 0;
 	virtual bool undo() = 0;
 
+	// Approximate memory footprint (in bytes),
+	// for the undo/redo history accounting.
+	virtual unsigned long size() const
+		{ return sizeof(qtractorCommand) + m_sName.size() * sizeof(QChar); }
+
 protected:
 
 	// Discrete flag accessors.
@@ -139,17 +145,38 @@ public:
 	// Command action update helper.
 	void updateAction(QAction *pAction, qtractorCommand *pCommand) const;
 
+	// Memory budget (in bytes, 0=unlimited) accessors.
+	void setMaxSize(unsigned long iMaxSize);
+	unsigned long maxSize() const;
+
+	// Current history memory footprint (in bytes).
+	unsigned long size() const;
+
 signals:
 
 	// Command update notification.
 	void updateNotifySignal(unsigned int);
 
+protected:
+
+	// Remove and account for a command, whatever its place.
+	void removeCommand(qtractorCommand *pCommand);
+
+	// Evict oldest commands while over the memory budget.
+	void evictCommands();
+
 private:
 
 	// Instance variables.
 	qtractorList<qtractorCommand> m_commands;
 
 	qtractorCommand *m_pLastCommand;
+
+	// Memory accounting, per command (at push time).
+	QHash<qtractorCommand *, unsigned long> m_sizes;
+
+	unsigned long m_iSize;
+	unsigned long m_iMaxSize;
 };
 
 
@@ -24,6 +24,8 @@
 
 #include "qtractorTimeScale.h"
 
+#include <QVector>
+
 #include <math.h>
 
 
@@ -88,9 +90,10 @@ inline void updateNodeLinear ( qtractorCurve::Node *pNode, float y0,
 }
 
 
-// Spline.
-inline void updateNodeSpline ( qtractorCurve::Node *pNode, float y0,
-	const qtractorCurve::Node *pPrev, const qtractorCurve::Node *pNext )
+// Spline (given the node before previous, explicitly).
+inline void updateNodeSplineEx ( qtractorCurve::Node *pNode, float y0,
+	const qtractorCurve::Node *pPrev, const qtractorCurve::Node *pPrev0,
+	const qtractorCurve::Node *pNext )
 {
 	// Shamelessly using the same reference source article as Ardour ;)
 	// CJC Kuger, "Constrained Cubic Spline Interpolation", August 2002
@@ -117,14 +120,11 @@ inline void updateNodeSpline ( qtractorCurve::Node *pNode, float y0,
 	if (::fabsf(y1 - y2) > fZero)
 		s1 =  x1 / (y1 - y2);
 
-	if (pPrev) {
-		pPrev = pPrev->prev();
-		if (pPrev && (::fabsf(y1 - pPrev->value) > fZero)) {
-			const float s0
-				= (x1 - float(pPrev->frame) - x0) / (y1 - pPrev->value);
-			if (s1 * s0 > 0.0f && ::fabsf(s1 + s0) > fZero)
-				f1 = 2.0f / (s1 + s0);
-		}
+	if (pPrev && pPrev0 && (::fabsf(y1 - pPrev0->value) > fZero)) {
+		const float s0
+			= (x1 - float(pPrev0->frame) - x0) / (y1 - pPrev0->value);
+		if (s1 * s0 > 0.0f && ::fabsf(s1 + s0) > fZero)
+			f1 = 2.0f / (s1 + s0);
 	}
 
 	if (pNext && (::fabsf(pNext->value - y2) > fZero))
@@ -148,6 +148,14 @@ inline void updateNodeSpline ( qtractorCurve::Node *pNode, float y0,
 	pNode->d = y1 - (pNode->c * x1) - (pNode->b * x12) - (pNode->a * x12 * x1);
 }
 
+// Spline.
+inline void updateNodeSpline ( qtractorCurve::Node *pNode, float y0,
+	const qtractorCurve::Node *pPrev, const qtractorCurve::Node *pNext )
+{
+	updateNodeSplineEx(pNode, y0,
+		pPrev, (pPrev ? pPrev->prev() : NULL), pNext);
+}
+
 
 //----------------------------------------------------------------------
 // qtractorCurve::value -- Interpolation computation helpers.
@@ -182,6 +190,7 @@ inline float valueSpline ( const qtractorCurve::Node *pNode, float x )
 qtractorCurve::qtractorCurve ( qtractorCurveList *pList,
 	qtractorSubject *pSubject, Mode mode, unsigned int iMinFrameDist )
 	: m_pList(pList), m_mode(mode), m_iMinFrameDist(iMinFrameDist),
+		m_fTolerance(0.0f), m_pThinAnchor(NULL), m_pThinNode(NULL),
 		m_observer(pSubject, this), m_state(Idle), m_cursor(this),
 		m_bLogarithmic(false), m_color(Qt::darkRed), m_pEditList(NULL)
 {
@@ -230,6 +239,10 @@ void qtractorCurve::clear (void)
 	m_nodes.clear();
 	m_cursor.reset(NULL);
 
+	m_pThinAnchor = NULL;
+	m_pThinNode = NULL;
+	m_thinned.clear();
+
 	updateNodeEx(NULL);
 }
 
@@ -399,6 +412,201 @@ bool qtractorCurve::isMinFrameDist ( Node *pNode, unsigned long iFrame ) const
 }
 
 
+// Capture decimation: drop the previously captured node, if it
+// (and all the ones dropped before) stays within tolerance of
+// the segment from the last kept node to the newly captured one.
+void qtractorCurve::thinNode ( Node *pNode )
+{
+	if (pNode == NULL || pNode == m_pThinNode)
+		return;
+
+	Node *pPrev = pNode->prev();
+	Node *pAnchor = (pPrev ? pPrev->prev() : NULL);
+
+	if (pAnchor != m_pThinAnchor)
+		m_thinned.clear();
+
+	if (m_fTolerance > 0.0f && pAnchor && pPrev == m_pThinNode
+		&& isThinNode(pAnchor, pPrev, pNode)
+		&& m_pEditList->dropNode(pPrev)) {
+		m_thinned.append(ThinPoint(pPrev->frame,
+			m_observer.scaleFromValue(pPrev->value)));
+		unlinkNode(pPrev);
+		delete pPrev;
+		m_pThinAnchor = pAnchor;
+	} else {
+		m_thinned.clear();
+		m_pThinAnchor = pPrev;
+	}
+
+	m_pThinNode = pNode;
+}
+
+
+bool qtractorCurve::isThinNode (
+	Node *pAnchor, Node *pNode, Node *pNext ) const
+{
+	QList<ThinPoint> points(m_thinned);
+	points.append(ThinPoint(pNode->frame,
+		m_observer.scaleFromValue(pNode->value)));
+
+	QListIterator<ThinPoint> iter(points);
+	while (iter.hasNext()) {
+		const ThinPoint& point = iter.next();
+		const float y1 = thinScale(pAnchor->prev(),
+			pAnchor, pNext, pNext->next(), point.frame);
+		if (::fabsf(point.scale - y1) > m_fTolerance)
+			return false;
+	}
+
+	return true;
+}
+
+
+// Node thinning error helper: the normalized value at the given
+// frame, as interpolated in the current mode, as if the segment
+// from pPrev to pNode were adjacent (with pPrev0 and pNext around).
+float qtractorCurve::thinScale ( const Node *pPrev0, const Node *pPrev,
+	const Node *pNode, const Node *pNext, unsigned long iFrame ) const
+{
+	if (pNext == NULL)
+		pNext = &m_tail;
+
+	Node node(pNode->frame, pNode->value);
+
+	const float x = float(pNode->frame) - float(iFrame);
+
+	float y = pNode->value;
+	if (x > 0.0f) {
+		switch (m_mode) {
+		case Hold:
+			updateNodeHold(&node, m_tail.value, pPrev, pNext);
+			y = valueHold(&node, x);
+			break;
+		case Linear:
+			updateNodeLinear(&node, m_tail.value, pPrev, pNext);
+			y = valueLinear(&node, x);
+			break;
+		case Spline:
+			updateNodeSplineEx(&node, m_tail.value, pPrev, pPrev0, pNext);
+			y = valueSpline(&node, x);
+			break;
+		}
+	}
+
+	return m_observer.scaleFromValue(y);
+}
+
+
+// Node thinning helper: nearest kept node index, either way.
+static int thinKeptIndex ( const QVector<bool>& keep, int i, int di )
+{
+	for (i += di; i >= 0 && i < keep.count(); i += di) {
+		if (keep.at(i))
+			return i;
+	}
+
+	return -1;
+}
+
+
+// Node thinning (Ramer-Douglas-Peucker) candidates,
+// the nodes that may go within the given tolerance.
+void qtractorCurve::simplifyNodes (
+	float fTolerance, QList<Node *>& nodes ) const
+{
+	if (fTolerance <= 0.0f)
+		return;
+
+	QVector<Node *> points;
+	QVector<float> scales;
+	Node *pNode = m_nodes.first();
+	while (pNode) {
+		points.append(pNode);
+		scales.append(m_observer.scaleFromValue(pNode->value));
+		pNode = pNode->next();
+	}
+
+	const int iCount = points.count();
+	if (iCount < 3)
+		return;
+
+	// First and last nodes are always kept...
+	QVector<bool> keep(iCount, false);
+	keep[0] = true;
+	keep[iCount - 1] = true;
+
+	// Segments: split on the farthest node, recursively,
+	// measured against the curve own interpolation mode...
+	QVector<int> ranges;
+	ranges.append(0);
+	ranges.append(iCount - 1);
+	while (!ranges.isEmpty()) {
+		const int i1 = ranges.last(); ranges.pop_back();
+		const int i0 = ranges.last(); ranges.pop_back();
+		const int j0 = thinKeptIndex(keep, i0, -1);
+		const int j1 = thinKeptIndex(keep, i1, +1);
+		const Node *pPrev0 = (j0 < 0 ? NULL : points.at(j0));
+		const Node *pNext  = (j1 < 0 ? NULL : points.at(j1));
+		float fMaxError = 0.0f;
+		int k = -1;
+		for (int i = i0 + 1; i < i1; ++i) {
+			const float fError = ::fabsf(scales.at(i)
+				- thinScale(pPrev0, points.at(i0), points.at(i1), pNext,
+					points.at(i)->frame));
+			if (fMaxError < fError) {
+				fMaxError = fError;
+				k = i;
+			}
+		}
+		if (k > 0 && fMaxError > fTolerance) {
+			keep[k] = true;
+			ranges.append(i0);
+			ranges.append(k);
+			ranges.append(k);
+			ranges.append(i1);
+		}
+	}
+
+	// Splines depend on the neighbour nodes as well, so check
+	// again against the final ones, until no error stands out...
+	bool bDirty = (mode() == Spline);
+	while (bDirty) {
+		bDirty = false;
+		int i0 = 0;
+		for (int i1 = 1; i1 < iCount; ++i1) {
+			if (!keep.at(i1))
+				continue;
+			const int j0 = thinKeptIndex(keep, i0, -1);
+			const int j1 = thinKeptIndex(keep, i1, +1);
+			const Node *pPrev0 = (j0 < 0 ? NULL : points.at(j0));
+			const Node *pNext  = (j1 < 0 ? NULL : points.at(j1));
+			float fMaxError = 0.0f;
+			int k = -1;
+			for (int i = i0 + 1; i < i1; ++i) {
+				const float fError = ::fabsf(scales.at(i)
+					- thinScale(pPrev0, points.at(i0), points.at(i1), pNext,
+						points.at(i)->frame));
+				if (fMaxError < fError) {
+					fMaxError = fError;
+					k = i;
+				}
+			}
+			if (k > 0 && fMaxError > fTolerance) {
+				keep[k] = true;
+				bDirty = true;
+			}
+			i0 = i1;
+		}
+	}
+
+	for (int i = 0; i < iCount; ++i) {
+		if (!keep.at(i))
+			nodes.append(points.at(i));
+	}
+}
+
+
 // Node interpolation coefficients updater.
 void qtractorCurve::updateNode ( qtractorCurve::Node *pNode )
 {
@@ -724,6 +932,65 @@ void qtractorCurve::writeMidiSequence ( qtractorMidiSequence *pSeq,
 }
 
 
+// Convert binary file node records to curve nodes.
+void qtractorCurve::readFileNodes ( const FileNode *pFileNodes,
+	unsigned int iNodes, unsigned long iFrame, Mode mode )
+{
+	// Cleanup all existing nodes...
+	clear();
+
+	for (unsigned int i = 0; i < iNodes; ++i) {
+		const FileNode& fnode = pFileNodes[i];
+		iFrame += fnode.delta;
+		Node *pNode = new Node(iFrame, fnode.value);
+		pNode->a = fnode.a;
+		pNode->b = fnode.b;
+		pNode->c = fnode.c;
+		pNode->d = fnode.d;
+		m_nodes.append(pNode);
+	}
+
+	// Saved in another mode? Refresh all then...
+	if (mode != m_mode) {
+		update();
+		return;
+	}
+
+	// Otherwise only the tail end is due (default value might differ)...
+	updateNodeEx(m_nodes.last());
+	updateNodeEx(NULL);
+
+	if (m_pList)
+		m_pList->notify();
+}
+
+
+// Convert curve nodes to binary file node records.
+bool qtractorCurve::writeFileNodes (
+	FileNode *pFileNodes, unsigned long& iFrame ) const
+{
+	Node *pNode = m_nodes.first();
+	iFrame = (pNode ? pNode->frame : 0);
+
+	unsigned long iLastFrame = iFrame;
+	for ( ; pNode; pNode = pNode->next()) {
+		const unsigned long iDelta = pNode->frame - iLastFrame;
+		if (iDelta > 0xffffffffUL)
+			return false;
+		FileNode& fnode = *pFileNodes++;
+		fnode.delta = iDelta;
+		fnode.value = pNode->value;
+		fnode.a = pNode->a;
+		fnode.b = pNode->b;
+		fnode.c = pNode->c;
+		fnode.d = pNode->d;
+		iLastFrame = pNode->frame;
+	}
+
+	return true;
+}
+
+
 void qtractorCurve::setCapture ( bool bCapture )
 {
 	if (m_pList == NULL)
@@ -735,6 +1002,11 @@ void qtractorCurve::setCapture ( bool bCapture )
 
 	const bool bOldCapture = (m_state & Capture);
 	m_state = State(bCapture ? (m_state | Capture) : (m_state & ~Capture));
+
+	m_pThinAnchor = NULL;
+	m_pThinNode = NULL;
+	m_thinned.clear();
+
 	if ((bCapture && !bOldCapture) || (!bCapture && bOldCapture))
 		m_pList->updateCapture(bCapture);
 }
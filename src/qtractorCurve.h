@@ -78,6 +78,12 @@ public:
 	unsigned int minFrameDist() const
 		{ return m_iMinFrameDist; }
 
+	// Node thinning tolerance accessors (normalized).
+	void setTolerance(float fTolerance)
+		{ m_fTolerance = fTolerance; }
+	float tolerance() const
+		{ return m_fTolerance; }
+
 	// The curve node declaration.
 	struct Node : public qtractorList<Node>::Link
 	{
@@ -215,7 +221,7 @@ public:
 	void capture(unsigned long iFrame)
 	{
 		if (isCapture())
-			addNode(iFrame, m_observer.value(), m_pEditList);
+			thinNode(addNode(iFrame, m_observer.value(), m_pEditList));
 	}
 
 	void capture() { capture(m_cursor.frame()); }
@@ -226,6 +232,10 @@ public:
 	// Copy all events from another curve (raw-copy).
 	void copyNodes(qtractorCurve *pCurve);
 
+	// Node thinning (Ramer-Douglas-Peucker) candidates,
+	// the nodes that may go within the given tolerance.
+	void simplifyNodes(float fTolerance, QList<Node *>& nodes) const;
+
 	// Convert MIDI sequence events to curve nodes.
 	void readMidiSequence(qtractorMidiSequence *pSeq,
 		qtractorMidiEvent::EventType ctype, unsigned short iChannel,
@@ -236,6 +246,23 @@ public:
 		qtractorMidiEvent::EventType ctype, unsigned short iChannel,
 		unsigned short iParam, qtractorTimeScale *pTimeScale) const;
 
+	// Binary curve file node record (delta-encoded frames).
+	struct FileNode
+	{
+		unsigned int delta;
+		float value;
+		float a, b, c, d;
+	};
+
+	// Convert binary file node records to curve nodes,
+	// coefficients included (no need to refresh, if same mode).
+	void readFileNodes(const FileNode *pFileNodes,
+		unsigned int iNodes, unsigned long iFrame, Mode mode);
+
+	// Convert curve nodes to binary file node records
+	// (false if any frame delta doesn't fit).
+	bool writeFileNodes(FileNode *pFileNodes, unsigned long& iFrame) const;
+
 	// Logarithmic scale mode accessors.
 	void setLogarithmic(bool bLogarithmic)
 		{ m_bLogarithmic = bLogarithmic; }
@@ -261,6 +288,14 @@ protected:
 	void updateNode(Node *pNode);
 	void updateNodeEx(Node *pNode);
 
+	// Capture decimation (error-bounded thinning).
+	void thinNode(Node *pNode);
+	bool isThinNode(Node *pAnchor, Node *pNode, Node *pNext) const;
+
+	// Node thinning error helper (normalized, current mode).
+	float thinScale(const Node *pPrev0, const Node *pPrev,
+		const Node *pNode, const Node *pNext, unsigned long iFrame) const;
+
 	// Observer for capture.
 	class Observer : public qtractorObserver
 	{
@@ -290,6 +325,24 @@ private:
 	// Minimum distance between adjacent nodes.
 	unsigned int m_iMinFrameDist;
 
+	// Node thinning tolerance (normalized).
+	float m_fTolerance;
+
+	// Capture decimation state.
+	struct ThinPoint
+	{
+		ThinPoint(unsigned long iFrame = 0, float fScale = 0.0f)
+			: frame(iFrame), scale(fScale) {}
+
+		unsigned long frame;
+		float scale;
+	};
+
+	Node *m_pThinAnchor;
+	Node *m_pThinNode;
+
+	QList<ThinPoint> m_thinned;
+
 	// Capture observer.
 	Observer m_observer;
 
@@ -363,6 +416,10 @@ public:
 	bool isEmpty() const
 		{ return m_items.isEmpty(); }
 
+	// Approximate memory footprint.
+	unsigned long size() const
+		{ return m_items.count() * (sizeof(Item) + sizeof(qtractorCurve::Node)); }
+
 	// List methods.
 	void addNode(qtractorCurve::Node *pNode)
 		{ m_items.append(new Item(AddNode, pNode, pNode->frame)); }
@@ -393,6 +450,31 @@ public:
 		m_items.clear();
 	}
 
+	// Capture decimation helper: forget about a node
+	// added just before the most recent one (if so).
+	bool dropNode(qtractorCurve::Node *pNode)
+	{
+		const int iLast = m_items.count() - 1;
+		for (int i = iLast; i >= 0; --i) {
+			Item *pItem = m_items.at(i);
+			if (pItem->node == pNode) {
+				if (pItem->command != AddNode)
+					continue;
+				for (int j = iLast; j >= i; --j) {
+					pItem = m_items.at(j);
+					if (pItem->node == pNode) {
+						m_items.removeAt(j);
+						delete pItem;
+					}
+				}
+				return true;
+			}
+			if (i < iLast || pItem->command != AddNode)
+				break;
+		}
+		return false;
+	}
+
 	// Curve edit list command executive.
 	bool execute(bool bRedo = true);
 
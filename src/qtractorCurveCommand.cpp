@@ -378,6 +378,13 @@ bool qtractorCurveEditCommand::isEmpty (void) const
 }
 
 
+// Approximate memory footprint.
+unsigned long qtractorCurveEditCommand::size (void) const
+{
+	return qtractorCommand::size() + m_edits.size();
+}
+
+
 // Common executive method.
 bool qtractorCurveEditCommand::execute ( bool bRedo )
 {
@@ -404,6 +411,37 @@ qtractorCurveClearCommand::qtractorCurveClearCommand ( qtractorCurve *pCurve )
 }
 
 
+//----------------------------------------------------------------------
+// class qtractorCurveSimplifyCommand - declaration.
+//
+
+// Constructor.
+qtractorCurveSimplifyCommand::qtractorCurveSimplifyCommand (
+	qtractorCurve *pCurve, float fTolerance )
+	: qtractorCurveEditCommand(QObject::tr("automation simplify"), pCurve),
+		m_fTolerance(fTolerance)
+{
+	QList<qtractorCurve::Node *> nodes;
+	m_pCurve->simplifyNodes(fTolerance, nodes);
+
+	QListIterator<qtractorCurve::Node *> iter(nodes);
+	while (iter.hasNext())
+		qtractorCurveEditCommand::removeNode(iter.next());
+}
+
+
+// Virtual executive method.
+bool qtractorCurveSimplifyCommand::execute ( bool bRedo )
+{
+	// Swap the curve tolerance as well...
+	const float fTolerance = m_pCurve->tolerance();
+	m_pCurve->setTolerance(m_fTolerance);
+	m_fTolerance = fTolerance;
+
+	return qtractorCurveEditCommand::execute(bRedo);
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorCurveClearAllCommand - declaration.
 //
@@ -306,6 +306,9 @@ public:
 	// Composite predicate.
 	bool isEmpty() const;
 
+	// Approximate memory footprint.
+	unsigned long size() const;
+
 protected:
 
 	// Virtual executive method.
@@ -331,6 +334,29 @@ public:
 };
 
 
+//----------------------------------------------------------------------
+// class qtractorCurveSimplifyCommand - declaration.
+//
+
+class qtractorCurveSimplifyCommand : public qtractorCurveEditCommand
+{
+public:
+
+	// Constructor.
+	qtractorCurveSimplifyCommand(qtractorCurve *pCurve, float fTolerance);
+
+protected:
+
+	// Virtual executive method.
+	bool execute(bool bRedo);
+
+private:
+
+	// Instance variables.
+	float m_fTolerance;
+};
+
+
 //----------------------------------------------------------------------
 // class qtractorCurveClearAllCommand - declaration.
 //
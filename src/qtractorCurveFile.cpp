@@ -31,13 +31,50 @@
 #include "qtractorMessageList.h"
 
 #include <QDomDocument>
+#include <QVector>
+#include <QFile>
 #include <QDir>
 
+#include <string.h>
+
+
+//----------------------------------------------------------------------
+// Binary curve file layout (host byte order): one header, one entry
+// per curve and then all node records, meant to be memory mapped.
+// Not portable across hosts of different byte order, hence opt-in;
+// files of foreign byte order (or version) fall back to SMF reading.
+//
+
+#define QTRACTOR_CURVE_FILE_MAGIC   "QTCURVES"
+#define QTRACTOR_CURVE_FILE_ORDER   0x01020304
+#define QTRACTOR_CURVE_FILE_VERSION 1
+
+struct qtractor_curve_file_header
+{
+	char         magic[8];
+	unsigned int byte_order;
+	unsigned int version;
+	unsigned int curves;
+	unsigned int reserved;
+};
+
+struct qtractor_curve_file_entry
+{
+	unsigned long long frame;	// First node frame.
+	unsigned long long offset;	// Node records (file offset).
+	unsigned int       nodes;
+	unsigned int       mode;
+};
+
 
 //----------------------------------------------------------------------
 // class qtractorCurveFile -- Automation curve file interface impl.
 //
 
+// Binary file format global option.
+bool qtractorCurveFile::g_bBinaryFormat = false;
+
+
 // Curve item list serialization methods.
 void qtractorCurveFile::load ( QDomElement *pElement )
 {
@@ -73,6 +110,7 @@ void qtractorCurveFile::load ( QDomElement *pElement )
 					pItem->capture = false;
 					pItem->locked  = false;
 					pItem->logarithmic = false;
+					pItem->tolerance = 0.0f;
 					for (QDomNode nProp = eItem.firstChild();
 							!nProp.isNull(); nProp = nProp.nextSibling()) {
 						// Convert node to element, if any.
@@ -102,6 +140,9 @@ void qtractorCurveFile::load ( QDomElement *pElement )
 						else
 						if (eProp.tagName() == "color")
 							pItem->color.setNamedColor(eProp.text());
+						else
+						if (eProp.tagName() == "tolerance")
+							pItem->tolerance = eProp.text().toFloat();
 					}
 					pItem->subject = NULL;
 					addItem(pItem);
@@ -118,14 +159,134 @@ void qtractorCurveFile::save ( qtractorDocument *pDocument,
 	if (m_pCurveList == NULL)
 		return;
 
-	const unsigned short iSeqs = m_items.count();
-	if (iSeqs < 1)
+	if (m_items.isEmpty())
 		return;
 
+	// Only non-empty curves are ever saved...
+	QList<Item *> items;
+	QListIterator<Item *> iter(m_items);
+	while (iter.hasNext()) {
+		Item *pItem = iter.next();
+		qtractorCurve *pCurve = (pItem->subject)->curve();
+		if (pCurve && !pCurve->isEmpty())
+			items.append(pItem);
+	}
+
+	// Binary format first, falling back to SMF...
+	if (!(g_bBinaryFormat && saveBinaryFile(items))
+		&& !saveMidiFile(items, pTimeScale))
+		return;
+
+	int iCurrent = -1;
+	QDomElement eItems = pDocument->document()->createElement("curve-items");
+	QListIterator<Item *> item_iter(items);
+	while (item_iter.hasNext()) {
+		Item *pItem = item_iter.next();
+		qtractorCurve *pCurve = (pItem->subject)->curve();
+		QDomElement eItem
+			= pDocument->document()->createElement("curve-item");
+		eItem.setAttribute("name", pItem->name);
+		eItem.setAttribute("index", QString::number(pItem->index));
+		eItem.setAttribute("mode", textFromMode(pItem->mode));
+		pDocument->saveTextElement("type",
+			qtractorMidiControl::textFromType(pItem->ctype), &eItem);
+		pDocument->saveTextElement("channel",
+			QString::number(pItem->channel), &eItem);
+		pDocument->saveTextElement("param",
+			QString::number(pItem->param), &eItem);
+		pDocument->saveTextElement("mode",
+			textFromMode(pItem->mode), &eItem);
+		pDocument->saveTextElement("process",
+			pDocument->textFromBool(pItem->process), &eItem);
+		pDocument->saveTextElement("capture",
+			pDocument->textFromBool(pItem->capture), &eItem);
+		pDocument->saveTextElement("locked",
+			pDocument->textFromBool(pItem->locked), &eItem);
+		pDocument->saveTextElement("logarithmic",
+			pDocument->textFromBool(pItem->logarithmic), &eItem);
+		pDocument->saveTextElement("color",
+			pItem->color.name(), &eItem);
+		pDocument->saveTextElement("tolerance",
+			QString::number(pItem->tolerance), &eItem);
+		if (m_pCurveList->currentCurve() == pCurve)
+			iCurrent = pItem->index;
+		eItems.appendChild(eItem);
+	}
+
+	pElement->appendChild(eItems);
+
+	const QString& sFilename
+		= QDir(m_sBaseDir).relativeFilePath(m_sFilename);
+	pDocument->saveTextElement("filename",
+		pDocument->addFile(sFilename), pElement);
+
+	if (iCurrent >= 0) {
+		pDocument->saveTextElement("current",
+			QString::number(iCurrent), pElement);
+	}
+}
+
+
+// Binary curve file writer.
+bool qtractorCurveFile::saveBinaryFile ( const QList<Item *>& items ) const
+{
+	const unsigned int iCurves = items.count();
+
+	qtractor_curve_file_header header;
+	::memset(&header, 0, sizeof(header));
+	::memcpy(header.magic, QTRACTOR_CURVE_FILE_MAGIC, sizeof(header.magic));
+	header.byte_order = QTRACTOR_CURVE_FILE_ORDER;
+	header.version = QTRACTOR_CURVE_FILE_VERSION;
+	header.curves = iCurves;
+
+	QVector<qtractor_curve_file_entry> entries(iCurves);
+	QVector<qtractorCurve::FileNode> nodes;
+
+	unsigned long long iOffset = sizeof(header)
+		+ iCurves * sizeof(qtractor_curve_file_entry);
+
+	for (unsigned int i = 0; i < iCurves; ++i) {
+		qtractorCurve *pCurve = (items.at(i)->subject)->curve();
+		const unsigned int iNodes = pCurve->nodes().count();
+		const int iFirst = nodes.count();
+		nodes.resize(iFirst + iNodes);
+		unsigned long iFrame = 0;
+		if (!pCurve->writeFileNodes(nodes.data() + iFirst, iFrame))
+			return false;
+		qtractor_curve_file_entry& entry = entries[i];
+		entry.frame  = iFrame;
+		entry.offset = iOffset;
+		entry.nodes  = iNodes;
+		entry.mode   = (unsigned int) pCurve->mode();
+		iOffset += iNodes * sizeof(qtractorCurve::FileNode);
+	}
+
+	QFile file(m_sFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		return false;
+
+	file.write((const char *) &header, sizeof(header));
+	file.write((const char *) entries.constData(),
+		iCurves * sizeof(qtractor_curve_file_entry));
+	file.write((const char *) nodes.constData(),
+		nodes.count() * sizeof(qtractorCurve::FileNode));
+
+	const bool bResult = (file.error() == QFile::NoError);
+	file.close();
+
+	return bResult;
+}
+
+
+// Standard MIDI file writer.
+bool qtractorCurveFile::saveMidiFile (
+	const QList<Item *>& items, qtractorTimeScale *pTimeScale ) const
+{
 	qtractorMidiFile file;
 	if (!file.open(m_sFilename, qtractorMidiFile::Write))
-		return;
+		return false;
 
+	const unsigned short iSeqs = m_items.count();
 	const unsigned short iTicksPerBeat = pTimeScale->ticksPerBeat();
 	unsigned short iSeq = 0;
 
@@ -135,51 +296,18 @@ void qtractorCurveFile::save ( qtractorDocument *pDocument,
 
 	iSeq = 0;
 
-	int iCurrent = -1;
-	QDomElement eItems = pDocument->document()->createElement("curve-items");
-	QListIterator<Item *> iter(m_items);
+	QListIterator<Item *> iter(items);
 	while (iter.hasNext()) {
 		Item *pItem = iter.next();
 		qtractorCurve *pCurve = (pItem->subject)->curve();
-		if (pCurve && !pCurve->isEmpty()) {
-			qtractorMidiSequence *pSeq = ppSeqs[iSeq];
-			pCurve->writeMidiSequence(pSeq,
-				pItem->ctype,
-				pItem->channel,
-				pItem->param,
-				pTimeScale);
-			QDomElement eItem
-				= pDocument->document()->createElement("curve-item");
-			eItem.setAttribute("name", pItem->name);
-			eItem.setAttribute("index", QString::number(pItem->index));
-			eItem.setAttribute("mode", textFromMode(pItem->mode));
-			pDocument->saveTextElement("type",
-				qtractorMidiControl::textFromType(pItem->ctype), &eItem);
-			pDocument->saveTextElement("channel",
-				QString::number(pItem->channel), &eItem);
-			pDocument->saveTextElement("param",
-				QString::number(pItem->param), &eItem);
-			pDocument->saveTextElement("mode",
-				textFromMode(pItem->mode), &eItem);
-			pDocument->saveTextElement("process",
-				pDocument->textFromBool(pItem->process), &eItem);
-			pDocument->saveTextElement("capture",
-				pDocument->textFromBool(pItem->capture), &eItem);
-			pDocument->saveTextElement("locked",
-				pDocument->textFromBool(pItem->locked), &eItem);
-			pDocument->saveTextElement("logarithmic",
-				pDocument->textFromBool(pItem->logarithmic), &eItem);
-			pDocument->saveTextElement("color",
-				pItem->color.name(), &eItem);
-			if (m_pCurveList->currentCurve() == pCurve)
-				iCurrent = pItem->index;
-			eItems.appendChild(eItem);
-			++iSeq;
-		}
+		pCurve->writeMidiSequence(ppSeqs[iSeq],
+			pItem->ctype,
+			pItem->channel,
+			pItem->param,
+			pTimeScale);
+		++iSeq;
 	}
 
-	pElement->appendChild(eItems);
-	
 	file.writeHeader(1, iSeqs, iTicksPerBeat);
 	file.writeTracks(ppSeqs, iSeqs);
 	file.close();
@@ -188,15 +316,7 @@ void qtractorCurveFile::save ( qtractorDocument *pDocument,
 		delete ppSeqs[iSeq];
 	delete [] ppSeqs;
 
-	const QString& sFilename
-		= QDir(m_sBaseDir).relativeFilePath(m_sFilename);
-	pDocument->saveTextElement("filename",
-		pDocument->addFile(sFilename), pElement);
-
-	if (iCurrent >= 0) {
-		pDocument->saveTextElement("current",
-			QString::number(iCurrent), pElement);
-	}
+	return true;
 }
 
 
@@ -207,8 +327,29 @@ void qtractorCurveFile::apply ( qtractorTimeScale *pTimeScale )
 
 	const QString& sFilename = QDir(m_sBaseDir).absoluteFilePath(m_sFilename);
 
+	// Binary curve file? Just map it in...
+	QFile bfile(sFilename);
+	const uchar *pData = NULL;
+	qint64 iSize = 0;
+	if (bfile.open(QIODevice::ReadOnly)) {
+		iSize = bfile.size();
+		if (iSize >= qint64(sizeof(qtractor_curve_file_header)))
+			pData = bfile.map(0, iSize);
+		const qtractor_curve_file_header *pHeader
+			= (const qtractor_curve_file_header *) pData;
+		if (pHeader && (::memcmp(pHeader->magic,
+				QTRACTOR_CURVE_FILE_MAGIC, sizeof(pHeader->magic))
+			|| pHeader->byte_order != QTRACTOR_CURVE_FILE_ORDER
+			|| pHeader->version != QTRACTOR_CURVE_FILE_VERSION
+			|| qint64(sizeof(qtractor_curve_file_header)
+				+ pHeader->curves * sizeof(qtractor_curve_file_entry)) > iSize)) {
+			bfile.unmap((uchar *) pData);
+			pData = NULL;
+		}
+	}
+
 	qtractorMidiFile file;
-	if (!file.open(sFilename, qtractorMidiFile::Read)) {
+	if (pData == NULL && !file.open(sFilename, qtractorMidiFile::Read)) {
 		const QString& sText
 			= QObject::tr("%1: Automation/curve file not found.")
 				.arg(sFilename);
@@ -231,24 +372,46 @@ void qtractorCurveFile::apply ( qtractorTimeScale *pTimeScale )
 					pItem->subject, pItem->mode);
 			if (m_iCurrentCurve == int(pItem->index))
 				pCurrentCurve = pCurve;
-			qtractorMidiSequence seq(QString(), pItem->channel, iTicksPerBeat);
-			if (file.readTrack(&seq, iSeq)) {
-				pCurve->readMidiSequence(&seq,
-					pItem->ctype,
-					pItem->channel,
-					pItem->param,
-					pTimeScale);
+			if (pData) {
+				const qtractor_curve_file_header *pHeader
+					= (const qtractor_curve_file_header *) pData;
+				const qtractor_curve_file_entry *pEntries
+					= (const qtractor_curve_file_entry *) (pHeader + 1);
+				if (iSeq < pHeader->curves) {
+					const qtractor_curve_file_entry& entry = pEntries[iSeq];
+					if (entry.mode <= (unsigned int) qtractorCurve::Spline
+						&& qint64(entry.offset
+						+ entry.nodes * sizeof(qtractorCurve::FileNode)) <= iSize) {
+						pCurve->readFileNodes(
+							(const qtractorCurve::FileNode *) (pData + entry.offset),
+							entry.nodes, entry.frame,
+							qtractorCurve::Mode(entry.mode));
+					}
+				}
+			} else {
+				qtractorMidiSequence seq(QString(), pItem->channel, iTicksPerBeat);
+				if (file.readTrack(&seq, iSeq)) {
+					pCurve->readMidiSequence(&seq,
+						pItem->ctype,
+						pItem->channel,
+						pItem->param,
+						pTimeScale);
+				}
 			}
 			pCurve->setProcess(pItem->process);
 			pCurve->setCapture(pItem->capture);
 			pCurve->setLocked(pItem->locked);
 			pCurve->setLogarithmic(pItem->logarithmic);
 			pCurve->setColor(pItem->color);
+			pCurve->setTolerance(pItem->tolerance);
 		}
 		++iSeq;
 	}
 
-	file.close();
+	if (pData)
+		bfile.unmap((uchar *) pData);
+	else
+		file.close();
 
 	if (pCurrentCurve)
 		m_pCurveList->setCurrentCurve(pCurrentCurve);
@@ -293,4 +456,23 @@ QString qtractorCurveFile::textFromMode ( qtractorCurve::Mode mode )
 }
 
 
+// Binary file format (vs. SMF) global option.
+void qtractorCurveFile::setBinaryFormat ( bool bBinaryFormat )
+{
+	g_bBinaryFormat = bBinaryFormat;
+}
+
+bool qtractorCurveFile::isBinaryFormat (void)
+{
+	return g_bBinaryFormat;
+}
+
+
+// Default file suffix, according to format.
+QString qtractorCurveFile::defaultExt (void)
+{
+	return (g_bBinaryFormat ? "qtc" : "mid");
+}
+
+
 // end of qtractorCurveFile.cpp
@@ -85,6 +85,7 @@ public:
 		bool             locked;
 		bool             logarithmic;
 		QColor           color;
+		float            tolerance;
 		qtractorSubject *subject;
 	};
 
@@ -118,6 +119,20 @@ public:
 	static qtractorCurve::Mode modeFromText(const QString& sText);
 	static QString textFromMode(qtractorCurve::Mode mode);
 
+	// Binary file format (vs. SMF) global option.
+	static void setBinaryFormat(bool bBinaryFormat);
+	static bool isBinaryFormat();
+
+	// Default file suffix, according to format.
+	static QString defaultExt();
+
+protected:
+
+	// Curve file format writers.
+	bool saveBinaryFile(const QList<Item *>& items) const;
+	bool saveMidiFile(const QList<Item *>& items,
+		qtractorTimeScale *pTimeScale) const;
+
 private:
 
 	// Instance variables.
@@ -128,6 +143,9 @@ private:
 	QList<Item *>      m_items;
 
 	int                m_iCurrentCurve;
+
+	// Binary file format global option.
+	static bool g_bBinaryFormat;
 };
 
 
@@ -28,10 +28,21 @@
 
 #include <QDomDocument>
 
+#include <QXmlStreamWriter>
+#include <QXmlStreamReader>
+
 #include <QFileInfo>
-#include <QTextStream>
+#include <QThread>
+#include <QBuffer>
 #include <QDir>
 
+#include <stdio.h>
+#include <unistd.h>
+
+#ifdef CONFIG_DEBUG
+#include <QTime>
+#endif
+
 
 // Local prototypes.
 static void remove_dir_list(const QList<QFileInfo>& list);
@@ -69,6 +80,179 @@ static void remove_dir_list ( const QList<QFileInfo>& list )
 }
 
 
+// Stream out a DOM node, recursively, straight into the output
+// device: no need to render the whole document in one big string.
+static void write_dom_node ( QXmlStreamWriter& xml, const QDomNode& node )
+{
+	if (node.isElement()) {
+		const QDomElement& elem = node.toElement();
+		xml.writeStartElement(elem.tagName());
+		const QDomNamedNodeMap& attrs = elem.attributes();
+		const int iAttrs = attrs.count();
+		for (int i = 0; i < iAttrs; ++i) {
+			const QDomAttr& attr = attrs.item(i).toAttr();
+			xml.writeAttribute(attr.name(), attr.value());
+		}
+		for (QDomNode nChild = elem.firstChild();
+				!nChild.isNull();
+					nChild = nChild.nextSibling()) {
+			write_dom_node(xml, nChild);
+		}
+		xml.writeEndElement();
+	}
+	else
+	if (node.isCDATASection())
+		xml.writeCDATA(node.toCDATASection().data());
+	else
+	if (node.isText())
+		xml.writeCharacters(node.toText().data());
+	else
+	if (node.isComment())
+		xml.writeComment(node.toComment().data());
+	else
+	if (node.isProcessingInstruction()) {
+		const QDomProcessingInstruction& pi
+			= node.toProcessingInstruction();
+		xml.writeProcessingInstruction(pi.target(), pi.data());
+	}
+}
+
+static bool write_dom_document (
+	QIODevice *pDevice, const QDomDocument& doc )
+{
+	QXmlStreamWriter xml(pDevice);
+	xml.setAutoFormatting(true);
+	xml.setAutoFormattingIndent(1);
+
+	const QString& sDocType = doc.doctype().name();
+	if (!sDocType.isEmpty())
+		xml.writeDTD("<!DOCTYPE " + sDocType + '>');
+
+	for (QDomNode node = doc.firstChild();
+			!node.isNull();
+				node = node.nextSibling()) {
+		write_dom_node(xml, node);
+	}
+
+	xml.writeEndDocument();
+
+	// Trailing newline, as QDomDocument::save() would do...
+	if (!xml.hasError())
+		pDevice->write("\n", 1);
+
+	return !xml.hasError();
+}
+
+
+// Parse the input device into a DOM tree, through a stream reader;
+// the whole tree still gets built, as QDomDocument::setContent().
+static bool read_dom_document ( QIODevice *pDevice, QDomDocument& doc )
+{
+	// Start from scratch (but the document type)...
+	QDomNode node = doc.firstChild();
+	while (!node.isNull()) {
+		const QDomNode nNext = node.nextSibling();
+		if (!node.isDocumentType())
+			doc.removeChild(node);
+		node = nNext;
+	}
+
+	QXmlStreamReader xml(pDevice);
+
+	node = doc;
+	while (!xml.atEnd()) {
+		switch (xml.readNext()) {
+		case QXmlStreamReader::StartElement: {
+			QDomElement elem = doc.createElement(xml.qualifiedName().toString());
+			const QXmlStreamAttributes& attrs = xml.attributes();
+			QXmlStreamAttributes::ConstIterator iter = attrs.constBegin();
+			const QXmlStreamAttributes::ConstIterator& iter_end
+				= attrs.constEnd();
+			for ( ; iter != iter_end; ++iter) {
+				elem.setAttribute(
+					iter->qualifiedName().toString(), iter->value().toString());
+			}
+			node = node.appendChild(elem);
+			break;
+		}
+		case QXmlStreamReader::EndElement:
+			node = node.parentNode();
+			break;
+		case QXmlStreamReader::Characters:
+			// Skip ignorable whitespace, as QDomDocument does by default.
+			if (xml.isCDATA())
+				node.appendChild(doc.createCDATASection(xml.text().toString()));
+			else
+			if (!xml.isWhitespace())
+				node.appendChild(doc.createTextNode(xml.text().toString()));
+			break;
+		case QXmlStreamReader::Comment:
+			node.appendChild(doc.createComment(xml.text().toString()));
+			break;
+		default:
+			break;
+		}
+	}
+
+	return !xml.hasError();
+}
+
+
+//-------------------------------------------------------------------------
+// qtractorDocumentSnapshot -- Background document writer thread.
+//
+// It only gets the already serialized document (a self-contained
+// byte array), so nothing else is shared with the GUI thread.
+
+class qtractorDocumentSnapshot : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorDocumentSnapshot (
+		const QByteArray& data, const QString& sFilename )
+		: QThread(), m_data(data), m_sFilename(sFilename), m_bResult(false) {}
+
+	// Final outcome.
+	bool result() const { return m_bResult; }
+
+protected:
+
+	// The main thread executive: write to a temporary file
+	// first, then rename it over the target one, atomically.
+	void run()
+	{
+		const QString sTempname = m_sFilename + ".tmp";
+		QFile file(sTempname);
+		if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+			m_bResult = (file.write(m_data) == m_data.size())
+				&& file.flush() && ::fsync(file.handle()) == 0;
+			file.close();
+			if (m_bResult) {
+				m_bResult = (::rename(
+					QFile::encodeName(sTempname).constData(),
+					QFile::encodeName(m_sFilename).constData()) == 0);
+			}
+			if (!m_bResult)
+				file.remove();
+		}
+		// Release the whole data here, not in the GUI thread...
+		m_data.clear();
+	}
+
+private:
+
+	// Instance variables.
+	QByteArray   m_data;
+	QString      m_sFilename;
+	bool         m_bResult;
+};
+
+
+// The one and only background writer (static).
+static qtractorDocumentSnapshot *g_pSnapshot = NULL;
+
+
 //-------------------------------------------------------------------------
 // qtractorDocument -- Session file import/export helper class.
 //
@@ -222,12 +406,19 @@ bool qtractorDocument::load ( const QString& sFilename, Flags flags )
 	QFile file(sDocname);
 	if (!file.open(mode))
 		return false;
-	// Parse it a-la-DOM :-)
-	if (!m_pDocument->setContent(&file)) {
+#ifdef CONFIG_DEBUG
+	QTime t; t.start();
+#endif
+	// Parse it a-la-DOM, streamlined :-)
+	if (!read_dom_document(&file, *m_pDocument)) {
 		file.close();
 		return false;
 	}
 	file.close();
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorDocument::load(\"%s\") elapsed=%d msecs",
+		sDocname.toUtf8().constData(), t.elapsed());
+#endif
 
 	// Get root element and check for proper taqg name.
 	QDomElement elem = m_pDocument->documentElement();
@@ -292,9 +483,18 @@ bool qtractorDocument::save ( const QString& sFilename, Flags flags )
 #endif
 	if (!file.open(mode))
 		return false;
-	QTextStream ts(&file);
-	ts << m_pDocument->toString() << endl;
+#ifdef CONFIG_DEBUG
+	QTime t; t.start();
+#endif
+	// Stream it out, node by node...
+	const bool bResult = write_dom_document(&file, *m_pDocument);
 	file.close();
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorDocument::save(\"%s\") elapsed=%d msecs",
+		sDocname.toUtf8().constData(), t.elapsed());
+#endif
+	if (!bResult)
+		return false;
 
 #ifdef CONFIG_LIBZ
 	// Commit to archive.
@@ -315,6 +515,76 @@ bool qtractorDocument::save ( const QString& sFilename, Flags flags )
 }
 
 
+// Background (auto-save) snapshot method.
+bool qtractorDocument::saveSnapshot ( const QString& sFilename, Flags flags )
+{
+	// Archives are a foreground matter only.
+	setFlags(Flags(flags & ~Archive));
+
+	// We must have a valid tag name...
+	if (m_sTagName.isEmpty())
+		return false;
+
+	// Previous one still in flight?
+	if (isSnapshotBusy())
+		return false;
+
+	waitSnapshot();
+
+	const QFileInfo info(sFilename);
+	m_sName = info.completeBaseName();
+
+	// Save spec (the snapshot itself)...
+	QDomElement elem = m_pDocument->createElement(m_sTagName);
+	if (!saveElement(&elem))
+		return false;
+	m_pDocument->appendChild(elem);
+
+	// Serialize it right away, in memory...
+	QByteArray data;
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::WriteOnly);
+	const bool bResult = write_dom_document(&buffer, *m_pDocument);
+	buffer.close();
+
+	// Done with the document tree...
+	m_pDocument->removeChild(elem);
+
+	if (!bResult)
+		return false;
+
+	// Hand the serialized data over to the writer thread...
+	g_pSnapshot = new qtractorDocumentSnapshot(
+		data, info.absoluteFilePath());
+	g_pSnapshot->start(QThread::LowPriority);
+
+	return true;
+}
+
+
+// Whether a background snapshot is still being written.
+bool qtractorDocument::isSnapshotBusy (void)
+{
+	return (g_pSnapshot && g_pSnapshot->isRunning());
+}
+
+
+// Wait for any background snapshot to complete.
+bool qtractorDocument::waitSnapshot (void)
+{
+	bool bResult = true;
+
+	if (g_pSnapshot) {
+		g_pSnapshot->wait();
+		bResult = g_pSnapshot->result();
+		delete g_pSnapshot;
+		g_pSnapshot = NULL;
+	}
+
+	return bResult;
+}
+
+
 // Archive filename filter.
 QString qtractorDocument::addFile ( const QString& sFilename ) const
 {
@@ -71,6 +71,16 @@ public:
 	bool load (const QString& sFilename, Flags flags = Default);
 	bool save (const QString& sFilename, Flags flags = Default);
 
+	// Background (auto-save) snapshot method: the document tree
+	// is built and serialized right away, then written to a temporary
+	// file and atomically renamed over sFilename by a worker thread.
+	bool saveSnapshot (const QString& sFilename, Flags flags = Default);
+
+	// Whether a background snapshot is still being written;
+	// wait for it to complete, if any.
+	static bool isSnapshotBusy();
+	static bool waitSnapshot();
+
 	// External storage element pure virtual methods.
 	virtual bool loadElement (QDomElement *pElement) = 0;
 	virtual bool saveElement (QDomElement *pElement) = 0;
@@ -720,6 +720,7 @@ void qtractorBus::saveCurveFile ( qtractorDocument *pDocument,
 		pCurveItem->locked = pCurve->isLocked();
 		pCurveItem->logarithmic = pCurve->isLogarithmic();
 		pCurveItem->color = pCurve->color();
+		pCurveItem->tolerance = pCurve->tolerance();
 		pCurveItem->subject = pCurve->subject();
 		pCurveFile->addItem(pCurveItem);
 	}}
@@ -738,6 +739,7 @@ void qtractorBus::saveCurveFile ( qtractorDocument *pDocument,
 		pCurveItem->locked = pCurve->isLocked();
 		pCurveItem->logarithmic = pCurve->isLogarithmic();
 		pCurveItem->color = pCurve->color();
+		pCurveItem->tolerance = pCurve->tolerance();
 		pCurveItem->subject = pCurve->subject();
 		pCurveFile->addItem(pCurveItem);
 	}
@@ -756,6 +758,7 @@ void qtractorBus::saveCurveFile ( qtractorDocument *pDocument,
 		pCurveItem->logarithmic = pCurve->isLogarithmic();
 		pCurveItem->locked = pCurve->isLocked();
 		pCurveItem->color = pCurve->color();
+		pCurveItem->tolerance = pCurve->tolerance();
 		pCurveItem->subject = pCurve->subject();
 		pCurveFile->addItem(pCurveItem);
 	}
@@ -765,7 +768,8 @@ void qtractorBus::saveCurveFile ( qtractorDocument *pDocument,
 
 	const QString sBaseName(sBusName + "_curve");
 	const int iClipNo = (pCurveFile->filename().isEmpty() ? 0 : 1);
-	pCurveFile->setFilename(pSession->createFilePath(sBaseName, "mid", iClipNo));
+	pCurveFile->setFilename(pSession->createFilePath(
+		sBaseName, qtractorCurveFile::defaultExt(), iClipNo));
 
 	pCurveFile->save(pDocument, pElement, pSession->timeScale());
 }
@@ -33,11 +33,33 @@
 #include "qtractorSession.h"
 #include "qtractorOptions.h"
 
+#include "qtractorMidiManager.h"
+#include "qtractorPlugin.h"
+
 #include <QMessageBox>
 #include <QPushButton>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QDir>
 #include <QUrl>
+#include <QRegExp>
+
+
+// Track stem file path, derived from the main export one.
+static QString qtractorExportStemPath (
+	const QString& sExportPath, int iTrack, qtractorTrack *pTrack )
+{
+	const QFileInfo fi(sExportPath);
+
+	QString sTrackName = pTrack->trackName();
+	sTrackName.replace(QRegExp("[^\\w\\-]+"), "_");
+
+	return fi.dir().filePath(QString("%1-%2-%3.%4")
+		.arg(fi.completeBaseName())
+		.arg(iTrack, 2, 10, QChar('0'))
+		.arg(sTrackName)
+		.arg(fi.suffix()));
+}
 
 
 //----------------------------------------------------------------------------
@@ -166,8 +188,12 @@ void qtractorExportForm::setExportType ( qtractorTrack::TrackType exportType )
 	if (pOptions) {
 		pOptions->loadComboBoxHistory(m_ui.ExportPathComboBox);
 		m_ui.AddTrackCheckBox->setChecked(pOptions->bExportAddTrack);
+		m_ui.ExportStemsCheckBox->setChecked(pOptions->bExportStems);
 	}
 
+	// Track stems are only meaningful to audio...
+	m_ui.ExportStemsCheckBox->setVisible(m_exportType == qtractorTrack::Audio);
+
 	// Suggest a brand new export filename...
 	if (pSession) {
 		m_ui.ExportPathComboBox->setEditText(
@@ -265,27 +291,64 @@ void qtractorExportForm::accept (void)
 					if (pExportBus)
 						exportBuses.append(pExportBus);
 				}
+				// Get the track stems, those feeding the export buses...
+				QHash<qtractorTrack *, QString> exportStems;
+				QStringList exportFiles(sExportPath);
+				if (m_ui.ExportStemsCheckBox->isChecked()) {
+					int iTrack = 0;
+					qtractorTrack *pTrack = pSession->tracks().first();
+					for ( ; pTrack; pTrack = pTrack->next()) {
+						++iTrack;
+						qtractorBus *pStemBus = NULL;
+						if (pTrack->trackType() == qtractorTrack::Audio)
+							pStemBus = pTrack->outputBus();
+						else {
+							qtractorMidiManager *pMidiManager
+								= (pTrack->pluginList())->midiManager();
+							if (pMidiManager)
+								pStemBus = pMidiManager->audioOutputBus();
+						}
+						qtractorAudioBus *pAudioBus
+							= static_cast<qtractorAudioBus *> (pStemBus);
+						if (pAudioBus == NULL
+							|| !exportBuses.contains(pAudioBus))
+							continue;
+						const QString& sStemPath
+							= qtractorExportStemPath(sExportPath, iTrack, pTrack);
+						exportStems.insert(pTrack, sStemPath);
+						exportFiles.append(sStemPath);
+					}
+				}
 				// Log this event...
 				pMainForm->appendMessages(
 					tr("Audio file export: \"%1\" started...")
 					.arg(sExportPath));
+				if (!exportStems.isEmpty()) {
+					pMainForm->appendMessages(
+						tr("Audio file export: %1 track stem(s)...")
+						.arg(exportStems.count()));
+				}
 				// Do the export as commanded...
 				QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 				const bool bResult = pAudioEngine->fileExport(
 					sExportPath, exportBuses,
 					m_ui.ExportStartSpinBox->value(),
-					m_ui.ExportEndSpinBox->value());
+					m_ui.ExportEndSpinBox->value(),
+					exportStems);
 				QApplication::restoreOverrideCursor();
 				if (bResult) {
 					// Add new tracks if necessary...
 					qtractorTracks *pTracks = pMainForm->tracks();
 					if (pTracks && m_ui.AddTrackCheckBox->isChecked()) {
 						pTracks->addAudioTracks(
-							QStringList(sExportPath),
+							exportFiles,
 							m_ui.ExportStartSpinBox->value(),
 							pTracks->currentTrack());
+					} else {
+						QStringListIterator file_iter(exportFiles);
+						while (file_iter.hasNext())
+							pMainForm->addAudioFile(file_iter.next());
 					}
-					else pMainForm->addAudioFile(sExportPath);
 					// Log the success...
 					pMainForm->appendMessages(
 						tr("Audio file export: \"%1\" complete.")
@@ -351,6 +414,8 @@ void qtractorExportForm::accept (void)
 		if (pOptions) {
 			pOptions->saveComboBoxHistory(m_ui.ExportPathComboBox);
 			pOptions->bExportAddTrack = m_ui.AddTrackCheckBox->isChecked();
+			if (m_exportType == qtractorTrack::Audio)
+				pOptions->bExportStems = m_ui.ExportStemsCheckBox->isChecked();
 		}
 	}
 
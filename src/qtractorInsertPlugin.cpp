@@ -538,6 +538,21 @@ void qtractorAudioInsertPlugin::process (
 }
 
 
+// Plugin latency (in frames): one period round-trip.
+unsigned long qtractorAudioInsertPlugin::latency (void) const
+{
+	if (m_pAudioBus == NULL)
+		return 0;
+
+	qtractorAudioEngine *pAudioEngine
+		= static_cast<qtractorAudioEngine *> (m_pAudioBus->engine());
+	if (pAudioEngine == NULL)
+		return 0;
+
+	return pAudioEngine->bufferSize();
+}
+
+
 // Pseudo-plugin configuration handlers.
 void qtractorAudioInsertPlugin::configure (
 	const QString& sKey, const QString& sValue )
@@ -1182,6 +1197,9 @@ void qtractorAudioAuxSendPlugin::setChannels ( unsigned short iChannels )
 		return;
 	}
 
+	// Send latency compensation delay-line...
+	m_sendDelay.setChannels(iChannels);
+
 #ifdef CONFIG_DEBUG
 	qDebug("qtractorAudioAuxSendPlugin[%p]::setChannels(%u) instances=%u",
 		this, iChannels, iInstances);
@@ -1275,17 +1293,44 @@ void qtractorAudioAuxSendPlugin::process (
 	float **ppOut = m_pAudioBus->out();
 
 	const unsigned short iChannels = channels();
+	const float fGain = m_pSendGainParam->value();
+
+	// Latency compensation: align the send with the longest
+	// path arriving at the aux-send bus (see updateLatency)...
+	const unsigned long iLatency = latencyBefore();
+	const unsigned long iPathLatency = m_pAudioBus->trackLatency();
+	const unsigned long iDelay
+		= (iPathLatency > iLatency ? iPathLatency - iLatency : 0);
+	const bool bDelay = ((iDelay > 0 || m_sendDelay.delay() > 0)
+		&& m_sendDelay.channels() == iChannels);
+	if (bDelay) {
+		// Output buffers hold the delayed send for a while...
+		m_sendDelay.process(ppIBuffer, ppOBuffer, nframes, iDelay);
+		(*m_pfnProcessAdd)(ppOut, ppOBuffer, nframes, iChannels, fGain);
+	}
 
 	for (unsigned short i = 0; i < iChannels; ++i)
 		::memcpy(ppOBuffer[i], ppIBuffer[i], nframes * sizeof(float));
 
-	const float fGain = m_pSendGainParam->value();
-	(*m_pfnProcessAdd)(ppOut, ppOBuffer, nframes, iChannels, fGain);
+	if (!bDelay)
+		(*m_pfnProcessAdd)(ppOut, ppOBuffer, nframes, iChannels, fGain);
 
 //	m_pAudioBus->process_commit(nframes);
 }
 
 
+// Plugin-chain latency upstream from this send.
+unsigned long qtractorAudioAuxSendPlugin::latencyBefore (void) const
+{
+	qtractorPluginList *pList = list();
+	const unsigned long iLatency = pList->latency();
+	const unsigned long iLatencyAfter
+		= pList->latencyAfter(const_cast<qtractorAudioAuxSendPlugin *> (this));
+
+	return (iLatency > iLatencyAfter ? iLatency - iLatencyAfter : 0);
+}
+
+
 // Do the actual activation.
 void qtractorAudioAuxSendPlugin::activate (void)
 {
@@ -155,6 +155,9 @@ public:
 	// The main plugin processing procedure.
 	void process(float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
 
+	// Plugin latency (in frames): one period round-trip.
+	unsigned long latency() const;
+
 	// Plugin configuration handlers.
 	void configure(const QString& sKey, const QString& sValue);
 
@@ -350,6 +353,13 @@ public:
 	// Audio bus to appear on plugin lists.
 	void updateAudioBusName() const;
 
+	// Audio aux-send bus accessor.
+	qtractorAudioBus *audioBus() const
+		{ return m_pAudioBus; }
+
+	// Plugin-chain latency upstream from this send.
+	unsigned long latencyBefore() const;
+
 protected:
 
 	// Do the actual (de)activation.
@@ -364,6 +374,9 @@ private:
 
 	qtractorInsertPluginParam *m_pSendGainParam;
 
+	// Send latency compensation delay-line.
+	qtractorAudioDelay m_sendDelay;
+
 	// Custom optimized processors.
 	void (*m_pfnProcessAdd)(float **, float **, unsigned int,
 		unsigned short, float);
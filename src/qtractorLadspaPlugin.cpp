@@ -28,6 +28,11 @@
 #include "qtractorSession.h"
 #include "qtractorAudioEngine.h"
 
+#ifdef CONFIG_PLUGIN_BRIDGE
+#include "qtractorPluginBridge.h"
+#include "qtractorOptions.h"
+#endif
+
 #include <math.h>
 
 
@@ -163,7 +168,9 @@ const QString& qtractorLadspaPluginType::aboutText (void)
 qtractorLadspaPlugin::qtractorLadspaPlugin ( qtractorPluginList *pList,
 	qtractorLadspaPluginType *pLadspaType )
 	: qtractorPlugin(pList, pLadspaType), m_phInstances(NULL),
+		m_phSpareInstances(NULL), m_iSpareInstances(0), m_ppBridges(NULL),
 		m_piControlOuts(NULL), m_pfControlOuts(NULL),
+		m_pfControlOutsEx(NULL), m_iLatencyOut(-1),
 		m_piAudioIns(NULL), m_piAudioOuts(NULL),
 		m_pfIDummy(NULL), m_pfODummy(NULL)
 {
@@ -205,6 +212,10 @@ qtractorLadspaPlugin::qtractorLadspaPlugin ( qtractorPluginList *pList,
 					m_piAudioOuts[iAudioOuts++] = i;
 				else
 				if (LADSPA_IS_PORT_CONTROL(portType)) {
+					const QString& sName = QString::fromLatin1(
+						pLadspaDescriptor->PortNames[i]).toLower();
+					if (sName == "latency" || sName == "_latency")
+						m_iLatencyOut = iControlOuts;
 					m_piControlOuts[iControlOuts] = i;
 					m_pfControlOuts[iControlOuts] = 0.0f;
 					++iControlOuts;
@@ -220,6 +231,10 @@ qtractorLadspaPlugin::qtractorLadspaPlugin ( qtractorPluginList *pList,
 // Destructor.
 qtractorLadspaPlugin::~qtractorLadspaPlugin (void)
 {
+	// No more background wake-up...
+	cancelWakeUp();
+	releaseInstances();
+
 	// Cleanup all plugin instances...
 	setChannels(0);
 
@@ -232,6 +247,8 @@ qtractorLadspaPlugin::~qtractorLadspaPlugin (void)
 		delete [] m_piControlOuts;
 	if (m_pfControlOuts)
 		delete [] m_pfControlOuts;
+	if (m_pfControlOutsEx)
+		delete [] m_pfControlOutsEx;
 
 	if (m_pfIDummy)
 		delete [] m_pfIDummy;
@@ -278,6 +295,10 @@ void qtractorLadspaPlugin::setChannels ( unsigned short iChannels )
 		m_phInstances = NULL;
 	}
 
+#ifdef CONFIG_PLUGIN_BRIDGE
+	closeBridges(iOldInstances);
+#endif
+
 	// Bail out, if none are about to be created...
 	if (iInstances < 1) {
 		setActivated(bActivated);
@@ -321,47 +342,83 @@ void qtractorLadspaPlugin::setChannels ( unsigned short iChannels )
 	// We'll need output control (not dummy anymore) port indexes...
 	const unsigned short iControlOuts = pLadspaType->controlOuts();
 
+	// Extra instances get their own output control ports,
+	// as they might be run concurrently (parallel dispatch)...
+	if (m_pfControlOutsEx) {
+		delete [] m_pfControlOutsEx;
+		m_pfControlOutsEx = NULL;
+	}
+
+	if (iInstances > 1 && iControlOuts > 0) {
+		const unsigned int iControlOutsEx = (iInstances - 1) * iControlOuts;
+		m_pfControlOutsEx = new float [iControlOutsEx];
+		::memset(m_pfControlOutsEx, 0, iControlOutsEx * sizeof(float));
+	}
+
 	unsigned short i, j;
 
+#ifdef CONFIG_PLUGIN_BRIDGE
+	// Try running out-of-process first, if asked for...
+	openBridges(iInstances, iSampleRate, iBufferSize);
+#endif
+
 	// Allocate new instances...
-	m_phInstances = new LADSPA_Handle [iInstances];
-	for (i = 0; i < iInstances; ++i) {
-		// Instantiate them properly first...
-		LADSPA_Handle handle
-			= (*pLadspaDescriptor->instantiate)(pLadspaDescriptor, iSampleRate);
-		// Connect all existing input control ports...
-		const qtractorPlugin::Params& params = qtractorPlugin::params();
-		qtractorPlugin::Params::ConstIterator param = params.constBegin();
-		const qtractorPlugin::Params::ConstIterator& param_end = params.constEnd();
-		for ( ; param != param_end; ++param) {
-			qtractorPluginParam *pParam = param.value();
-			// Just in case the plugin decides
-			// to set the port value at this time...
-			float *pfValue = pParam->subject()->data();
-			float   fValue = *pfValue;
-			(*pLadspaDescriptor->connect_port)(handle,
-				pParam->index(), pfValue);
-			// Make new one the default and restore port value...
-			pParam->setDefaultValue(*pfValue);
-			*pfValue = fValue;
+	if (m_ppBridges == NULL) {
+		// Adopt any spare instances prepared in the background...
+		LADSPA_Handle *phSpareInstances = NULL;
+		if (m_phSpareInstances && m_iSpareInstances == iInstances) {
+			phSpareInstances = m_phSpareInstances;
+			m_phSpareInstances = NULL;
+			m_iSpareInstances = 0;
 		}
-		// Connect all existing output control ports...
-		for (j = 0; j < iControlOuts; ++j) {
-			(*pLadspaDescriptor->connect_port)(handle,
-				m_piControlOuts[j], &m_pfControlOuts[j]);
-		}
-		// Connect all dummy input ports...
-		if (m_pfIDummy) for (j = iChannels; j < iAudioIns; ++j) {
-			(*pLadspaDescriptor->connect_port)(handle,
-				m_piAudioIns[j], m_pfIDummy); // dummy input port!
-		}
-		// Connect all dummy output ports...
-		if (m_pfODummy) for (j = iChannels; j < iAudioOuts; ++j) {
-			(*pLadspaDescriptor->connect_port)(handle,
-				m_piAudioOuts[j], m_pfODummy); // dummy input port!
+		m_phInstances = new LADSPA_Handle [iInstances];
+		for (i = 0; i < iInstances; ++i) {
+			// Instantiate them properly first...
+			LADSPA_Handle handle = NULL;
+			if (phSpareInstances)
+				handle = phSpareInstances[i];
+			if (handle == NULL)
+				handle = (*pLadspaDescriptor->instantiate)(
+					pLadspaDescriptor, iSampleRate);
+			// Connect all existing input control ports...
+			const qtractorPlugin::Params& params = qtractorPlugin::params();
+			qtractorPlugin::Params::ConstIterator param = params.constBegin();
+			const qtractorPlugin::Params::ConstIterator& param_end = params.constEnd();
+			for ( ; param != param_end; ++param) {
+				qtractorPluginParam *pParam = param.value();
+				// Just in case the plugin decides
+				// to set the port value at this time...
+				float *pfValue = pParam->data();
+				float   fValue = *pfValue;
+				(*pLadspaDescriptor->connect_port)(handle,
+					pParam->index(), pfValue);
+				// Make new one the default and restore port value...
+				pParam->setDefaultValue(*pfValue);
+				*pfValue = fValue;
+			}
+			// Connect all existing output control ports...
+			float *pfControlOuts = m_pfControlOuts;
+			if (i > 0 && m_pfControlOutsEx)
+				pfControlOuts = &m_pfControlOutsEx[(i - 1) * iControlOuts];
+			for (j = 0; j < iControlOuts; ++j) {
+				(*pLadspaDescriptor->connect_port)(handle,
+					m_piControlOuts[j], &pfControlOuts[j]);
+			}
+			// Connect all dummy input ports...
+			if (m_pfIDummy) for (j = iChannels; j < iAudioIns; ++j) {
+				(*pLadspaDescriptor->connect_port)(handle,
+					m_piAudioIns[j], m_pfIDummy); // dummy input port!
+			}
+			// Connect all dummy output ports...
+			if (m_pfODummy) for (j = iChannels; j < iAudioOuts; ++j) {
+				(*pLadspaDescriptor->connect_port)(handle,
+					m_piAudioOuts[j], m_pfODummy); // dummy input port!
+			}
+			// This is it...
+			m_phInstances[i] = handle;
 		}
-		// This is it...
-		m_phInstances[i] = handle;
+		if (phSpareInstances)
+			delete [] phSpareInstances;
 	}
 
 	// (Re)issue all configuration as needed...
@@ -377,6 +434,83 @@ void qtractorLadspaPlugin::setChannels ( unsigned short iChannels )
 }
 
 
+// Background instantiation support (dormant wake-up):
+// plain LADSPA plugins only, when not bridged anyway.
+bool qtractorLadspaPlugin::canPrepareInstances (void) const
+{
+	if (type()->typeHint() != qtractorPluginType::Ladspa)
+		return false;
+
+#ifdef CONFIG_PLUGIN_BRIDGE
+	qtractorOptions *pOptions = qtractorOptions::getInstance();
+	if (pOptions && pOptions->bPluginBridge)
+		return false;
+#endif
+
+	return true;
+}
+
+
+// Create spare instances (wake-up worker thread).
+void qtractorLadspaPlugin::prepareInstances (void)
+{
+	if (m_phSpareInstances)
+		return;
+
+	qtractorLadspaPluginType *pLadspaType
+		= static_cast<qtractorLadspaPluginType *> (type());
+	if (pLadspaType == NULL)
+		return;
+
+	const LADSPA_Descriptor *pLadspaDescriptor
+		= pLadspaType->ladspa_descriptor();
+	if (pLadspaDescriptor == NULL)
+		return;
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == NULL)
+		return;
+
+	qtractorAudioEngine *pAudioEngine = pSession->audioEngine();
+	if (pAudioEngine == NULL)
+		return;
+
+	const unsigned int iSampleRate = pAudioEngine->sampleRate();
+	const unsigned short iInstances
+		= pLadspaType->instances(channels(), list()->isMidi());
+	if (iInstances < 1)
+		return;
+
+	LADSPA_Handle *phInstances = new LADSPA_Handle [iInstances];
+	for (unsigned short i = 0; i < iInstances; ++i) {
+		phInstances[i]
+			= (*pLadspaDescriptor->instantiate)(pLadspaDescriptor, iSampleRate);
+	}
+
+	m_phSpareInstances = phInstances;
+	m_iSpareInstances = iInstances;
+}
+
+
+// Drop unused spare instances.
+void qtractorLadspaPlugin::releaseInstances (void)
+{
+	if (m_phSpareInstances == NULL)
+		return;
+
+	const LADSPA_Descriptor *pLadspaDescriptor = ladspa_descriptor();
+	for (unsigned short i = 0; i < m_iSpareInstances; ++i) {
+		LADSPA_Handle handle = m_phSpareInstances[i];
+		if (handle && pLadspaDescriptor && pLadspaDescriptor->cleanup)
+			(*pLadspaDescriptor->cleanup)(handle);
+	}
+
+	delete [] m_phSpareInstances;
+	m_phSpareInstances = NULL;
+	m_iSpareInstances = 0;
+}
+
+
 // Specific accessors.
 const LADSPA_Descriptor *qtractorLadspaPlugin::ladspa_descriptor (void) const
 {
@@ -399,6 +533,14 @@ void qtractorLadspaPlugin::activate (void)
 	if (pLadspaDescriptor == NULL)
 		return;
 
+#ifdef CONFIG_PLUGIN_BRIDGE
+	if (m_ppBridges) {
+		for (unsigned short i = 0; i < instances(); ++i)
+			m_ppBridges[i]->activate();
+		return;
+	}
+#endif
+
 	if (m_phInstances && pLadspaDescriptor->activate) {
 		for (unsigned short i = 0; i < instances(); ++i)
 			(*pLadspaDescriptor->activate)(m_phInstances[i]);
@@ -413,6 +555,14 @@ void qtractorLadspaPlugin::deactivate (void)
 	if (pLadspaDescriptor == NULL)
 		return;
 
+#ifdef CONFIG_PLUGIN_BRIDGE
+	if (m_ppBridges) {
+		for (unsigned short i = 0; i < instances(); ++i)
+			m_ppBridges[i]->deactivate();
+		return;
+	}
+#endif
+
 	if (m_phInstances && pLadspaDescriptor->deactivate) {
 		for (unsigned short i = 0; i < instances(); ++i)
 			(*pLadspaDescriptor->deactivate)(m_phInstances[i]);
@@ -424,6 +574,13 @@ void qtractorLadspaPlugin::deactivate (void)
 void qtractorLadspaPlugin::process (
 	float **ppIBuffer, float **ppOBuffer, unsigned int nframes )
 {
+#ifdef CONFIG_PLUGIN_BRIDGE
+	if (m_ppBridges) {
+		processBridges(ppIBuffer, ppOBuffer, nframes);
+		return;
+	}
+#endif
+
 	if (m_phInstances == NULL)
 		return;
 
@@ -437,6 +594,10 @@ void qtractorLadspaPlugin::process (
 	const unsigned short iAudioIns  = audioIns();
 	const unsigned short iAudioOuts = audioOuts();
 
+	// Spread instances across worker threads, if any...
+	if (iInstances > 1 && processInstances(ppIBuffer, ppOBuffer, nframes))
+		return;
+
 	unsigned short iIChannel = 0;
 	unsigned short iOChannel = 0;
 	unsigned short i, j;
@@ -463,6 +624,191 @@ void qtractorLadspaPlugin::process (
 }
 
 
+// Plugin latency (in frames), from the "latency" output port.
+unsigned long qtractorLadspaPlugin::latency (void) const
+{
+	if (m_iLatencyOut < 0 || m_pfControlOuts == NULL)
+		return 0;
+
+	const float fLatency = m_pfControlOuts[m_iLatencyOut];
+	return (fLatency > 0.0f ? (unsigned long) fLatency : 0);
+}
+
+
+// Single instance processing procedure (parallel dispatch).
+void qtractorLadspaPlugin::processInstance ( unsigned short iInstance,
+	float **ppIBuffer, float **ppOBuffer, unsigned int nframes )
+{
+	const LADSPA_Descriptor *pLadspaDescriptor = ladspa_descriptor();
+	if (pLadspaDescriptor == NULL)
+		return;
+
+	// Same channel crossing as if instances were run in sequence...
+	const unsigned short iChannels  = channels();
+	const unsigned short iAudioIns  = audioIns();
+	const unsigned short iAudioOuts = audioOuts();
+
+	unsigned short iIChannel = iInstance * iAudioIns;
+	unsigned short iOChannel = iInstance * iAudioOuts;
+	unsigned short j;
+
+	LADSPA_Handle handle = m_phInstances[iInstance];
+	// For each instance audio input port...
+	for (j = 0; j < iAudioIns && iIChannel < iChannels; ++j) {
+		(*pLadspaDescriptor->connect_port)(handle,
+			m_piAudioIns[j], ppIBuffer[iIChannel++]);
+	}
+	// For each instance audio output port...
+	for (j = 0; j < iAudioOuts && iOChannel < iChannels; ++j) {
+		(*pLadspaDescriptor->connect_port)(handle,
+			m_piAudioOuts[j], ppOBuffer[iOChannel++]);
+	}
+	// Make it run...
+	(*pLadspaDescriptor->run)(handle, nframes);
+}
+
+
+#ifdef CONFIG_PLUGIN_BRIDGE
+
+// Out-of-process (bridged) instances.
+bool qtractorLadspaPlugin::openBridges ( unsigned short iInstances,
+	unsigned int iSampleRate, unsigned int iBufferSize )
+{
+	// Only plain LADSPA plugins, and only if asked for...
+	if (type()->typeHint() != qtractorPluginType::Ladspa)
+		return false;
+
+	qtractorOptions *pOptions = qtractorOptions::getInstance();
+	if (pOptions == NULL || !pOptions->bPluginBridge)
+		return false;
+
+	if (!qtractorPluginBridge::isAvailable())
+		return false;
+
+	const LADSPA_Descriptor *pLadspaDescriptor = ladspa_descriptor();
+	if (pLadspaDescriptor == NULL)
+		return false;
+
+	// One float slot per control port, one buffer per audio port...
+	QVector<unsigned int> portSizes(pLadspaDescriptor->PortCount);
+	for (unsigned long i = 0; i < pLadspaDescriptor->PortCount; ++i) {
+		const LADSPA_PortDescriptor portType
+			= pLadspaDescriptor->PortDescriptors[i];
+		portSizes[i] = (LADSPA_IS_PORT_AUDIO(portType) ? iBufferSize : 1);
+	}
+
+	// Input control ports start with current values...
+	const qtractorPlugin::Params& params = qtractorPlugin::params();
+	const qtractorPlugin::Params::ConstIterator& param_end = params.constEnd();
+	qtractorPlugin::Params::ConstIterator param = params.constBegin();
+
+	QVector<float> portValues(pLadspaDescriptor->PortCount, 0.0f);
+	for ( ; param != param_end; ++param) {
+		qtractorPluginParam *pParam = param.value();
+		portValues[pParam->index()] = *pParam->data();
+	}
+
+	m_ppBridges = new qtractorPluginBridge * [iInstances];
+	for (unsigned short i = 0; i < iInstances; ++i)
+		m_ppBridges[i] = new qtractorPluginBridge();
+
+	for (unsigned short i = 0; i < iInstances; ++i) {
+		if (!m_ppBridges[i]->open(type()->filename(), type()->index(),
+				iSampleRate, iBufferSize, portSizes, portValues)) {
+			qWarning("qtractorLadspaPlugin[%p]::openBridges() "
+				"\"%s\" could not be bridged; running in-process.",
+				this, type()->filename().toUtf8().constData());
+			closeBridges(iInstances);
+			return false;
+		}
+	}
+
+	// Whatever the plugin has set on instantiation
+	// is the new default, just like running in-process...
+	for (param = params.constBegin(); param != param_end; ++param) {
+		qtractorPluginParam *pParam = param.value();
+		pParam->setDefaultValue(*m_ppBridges[0]->port(pParam->index()));
+	}
+
+	return true;
+}
+
+
+void qtractorLadspaPlugin::closeBridges ( unsigned short iInstances )
+{
+	if (m_ppBridges) {
+		for (unsigned short i = 0; i < iInstances; ++i)
+			delete m_ppBridges[i];
+		delete [] m_ppBridges;
+		m_ppBridges = NULL;
+	}
+}
+
+
+void qtractorLadspaPlugin::processBridges (
+	float **ppIBuffer, float **ppOBuffer, unsigned int nframes )
+{
+	// We'll cross channels over instances, as usual...
+	const unsigned short iInstances = instances();
+	const unsigned short iChannels  = channels();
+	const unsigned short iAudioIns  = audioIns();
+	const unsigned short iAudioOuts = audioOuts();
+	const unsigned short iControlOuts = type()->controlOuts();
+
+	const qtractorPlugin::Params& params = qtractorPlugin::params();
+	const qtractorPlugin::Params::ConstIterator& param_end = params.constEnd();
+
+	unsigned short iIChannel = 0;
+	unsigned short iOChannel = 0;
+	unsigned short i, j;
+
+	// Feed and kick all host processes at once...
+	for (i = 0; i < iInstances; ++i) {
+		qtractorPluginBridge *pBridge = m_ppBridges[i];
+		qtractorPlugin::Params::ConstIterator param = params.constBegin();
+		for ( ; param != param_end; ++param) {
+			qtractorPluginParam *pParam = param.value();
+			*pBridge->port(pParam->index()) = *pParam->data();
+		}
+		for (j = 0; j < iAudioIns; ++j) {
+			float *pfPort = pBridge->port(m_piAudioIns[j]);
+			if (iIChannel < iChannels)
+				::memcpy(pfPort, ppIBuffer[iIChannel++], nframes * sizeof(float));
+			else
+				::memset(pfPort, 0, nframes * sizeof(float));
+		}
+		pBridge->run(nframes);
+	}
+
+	// Wait for them all to finish...
+	for (i = 0; i < iInstances; ++i) {
+		qtractorPluginBridge *pBridge = m_ppBridges[i];
+		const bool bRun = pBridge->wait();
+		for (j = 0; j < iAudioOuts && iOChannel < iChannels; ++j) {
+			float *pfBuffer = ppOBuffer[iOChannel];
+			if (bRun) {
+				::memcpy(pfBuffer, pBridge->port(m_piAudioOuts[j]),
+					nframes * sizeof(float));
+			}
+			else // Stalled or crashed: silence...
+				::memset(pfBuffer, 0, nframes * sizeof(float));
+			++iOChannel;
+		}
+		// Output controls come from the first instance only...
+		if (i == 0 && bRun) {
+			for (j = 0; j < iControlOuts; ++j)
+				m_pfControlOuts[j] = *pBridge->port(m_piControlOuts[j]);
+		}
+	}
+
+	// Wrap dangling output channels?...
+	for (j = iOChannel; j < iChannels; ++j)
+		::memset(ppOBuffer[j], 0, nframes * sizeof(float));
+}
+
+#endif	// CONFIG_PLUGIN_BRIDGE
+
+
 //----------------------------------------------------------------------------
 // qtractorLadspaPluginParam -- LADSPA plugin control input port instance.
 //
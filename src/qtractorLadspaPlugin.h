@@ -27,6 +27,10 @@
 #include <ladspa.h>
 
 
+// Forward decls.
+class qtractorPluginBridge;
+
+
 //----------------------------------------------------------------------------
 // qtractorLadspaPluginType -- LADSPA plugin type instance.
 //
@@ -97,6 +101,14 @@ public:
 	// The main plugin processing procedure.
 	void process(float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
 
+	// Plugin latency (in frames), from the "latency" output port.
+	unsigned long latency() const;
+
+	// Background instantiation support (dormant wake-up).
+	bool canPrepareInstances() const;
+	void prepareInstances();
+	void releaseInstances();
+
 	// Specific accessors.
 	const LADSPA_Descriptor *ladspa_descriptor() const;
 	LADSPA_Handle ladspa_handle(unsigned short iInstance) const;
@@ -109,13 +121,40 @@ public:
 
 protected:
 
+	// Single instance processing procedure (parallel dispatch).
+	void processInstance(unsigned short iInstance,
+		float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
+
+#ifdef CONFIG_PLUGIN_BRIDGE
+	// Out-of-process (bridged) instances.
+	bool openBridges(unsigned short iInstances,
+		unsigned int iSampleRate, unsigned int iBufferSize);
+	void closeBridges(unsigned short iInstances);
+
+	void processBridges(
+		float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
+#endif
+
 	// Instance variables.
 	LADSPA_Handle *m_phInstances;
 
+	// Spare instances, prepared in the background.
+	LADSPA_Handle *m_phSpareInstances;
+	unsigned short m_iSpareInstances;
+
+	// Bridged instances, if any.
+	qtractorPluginBridge **m_ppBridges;
+
 	// List of output control port indexes and data.
 	unsigned long *m_piControlOuts;
 	float         *m_pfControlOuts;
 
+	// Output control port data of any extra instances.
+	float         *m_pfControlOutsEx;
+
+	// Latency output control port (index into the above).
+	int m_iLatencyOut;
+
 	// List of audio port indexes.
 	unsigned long *m_piAudioIns;
 	unsigned long *m_piAudioOuts;
@@ -39,9 +39,11 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QUrl>
+#include <QThread>
 #endif
 
 #include <math.h>
+#include <unistd.h>
 
 #ifndef INT32_MAX
 #define INT32_MAX 2147483647
@@ -180,18 +182,34 @@ const char *qtractorLv2Plugin::lv2_urid_unmap ( LV2_URID id )
 #include <QThread>
 #include <QMutex>
 #include <QWaitCondition>
+#include <QList>
 
 #include <jack/ringbuffer.h>
 
+#include <time.h>
+
+
+// Monotonic clock, in nanoseconds.
+static inline long long qtractor_lv2_worker_nsecs (void)
+{
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+
 //----------------------------------------------------------------------
 // class qtractorLv2Worker -- LV2 Worker/Schedule item decl.
 //
-class qtractorLv2WorkerThread;
+class qtractorLv2WorkerPool;
 
 class qtractorLv2Worker
 {
 public:
 
+	// Priority classes.
+	enum Priority { High = 0, Low = 1 };
+
 	// Constructor.
 	qtractorLv2Worker(qtractorLv2Plugin *pLv2Plugin,
 		const LV2_Feature *const *features);
@@ -204,10 +222,10 @@ public:
 		{ return m_lv2_features; }
 
 	// Schedule work.
-	void schedule(uint32_t size, const void *data);
+	bool schedule(uint32_t size, const void *data);
 
 	// Respond work.
-	void respond(uint32_t size, const void *data);
+	bool respond(uint32_t size, const void *data);
 
 	// Commit work.
 	void commit();
@@ -221,8 +239,27 @@ public:
 	bool isWaitSync() const
 		{ return m_bWaitSync; }
 
+	// Priority class accessor.
+	Priority priority() const
+		{ return m_priority; }
+
+	// Response latency statistics (nanoseconds).
+	unsigned long workCount() const
+		{ return m_iWorkCount; }
+	long long workLatencyAvg() const
+		{ return (m_iWorkCount > 0 ? m_iWorkNsecs / m_iWorkCount : 0); }
+	long long workLatencyMax() const
+		{ return m_iWorkNsecsMax; }
+
 private:
 
+	// Request header.
+	struct Request
+	{
+		long long stamp;
+		uint32_t  size;
+	};
+
 	// Instance members.
 	qtractorLv2Plugin  *m_pLv2Plugin;
 
@@ -231,14 +268,24 @@ private:
 	LV2_Feature         m_lv2_schedule_feature;
 	LV2_Worker_Schedule m_lv2_schedule;
 
+	Priority            m_priority;
+
 	volatile bool       m_bWaitSync;
 
+	// Per-plugin serialization guard.
+	qtractorAtomic      m_busy;
+
 	jack_ringbuffer_t  *m_pRequests;
 	jack_ringbuffer_t  *m_pResponses;
 	void               *m_pResponse;
 
-	static qtractorLv2WorkerThread *g_pWorkerThread;
-	static unsigned int             g_iWorkerRefCount;
+	// Response latency statistics.
+	unsigned long       m_iWorkCount;
+	long long           m_iWorkNsecs;
+	long long           m_iWorkNsecsMax;
+
+	static qtractorLv2WorkerPool *g_pWorkerPool;
+	static unsigned int           g_iWorkerRefCount;
 };
 
 static LV2_Worker_Status qtractor_lv2_worker_schedule (
@@ -249,11 +296,13 @@ static LV2_Worker_Status qtractor_lv2_worker_schedule (
 	if (pLv2Worker == NULL)
 		return LV2_WORKER_ERR_UNKNOWN;
 
-#ifdef CONFIG_DEBUG
+#ifdef CONFIG_DEBUG_0
 	qDebug("qtractor_lv2_worker_schedule(%p, %u, %p)", pLv2Worker, size, data);
 #endif
 
-	pLv2Worker->schedule(size, data);
+	if (!pLv2Worker->schedule(size, data))
+		return LV2_WORKER_ERR_NO_SPACE;
+
 	return LV2_WORKER_SUCCESS;
 }
 
@@ -265,170 +314,288 @@ static LV2_Worker_Status qtractor_lv2_worker_respond (
 	if (pLv2Worker == NULL)
 		return LV2_WORKER_ERR_UNKNOWN;
 
-#ifdef CONFIG_DEBUG
+#ifdef CONFIG_DEBUG_0
 	qDebug("qtractor_lv2_worker_respond(%p, %u, %p)", pLv2Worker, size, data);
 #endif
 
-	pLv2Worker->respond(size, data);
+	if (!pLv2Worker->respond(size, data))
+		return LV2_WORKER_ERR_NO_SPACE;
+
 	return LV2_WORKER_SUCCESS;
 }
 
+
 //----------------------------------------------------------------------
-// class qtractorLv2WorkerThread -- LV2 Worker/Schedule thread.
+// class qtractorLv2WorkerPool -- LV2 Worker/Schedule thread pool.
 //
-class qtractorLv2WorkerThread : public QThread
+// Scheduled workers are queued by priority class (single producer,
+// the real-time thread; multiple consumers, the pool threads) and
+// each one is only ever processed by one thread at a time.
+
+class qtractorLv2WorkerThread;
+
+class qtractorLv2WorkerPool
 {
 public:
 
 	// Constructor.
-	qtractorLv2WorkerThread(unsigned int iSyncSize = 128);
+	qtractorLv2WorkerPool(unsigned int iSyncSize = 128);
 	// Destructor.
-	~qtractorLv2WorkerThread();
+	~qtractorLv2WorkerPool();
+
+	// Start/stop all pool threads.
+	void start(unsigned int iThreads);
+	void stop();
 
-	// Thread run state accessors.
-	void setRunState(bool bRunState);
+	// Thread run state accessor.
 	bool runState() const;
 
-	// Wake from executive wait condition.
-	void sync(qtractorLv2Worker *pLv2Worker = NULL);
+	// Queue a worker and wake an idle thread (real-time safe).
+	void sync(qtractorLv2Worker *pLv2Worker);
 
-protected:
+	// Dequeue next worker, highest priority first, releasing
+	// the previous one (blocking; NULL when stopped).
+	qtractorLv2Worker *dequeue(qtractorLv2Worker *pPrevWorker = NULL);
 
-	// The main thread executive.
-	void run();
+	// Forget all pending queue entries of a worker,
+	// waiting for any thread still processing it.
+	void remove(qtractorLv2Worker *pLv2Worker);
 
 private:
 
-	// The peak file queue instance reference.
-	unsigned int          m_iSyncSize;
-	unsigned int          m_iSyncMask;
-	qtractorLv2Worker   **m_ppSyncItems;
+	// Priority classes (in order).
+	enum { Classes = 2 };
 
-	volatile unsigned int m_iSyncRead;
-	volatile unsigned int m_iSyncWrite;
+	// Sync queues (one per priority class).
+	struct SyncQueue
+	{
+		qtractorLv2Worker   **items;
+		volatile unsigned int read;
+		volatile unsigned int write;
+	};
+
+	unsigned int m_iSyncSize;
+	unsigned int m_iSyncMask;
+	SyncQueue    m_sync[Classes];
 
-	// Whether the thread is logically running.
+	// Pool threads.
+	QList<qtractorLv2WorkerThread *> m_threads;
+
+	// Workers currently being processed.
+	QList<qtractorLv2Worker *> m_current;
+
+	// Whether the threads are logically running.
 	volatile bool m_bRunState;
 
 	// Thread synchronization objects.
 	QMutex m_mutex;
 	QWaitCondition m_cond;
+	QWaitCondition m_idle;
 };
 
+
+//----------------------------------------------------------------------
+// class qtractorLv2WorkerThread -- LV2 Worker/Schedule thread.
+//
+class qtractorLv2WorkerThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorLv2WorkerThread(qtractorLv2WorkerPool *pPool)
+		: QThread(), m_pPool(pPool) {}
+
+protected:
+
+	// The main thread executive.
+	void run();
+
+private:
+
+	// The pool instance reference.
+	qtractorLv2WorkerPool *m_pPool;
+};
+
+
+// The main thread executive cycle.
+void qtractorLv2WorkerThread::run (void)
+{
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorLv2WorkerThread[%p]::run(): started...", this);
+#endif
+
+	qtractorLv2Worker *pLv2Worker = NULL;
+	while ((pLv2Worker = m_pPool->dequeue(pLv2Worker)) != NULL)
+		pLv2Worker->process();
+
+#ifdef CONFIG_DEBUG_0
+	qDebug("qtractorLv2WorkerThread[%p]::run(): stopped.\n", this);
+#endif
+}
+
+
 // Constructor.
-qtractorLv2WorkerThread::qtractorLv2WorkerThread ( unsigned int iSyncSize )
+qtractorLv2WorkerPool::qtractorLv2WorkerPool ( unsigned int iSyncSize )
 {
 	m_iSyncSize = (64 << 1);
 	while (m_iSyncSize < iSyncSize)
 		m_iSyncSize <<= 1;
 	m_iSyncMask = (m_iSyncSize - 1);
-	m_ppSyncItems = new qtractorLv2Worker * [m_iSyncSize];
-	m_iSyncRead   = 0;
-	m_iSyncWrite  = 0;
 
-	::memset(m_ppSyncItems, 0, m_iSyncSize * sizeof(qtractorLv2Worker *));
+	for (int k = 0; k < Classes; ++k) {
+		SyncQueue& queue = m_sync[k];
+		queue.items = new qtractorLv2Worker * [m_iSyncSize];
+		queue.read  = 0;
+		queue.write = 0;
+		::memset(queue.items, 0, m_iSyncSize * sizeof(qtractorLv2Worker *));
+	}
 
 	m_bRunState = false;
 }
 
 // Destructor.
-qtractorLv2WorkerThread::~qtractorLv2WorkerThread (void)
+qtractorLv2WorkerPool::~qtractorLv2WorkerPool (void)
 {
-	delete [] m_ppSyncItems;
+	stop();
+
+	for (int k = 0; k < Classes; ++k)
+		delete [] m_sync[k].items;
 }
 
-// Run state accessor.
-void qtractorLv2WorkerThread::setRunState ( bool bRunState )
+
+// Start all pool threads.
+void qtractorLv2WorkerPool::start ( unsigned int iThreads )
 {
-	QMutexLocker locker(&m_mutex);
+	m_bRunState = true;
+
+	for (unsigned int i = 0; i < iThreads; ++i) {
+		qtractorLv2WorkerThread *pThread = new qtractorLv2WorkerThread(this);
+		m_threads.append(pThread);
+		pThread->start();
+	}
 
-	m_bRunState = bRunState;
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorLv2WorkerPool[%p]::start(%u)", this, iThreads);
+#endif
 }
 
-bool qtractorLv2WorkerThread::runState (void) const
+
+// Stop all pool threads.
+void qtractorLv2WorkerPool::stop (void)
+{
+	m_mutex.lock();
+	m_bRunState = false;
+	m_cond.wakeAll();
+	m_mutex.unlock();
+
+	QListIterator<qtractorLv2WorkerThread *> iter(m_threads);
+	while (iter.hasNext()) {
+		qtractorLv2WorkerThread *pThread = iter.next();
+		while (pThread->isRunning() && !pThread->wait(100)) {
+			m_mutex.lock();
+			m_cond.wakeAll();
+			m_mutex.unlock();
+		}
+	}
+
+	qDeleteAll(m_threads);
+	m_threads.clear();
+}
+
+
+// Run state accessor.
+bool qtractorLv2WorkerPool::runState (void) const
 {
 	return m_bRunState;
 }
 
-// Wake from executive wait condition.
-void qtractorLv2WorkerThread::sync ( qtractorLv2Worker *pLv2Worker )
-{
-	if (pLv2Worker == NULL) {
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		while (r != w) {
-			qtractorLv2Worker *pSyncItem = m_ppSyncItems[r];
-			if (pSyncItem)
-				pSyncItem->setWaitSync(false);
-			++r &= m_iSyncMask;
-			w = m_iSyncWrite;
-		}
-	//	m_iSyncRead = r;
-	} else {
-		// !pLv2Worker->isWaitSync()
-		unsigned int n;
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		if (w > r) {
-			n = ((r - w + m_iSyncSize) & m_iSyncMask) - 1;
-		} else if (r > w) {
-			n = (r - w) - 1;
-		} else {
-			n = m_iSyncSize - 1;
-		}
-		if (n > 0) {
-			pLv2Worker->setWaitSync(true);
-			m_ppSyncItems[w] = pLv2Worker;
-			m_iSyncWrite = (w + 1) & m_iSyncMask;
-		}
+
+// Queue a worker and wake an idle thread (real-time safe).
+void qtractorLv2WorkerPool::sync ( qtractorLv2Worker *pLv2Worker )
+{
+	// Already queued and not yet taken?
+	if (pLv2Worker->isWaitSync())
+		return;
+
+	SyncQueue& queue = m_sync[pLv2Worker->priority()];
+
+	const unsigned int r = queue.read;
+	const unsigned int w = queue.write;
+	if (((w + 1) & m_iSyncMask) != r) {
+		pLv2Worker->setWaitSync(true);
+		queue.items[w] = pLv2Worker;
+		queue.write = (w + 1) & m_iSyncMask;
 	}
 
 	if (m_mutex.tryLock()) {
-		m_cond.wakeAll();
+		m_cond.wakeOne();
 		m_mutex.unlock();
 	}
 #ifdef CONFIG_DEBUG_0
-	else qDebug("qtractorLv2WorkerThread[%p]::sync(): tryLock() failed.", this);
+	else qDebug("qtractorLv2WorkerPool[%p]::sync(): tryLock() failed.", this);
 #endif
 }
 
-// The main thread executive cycle.
-void qtractorLv2WorkerThread::run (void)
-{
-#ifdef CONFIG_DEBUG_0
-	qDebug("qtractorLv2WorkerThread[%p]::run(): started...", this);
-#endif
 
-	m_mutex.lock();
+// Dequeue next worker, highest priority first (blocking).
+qtractorLv2Worker *qtractorLv2WorkerPool::dequeue (
+	qtractorLv2Worker *pPrevWorker )
+{
+	QMutexLocker locker(&m_mutex);
 
-	m_bRunState = true;
+	if (pPrevWorker) {
+		m_current.removeOne(pPrevWorker);
+		m_idle.wakeAll();
+	}
 
 	while (m_bRunState) {
-		// Do whatever we must, then wait for more...
-		unsigned int r = m_iSyncRead;
-		unsigned int w = m_iSyncWrite;
-		while (r != w) {
-			m_ppSyncItems[r]->process();
-			++r &= m_iSyncMask;
-			w = m_iSyncWrite;
+		for (int k = 0; k < Classes; ++k) {
+			SyncQueue& queue = m_sync[k];
+			while (queue.read != queue.write) {
+				const unsigned int r = queue.read;
+				qtractorLv2Worker *pLv2Worker = queue.items[r];
+				queue.items[r] = NULL;
+				queue.read = (r + 1) & m_iSyncMask;
+				if (pLv2Worker) {
+					m_current.append(pLv2Worker);
+					return pLv2Worker;
+				}
+			}
 		}
-		m_iSyncRead = r;
-		// Wait for sync...
-		m_cond.wait(&m_mutex);
+		// Wait for sync (sort of polling for any missed wake-up)...
+		m_cond.wait(&m_mutex, 100);
 	}
 
-	m_mutex.unlock();
+	return NULL;
+}
 
-#ifdef CONFIG_DEBUG_0
-	qDebug("qtractorLv2WorkerThread[%p]::run(): stopped.\n", this);
-#endif
+
+// Forget all pending queue entries of a worker.
+void qtractorLv2WorkerPool::remove ( qtractorLv2Worker *pLv2Worker )
+{
+	QMutexLocker locker(&m_mutex);
+
+	for (int k = 0; k < Classes; ++k) {
+		SyncQueue& queue = m_sync[k];
+		for (unsigned int r = queue.read; r != queue.write;
+				r = (r + 1) & m_iSyncMask) {
+			if (queue.items[r] == pLv2Worker)
+				queue.items[r] = NULL;
+		}
+	}
+
+	while (m_current.contains(pLv2Worker))
+		m_idle.wait(&m_mutex);
+
+	pLv2Worker->setWaitSync(false);
 }
 
+
 //----------------------------------------------------------------------
 // class qtractorLv2Worker -- LV2 Worker/Schedule item impl.
 //
-qtractorLv2WorkerThread *qtractorLv2Worker::g_pWorkerThread   = NULL;
-unsigned int             qtractorLv2Worker::g_iWorkerRefCount = 0;
+qtractorLv2WorkerPool *qtractorLv2Worker::g_pWorkerPool     = NULL;
+unsigned int           qtractorLv2Worker::g_iWorkerRefCount = 0;
 
 // Constructor.
 qtractorLv2Worker::qtractorLv2Worker (
@@ -452,31 +619,53 @@ qtractorLv2Worker::qtractorLv2Worker (
 
 	m_lv2_features[iFeatures] = NULL;
 
+	// Instruments (samplers, mostly) are usually streaming
+	// time-critical stuff; effects are loading the bulk...
+	m_priority = (pLv2Plugin->midiIns() > 0 ? High : Low);
+
 	m_bWaitSync  = false;
 
-	m_pRequests  = ::jack_ringbuffer_create(1024);
-	m_pResponses = ::jack_ringbuffer_create(1024);
-	m_pResponse  = (void *) ::malloc(1024);
+	ATOMIC_SET(&m_busy, 0);
+
+	m_pRequests  = ::jack_ringbuffer_create(4096);
+	m_pResponses = ::jack_ringbuffer_create(4096);
+	m_pResponse  = (void *) ::malloc(4096);
+
+	m_iWorkCount    = 0;
+	m_iWorkNsecs    = 0;
+	m_iWorkNsecsMax = 0;
 
 	if (++g_iWorkerRefCount == 1) {
-		g_pWorkerThread = new qtractorLv2WorkerThread();
-		g_pWorkerThread->start();
+		unsigned int iThreads = QThread::idealThreadCount();
+		if (iThreads < 2)
+			iThreads = 2;
+		else
+		if (iThreads > 4)
+			iThreads = 4;
+		g_pWorkerPool = new qtractorLv2WorkerPool();
+		g_pWorkerPool->start(iThreads);
 	}
 }
 
 // Destructor.
 qtractorLv2Worker::~qtractorLv2Worker (void)
 {
-	m_bWaitSync = false;
+	// Make sure no pool thread is (or will be) on it...
+	if (g_pWorkerPool)
+		g_pWorkerPool->remove(this);
+
+#ifdef CONFIG_DEBUG
+	if (m_iWorkCount > 0) {
+		qDebug("qtractorLv2Worker[%p]::~qtractorLv2Worker() "
+			"works=%lu latency avg=%g max=%g msecs", this, m_iWorkCount,
+			0.000001 * double(workLatencyAvg()),
+			0.000001 * double(workLatencyMax()));
+	}
+#endif
 
 	if (--g_iWorkerRefCount == 0) {
-		if (g_pWorkerThread->isRunning()) do {
-			g_pWorkerThread->setRunState(false);
-		//	g_pWorkerThread->terminate();
-			g_pWorkerThread->sync();
-		} while (!g_pWorkerThread->wait(100));
-		delete g_pWorkerThread;
-		g_pWorkerThread = NULL;
+		delete g_pWorkerPool;
+		g_pWorkerPool = NULL;
 	}
 
 	::jack_ringbuffer_free(m_pRequests);
@@ -487,20 +676,34 @@ qtractorLv2Worker::~qtractorLv2Worker (void)
 }
 
 // Schedule work.
-void qtractorLv2Worker::schedule ( uint32_t size, const void *data )
+bool qtractorLv2Worker::schedule ( uint32_t size, const void *data )
 {
-	::jack_ringbuffer_write(m_pRequests, (const char *) &size, sizeof(size));
+	if (::jack_ringbuffer_write_space(m_pRequests) < sizeof(Request) + size)
+		return false;
+
+	Request req;
+	req.stamp = qtractor_lv2_worker_nsecs();
+	req.size  = size;
+
+	::jack_ringbuffer_write(m_pRequests, (const char *) &req, sizeof(req));
 	::jack_ringbuffer_write(m_pRequests, (const char *) data, size);
 
-	if (g_pWorkerThread)
-		g_pWorkerThread->sync(this);
+	if (g_pWorkerPool)
+		g_pWorkerPool->sync(this);
+
+	return true;
 }
 
 // Response work.
-void qtractorLv2Worker::respond ( uint32_t size, const void *data )
+bool qtractorLv2Worker::respond ( uint32_t size, const void *data )
 {
+	if (::jack_ringbuffer_write_space(m_pResponses) < sizeof(size) + size)
+		return false;
+
 	::jack_ringbuffer_write(m_pResponses, (const char *) &size, sizeof(size));
 	::jack_ringbuffer_write(m_pResponses, (const char *) data, size);
+
+	return true;
 }
 
 // Commit work.
@@ -538,12 +741,9 @@ void qtractorLv2Worker::commit (void)
 	}
 }
 
-// Process work.
+// Process work (one pool thread at a time).
 void qtractorLv2Worker::process (void)
 {
-	if (!m_bWaitSync)
-		return;
-
 	const LV2_Worker_Interface *worker
 		= m_pLv2Plugin->lv2_worker_interface(0);
 	if (worker == NULL)
@@ -552,30 +752,41 @@ void qtractorLv2Worker::process (void)
 	const unsigned short iInstances = m_pLv2Plugin->instances();
 	unsigned short i;
 
-	void *buf = NULL;
-	uint32_t size = 0;
-
-	uint32_t read_space = ::jack_ringbuffer_read_space(m_pRequests);
-	if (read_space > 0)
-		buf = ::malloc(read_space);
-
-	while (read_space > 0) {
-		::jack_ringbuffer_read(m_pRequests, (char *) &size, sizeof(size));
-		::jack_ringbuffer_read(m_pRequests, (char *) buf, size);
-		if (worker->work) {
-			for (i = 0; i < iInstances; ++i) {
-				LV2_Handle handle = m_pLv2Plugin->lv2_handle(i);
-				if (handle)
-					(*worker->work)(handle,
-						qtractor_lv2_worker_respond, this, size, buf);
+	// Whoever holds it now must also take any late requests...
+	while (ATOMIC_TAS(&m_busy)) {
+		// Let it be queued again from now on...
+		m_bWaitSync = false;
+		// Take all pending requests in one batch...
+		uint32_t read_space = ::jack_ringbuffer_read_space(m_pRequests);
+		void *buf = NULL;
+		if (read_space > 0)
+			buf = ::malloc(read_space);
+		while (read_space > 0) {
+			Request req;
+			::jack_ringbuffer_read(m_pRequests, (char *) &req, sizeof(req));
+			::jack_ringbuffer_read(m_pRequests, (char *) buf, req.size);
+			if (worker->work) {
+				for (i = 0; i < iInstances; ++i) {
+					LV2_Handle handle = m_pLv2Plugin->lv2_handle(i);
+					if (handle)
+						(*worker->work)(handle,
+							qtractor_lv2_worker_respond, this, req.size, buf);
+				}
 			}
+			// Response latency statistics...
+			const long long iNsecs = qtractor_lv2_worker_nsecs() - req.stamp;
+			m_iWorkNsecs += iNsecs;
+			if (m_iWorkNsecsMax < iNsecs)
+				m_iWorkNsecsMax = iNsecs;
+			++m_iWorkCount;
+			read_space -= sizeof(req) + req.size;
 		}
-		read_space -= sizeof(size) + size;
+		if (buf) ::free(buf);
+		ATOMIC_SET(&m_busy, 0);
+		// Anything left behind?
+		if (::jack_ringbuffer_read_space(m_pRequests) == 0)
+			break;
 	}
-
-	if (buf) ::free(buf);
-
-	m_bWaitSync = false;
 }
 
 #endif	// CONFIG_LV2_WORKER
@@ -896,6 +1107,9 @@ private:
 static LilvWorld   *g_lv2_world   = NULL;
 static LilvPlugins *g_lv2_plugins = NULL;
 
+// All LV2 plugins alive (world in use).
+static unsigned int g_lv2_plugin_refcount = 0;
+
 // Supported port classes.
 static LilvNode *g_lv2_input_class   = NULL;
 static LilvNode *g_lv2_output_class  = NULL;
@@ -1104,9 +1318,13 @@ static const void *qtractor_lv2_get_port_value ( const char *port_symbol,
 		unsigned long iIndex = lilv_port_get_index(plugin, port);
 		qtractorPluginParam *pParam = pLv2Plugin->findParam(iIndex);
 		if (pParam) {
+			// Current parameter value, never the port itself;
+			// the value gets copied right away by lilv anyway.
+			static float s_fValue = 0.0f;
+			s_fValue = pParam->value();
 			*size = sizeof(float);
 			*type = g_lv2_urids.atom_Float;
-			retv = (const void *) (pParam->subject())->data();
+			retv = (const void *) &s_fValue;
 		}
 	}
 
@@ -1576,6 +1794,9 @@ qtractorLv2PluginType *qtractorLv2PluginType::createType ( const QString& sUri )
 // Descriptor method (static)
 LilvPlugin *qtractorLv2PluginType::lv2_plugin ( const QString& sUri )
 {
+	// The world is only loaded on first need...
+	lv2_open();
+
 	if (g_lv2_plugins == NULL)
 		return NULL;
 
@@ -1974,11 +2195,22 @@ void qtractorLv2PluginType::lv2_close (void)
 }
 
 
+// Have the world reloaded on next need, if not in use (eg. rescan).
+void qtractorLv2PluginType::lv2_reload (void)
+{
+	if (g_lv2_plugin_refcount < 1)
+		lv2_close();
+}
+
+
 // Plugin URI listing (static).
 QStringList qtractorLv2PluginType::lv2_plugins (void)
 {
 	QStringList list;
 
+	// The world is only loaded on first need...
+	lv2_open();
+
 	if (g_lv2_plugins) {
 		LILV_FOREACH(plugins, iter, g_lv2_plugins) {
 			const LilvPlugin *plugin = lilv_plugins_get(g_lv2_plugins, iter);
@@ -1991,6 +2223,21 @@ QStringList qtractorLv2PluginType::lv2_plugins (void)
 }
 
 
+// Plugin bundle directory path (static).
+QString qtractorLv2PluginType::lv2_bundle_path ( const QString& sUri )
+{
+	const LilvPlugin *plugin = lv2_plugin(sUri);
+	if (plugin == NULL)
+		return QString();
+
+	const LilvNode *bundle_uri = lilv_plugin_get_bundle_uri(plugin);
+	if (bundle_uri == NULL)
+		return QString();
+
+	return QUrl(QString::fromUtf8(lilv_node_as_uri(bundle_uri))).toLocalFile();
+}
+
+
 #ifdef CONFIG_LV2_UI_SHOW
 
 // Check for LV2 UI Show interface.
@@ -2068,15 +2315,20 @@ const QString& qtractorLv2PluginType::aboutText (void)
 
 // Dynamic singleton list of LV2 plugins.
 static QList<qtractorLv2Plugin *> g_lv2Plugins;
-
 // Constructors.
 qtractorLv2Plugin::qtractorLv2Plugin ( qtractorPluginList *pList,
 	qtractorLv2PluginType *pLv2Type )
 	: qtractorPlugin(pList, pLv2Type)
 		, m_ppInstances(NULL)
+		, m_ppSwapInstances(NULL)
+		, m_ppSwapBuffers(NULL)
+		, m_iSwapChannels(0)
+		, m_swapMutex(QMutex::Recursive)
 		, m_piControlOuts(NULL)
 		, m_pfControlOuts(NULL)
 		, m_pfControlOutsLast(NULL)
+		, m_pfControlOutsEx(NULL)
+		, m_iLatencyOut(-1)
 		, m_piAudioIns(NULL)
 		, m_piAudioOuts(NULL)
 		, m_pfIDummy(NULL)
@@ -2157,6 +2409,11 @@ qtractorLv2Plugin::qtractorLv2Plugin ( qtractorPluginList *pList,
 		this, pLv2Type->filename().toUtf8().constData());
 #endif
 
+	++g_lv2_plugin_refcount;
+
+	ATOMIC_SET(&m_swapState, SwapNone);
+	ATOMIC_SET(&m_swapRetiring, 0);
+
 	int iFeatures = 0;
 	while (g_lv2_features[iFeatures]) { ++iFeatures; }
 
@@ -2342,6 +2599,9 @@ qtractorLv2Plugin::qtractorLv2Plugin ( qtractorPluginList *pList,
 					else
 				#endif
 					if (lilv_port_is_a(plugin, port, g_lv2_control_class)) {
+						if (lilv_plugin_has_latency(plugin) &&
+							lilv_plugin_get_latency_port_index(plugin) == i)
+							m_iLatencyOut = iControlOuts;
 						m_piControlOuts[iControlOuts] = i;
 						m_pfControlOuts[iControlOuts] = 0.0f;
 						m_pfControlOutsLast[iControlOuts] = 0.0f;
@@ -2501,6 +2761,10 @@ qtractorLv2Plugin::qtractorLv2Plugin ( qtractorPluginList *pList,
 // Destructor.
 qtractorLv2Plugin::~qtractorLv2Plugin (void)
 {
+	// No more spare instances, retired or not...
+	lv2_swap_cleanup();
+	lv2_swap_reclaim();
+
 	// Cleanup all plugin instances...
 	setChannels(0);
 
@@ -2579,6 +2843,8 @@ qtractorLv2Plugin::~qtractorLv2Plugin (void)
 		delete [] m_pfControlOuts;
 	if (m_pfControlOutsLast)
 		delete [] m_pfControlOutsLast;
+	if (m_pfControlOutsEx)
+		delete [] m_pfControlOutsEx;
 
 	if (m_pfIDummy)
 		delete [] m_pfIDummy;
@@ -2587,6 +2853,8 @@ qtractorLv2Plugin::~qtractorLv2Plugin (void)
 
 	if (m_lv2_features)
 		delete [] m_lv2_features;
+
+	--g_lv2_plugin_refcount;
 }
 
 
@@ -2616,6 +2884,10 @@ void qtractorLv2Plugin::setChannels ( unsigned short iChannels )
 	const bool bActivated = isActivated();
 	setActivated(false);
 
+	// Spare instances are of no use anymore...
+	lv2_swap_cleanup();
+	lv2_swap_reclaim();
+
 	// Set new instance number...
 	setInstances(iInstances);
 
@@ -2680,6 +2952,21 @@ void qtractorLv2Plugin::setChannels ( unsigned short iChannels )
 	//	::memset(m_pfODummy, 0, iBufferSize * sizeof(float));
 	}
 
+	// Extra instances get their own output control ports,
+	// as they might be run concurrently (parallel dispatch)...
+	const unsigned short iControlOuts = pLv2Type->controlOuts();
+
+	if (m_pfControlOutsEx) {
+		delete [] m_pfControlOutsEx;
+		m_pfControlOutsEx = NULL;
+	}
+
+	if (iInstances > 1 && iControlOuts > 0) {
+		const unsigned int iControlOutsEx = (iInstances - 1) * iControlOuts;
+		m_pfControlOutsEx = new float [iControlOutsEx];
+		::memset(m_pfControlOutsEx, 0, iControlOutsEx * sizeof(float));
+	}
+
 #ifdef CONFIG_LV2_WORKER
 	if (lilv_plugin_has_feature(plugin, g_lv2_worker_schedule_hint))
 		m_lv2_worker = new qtractorLv2Worker(this, m_lv2_features);
@@ -2691,58 +2978,12 @@ void qtractorLv2Plugin::setChannels ( unsigned short iChannels )
 		features = m_lv2_worker->lv2_features();
 #endif
 
-	// We'll need output control (not dummy anymore) port indexes...
-	const unsigned short iControlOuts = pLv2Type->controlOuts();
-
-	unsigned short i, j;
-
 	// Allocate new instances...
 	m_ppInstances = new LilvInstance * [iInstances];
-	for (i = 0; i < iInstances; ++i) {
+	for (unsigned short i = 0; i < iInstances; ++i) {
 		// Instantiate them properly first...
 		LilvInstance *instance
-			= lilv_plugin_instantiate(plugin, iSampleRate, features);
-		if (instance) {
-			// (Dis)connect all ports...
-			const unsigned long iNumPorts = lilv_plugin_get_num_ports(plugin);
-			for (unsigned long k = 0; k < iNumPorts; ++k)
-				lilv_instance_connect_port(instance, k, NULL);
-			// Connect all existing input control ports...
-			const qtractorPlugin::Params& params = qtractorPlugin::params();
-			qtractorPlugin::Params::ConstIterator param = params.constBegin();
-			const qtractorPlugin::Params::ConstIterator& param_end = params.constEnd();
-			for ( ; param != param_end; ++param) {
-				qtractorPluginParam *pParam = param.value();
-				lilv_instance_connect_port(instance,
-					pParam->index(), pParam->subject()->data());
-			}
-			// Connect all existing output control ports...
-			for (j = 0; j < iControlOuts; ++j) {
-				lilv_instance_connect_port(instance,
-					m_piControlOuts[j], &m_pfControlOuts[j]);
-			}
-			// Connect all dummy input ports...
-			if (m_pfIDummy) for (j = iChannels; j < iAudioIns; ++j) {
-				lilv_instance_connect_port(instance,
-					m_piAudioIns[j], m_pfIDummy); // dummy input port!
-			}
-			// Connect all dummy output ports...
-			if (m_pfODummy) for (j = iChannels; j < iAudioOuts; ++j) {
-				lilv_instance_connect_port(instance,
-					m_piAudioOuts[j], m_pfODummy); // dummy input port!
-			}
-		#if 0//def CONFIG_LV2_TIME
-			// Connect time-pos designated ports, if any...
-			QHash<unsigned long, int>::ConstIterator iter
-				= m_lv2_time_ports.constBegin();
-			const QHash<unsigned long, int>::ConstIterator& iter_end
-				= m_lv2_time_ports.constEnd();
-			for ( ; iter != iter_end; ++iter) {
-				lilv_instance_connect_port(instance,
-					iter.key(), &(g_lv2_time[iter.value()].data));
-			}
-		#endif
-		}
+			= lv2_instantiate(i, iChannels, iSampleRate, features);
 	#ifdef CONFIG_DEBUG
 		qDebug("qtractorLv2Plugin[%p]::setChannels(%u) instance[%u]=%p",
 			this, iChannels, i, instance);
@@ -2773,6 +3014,272 @@ void qtractorLv2Plugin::setChannels ( unsigned short iChannels )
 }
 
 
+// Create and connect a new plugin instance.
+LilvInstance *qtractorLv2Plugin::lv2_instantiate ( unsigned short iInstance,
+	unsigned short iChannels, unsigned int iSampleRate,
+	LV2_Feature **features )
+{
+	qtractorLv2PluginType *pLv2Type
+		= static_cast<qtractorLv2PluginType *> (type());
+	if (pLv2Type == NULL)
+		return NULL;
+
+	const LilvPlugin *plugin = pLv2Type->lv2_plugin();
+	if (plugin == NULL)
+		return NULL;
+
+	const unsigned short iControlOuts = pLv2Type->controlOuts();
+	const unsigned short iAudioIns = pLv2Type->audioIns();
+	const unsigned short iAudioOuts = pLv2Type->audioOuts();
+
+	unsigned short j;
+
+	LilvInstance *instance
+		= lilv_plugin_instantiate(plugin, iSampleRate, features);
+	if (instance) {
+		// (Dis)connect all ports...
+		const unsigned long iNumPorts = lilv_plugin_get_num_ports(plugin);
+		for (unsigned long k = 0; k < iNumPorts; ++k)
+			lilv_instance_connect_port(instance, k, NULL);
+		// Connect all existing input control ports...
+		const qtractorPlugin::Params& params = qtractorPlugin::params();
+		qtractorPlugin::Params::ConstIterator param = params.constBegin();
+		const qtractorPlugin::Params::ConstIterator& param_end = params.constEnd();
+		for ( ; param != param_end; ++param) {
+			qtractorPluginParam *pParam = param.value();
+			lilv_instance_connect_port(instance,
+				pParam->index(), pParam->data());
+		}
+		// Connect all existing output control ports...
+		float *pfControlOuts = m_pfControlOuts;
+		if (iInstance > 0 && m_pfControlOutsEx)
+			pfControlOuts = &m_pfControlOutsEx[(iInstance - 1) * iControlOuts];
+		for (j = 0; j < iControlOuts; ++j) {
+			lilv_instance_connect_port(instance,
+				m_piControlOuts[j], &pfControlOuts[j]);
+		}
+		// Connect all dummy input ports...
+		if (m_pfIDummy) for (j = iChannels; j < iAudioIns; ++j) {
+			lilv_instance_connect_port(instance,
+				m_piAudioIns[j], m_pfIDummy); // dummy input port!
+		}
+		// Connect all dummy output ports...
+		if (m_pfODummy) for (j = iChannels; j < iAudioOuts; ++j) {
+			lilv_instance_connect_port(instance,
+				m_piAudioOuts[j], m_pfODummy); // dummy input port!
+		}
+	#if 0//def CONFIG_LV2_TIME
+		// Connect time-pos designated ports, if any...
+		QHash<unsigned long, int>::ConstIterator iter
+			= m_lv2_time_ports.constBegin();
+		const QHash<unsigned long, int>::ConstIterator& iter_end
+			= m_lv2_time_ports.constEnd();
+		for ( ; iter != iter_end; ++iter) {
+			lilv_instance_connect_port(instance,
+				iter.key(), &(g_lv2_time[iter.value()].data));
+		}
+	#endif
+	}
+
+	return instance;
+}
+
+
+// Double-buffered (instant) preset/program switching:
+// prepare a spare set of instances (non real-time)...
+bool qtractorLv2Plugin::lv2_swap_prepare (void)
+{
+	QMutexLocker locker(&m_swapMutex);
+
+	// Get rid of any previous leftovers...
+	if (!lv2_swap_cleanup())
+		return false;
+
+	if (m_ppInstances == NULL || !isActivated())
+		return false;
+
+#ifdef CONFIG_LV2_UI
+	// An open UI may hold the current instance handle
+	// (instance-access), which would be gone on swap...
+	if (m_lv2_ui)
+		return false;
+#endif
+
+	qtractorOptions *pOptions = qtractorOptions::getInstance();
+	if (pOptions == NULL || !pOptions->bPluginInstantSwap)
+		return false;
+
+	qtractorLv2PluginType *pLv2Type
+		= static_cast<qtractorLv2PluginType *> (type());
+	if (pLv2Type == NULL)
+		return false;
+
+	// Plugins with a stateful worker or output events are
+	// better left switching in-place, the old fashion way...
+#ifdef CONFIG_LV2_WORKER
+	if (m_lv2_worker)
+		return false;
+#endif
+#ifdef CONFIG_LV2_EVENT
+	if (pLv2Type->eventOuts() > 0)
+		return false;
+#endif
+#ifdef CONFIG_LV2_ATOM
+	if (pLv2Type->atomOuts() > 0)
+		return false;
+#endif
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == NULL)
+		return false;
+
+	qtractorAudioEngine *pAudioEngine = pSession->audioEngine();
+	if (pAudioEngine == NULL)
+		return false;
+
+	const unsigned int iSampleRate = pAudioEngine->sampleRate();
+	const unsigned int iBufferSize = pAudioEngine->bufferSize();
+
+	const unsigned short iInstances = instances();
+	const unsigned short iChannels  = channels();
+
+	unsigned short i;
+
+	// Allocate the spare instances...
+	m_ppSwapInstances = new LilvInstance * [iInstances];
+	for (i = 0; i < iInstances; ++i) {
+		LilvInstance *instance
+			= lv2_instantiate(i, iChannels, iSampleRate, m_lv2_features);
+		if (instance)
+			lilv_instance_activate(instance);
+		m_ppSwapInstances[i] = instance;
+	}
+
+	// And the crossfade (retiring) output buffers...
+	m_ppSwapBuffers = new float * [iChannels];
+	for (i = 0; i < iChannels; ++i) {
+		m_ppSwapBuffers[i] = new float [iBufferSize];
+		::memset(m_ppSwapBuffers[i], 0, iBufferSize * sizeof(float));
+	}
+	m_iSwapChannels = iChannels;
+
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorLv2Plugin[%p]::lv2_swap_prepare() instances=%u",
+		this, iInstances);
+#endif
+
+	return true;
+}
+
+
+// ...have them swapped in on next cycle...
+void qtractorLv2Plugin::lv2_swap_commit (void)
+{
+	if (m_ppSwapInstances)
+		ATOMIC_SET(&m_swapState, SwapReady);
+}
+
+
+// ...and retire the used or pending ones, for later;
+// false if the real-time thread is still swapping.
+bool qtractorLv2Plugin::lv2_swap_cleanup (void)
+{
+	QMutexLocker locker(&m_swapMutex);
+
+	// Cancel any pending swap, if not already taken;
+	// never wait, nor touch anything, while it's still
+	// being swapped on the real-time thread...
+	if (!ATOMIC_CAS(&m_swapState, SwapReady, SwapNone)
+		&& !ATOMIC_CAS(&m_swapState, SwapDone, SwapNone)
+		&& ATOMIC_GET(&m_swapState) != SwapNone)
+		return false;
+
+	// Retire them, to be freed later on the main thread,
+	// as we might be on the MIDI thread here and now...
+	if (m_ppSwapInstances || m_ppSwapBuffers) {
+		SwapRetired retired;
+		retired.instances = m_ppSwapInstances;
+		retired.count     = instances();
+		retired.buffers   = m_ppSwapBuffers;
+		retired.channels  = m_iSwapChannels;
+		m_swapRetired.append(retired);
+		ATOMIC_SET(&m_swapRetiring, 1);
+		m_ppSwapInstances = NULL;
+		m_ppSwapBuffers = NULL;
+		m_iSwapChannels = 0;
+	}
+
+	return true;
+}
+
+
+// Let a pending swap be taken, then clean it up.
+void qtractorLv2Plugin::lv2_swap_settle (void)
+{
+	QMutexLocker locker(&m_swapMutex);
+
+	// Only ever called from the main thread (open editor),
+	// so just yield while the real-time thread is swapping,
+	// which is over within a single process cycle anyway...
+	while (!lv2_swap_cleanup())
+		QThread::yieldCurrentThread();
+}
+
+
+// Free all retired instances for good (main thread).
+void qtractorLv2Plugin::lv2_swap_reclaim ( bool bForce )
+{
+	if (!ATOMIC_GET(&m_swapRetiring))
+		return;
+
+	// Take whatever has been retired so far, though
+	// not blocking on spare instances being prepared...
+	if (bForce)
+		m_swapMutex.lock();
+	else
+	if (!m_swapMutex.tryLock())
+		return;
+
+	const QList<SwapRetired> retired_list = m_swapRetired;
+	m_swapRetired.clear();
+	ATOMIC_SET(&m_swapRetiring, 0);
+
+	m_swapMutex.unlock();
+
+	// Make sure no parallel instance is still running (stragglers)...
+	releaseInstancePool();
+
+	QListIterator<SwapRetired> iter(retired_list);
+	while (iter.hasNext()) {
+		const SwapRetired& retired = iter.next();
+		if (retired.instances) {
+			for (unsigned short i = 0; i < retired.count; ++i) {
+				LilvInstance *instance = retired.instances[i];
+				if (instance) {
+					lilv_instance_deactivate(instance);
+					lilv_instance_free(instance);
+				}
+			}
+			delete [] retired.instances;
+		}
+		if (retired.buffers) {
+			for (unsigned short i = 0; i < retired.channels; ++i)
+				delete [] retired.buffers[i];
+			delete [] retired.buffers;
+		}
+	}
+}
+
+
+// Free all retired spare instances (static).
+void qtractorLv2Plugin::reclaimSwapAll (void)
+{
+	QListIterator<qtractorLv2Plugin *> iter(g_lv2Plugins);
+	while (iter.hasNext())
+		iter.next()->lv2_swap_reclaim(false);
+}
+
+
 // Specific accessors.
 LilvPlugin *qtractorLv2Plugin::lv2_plugin (void) const
 {
@@ -2812,6 +3319,9 @@ void qtractorLv2Plugin::activate (void)
 // Do the actual deactivation.
 void qtractorLv2Plugin::deactivate (void)
 {
+	// Drop any pending (or retired) spare instances...
+	lv2_swap_cleanup();
+
 	if (m_ppInstances) {
 		const unsigned short iInstances = instances();
 		for (unsigned short i = 0; i < iInstances; ++i) {
@@ -2834,6 +3344,12 @@ void qtractorLv2Plugin::process (
 	if (plugin == NULL)
 		return;
 
+	// Spare instances ready to take over?
+	if (ATOMIC_CAS(&m_swapState, SwapReady, SwapBusy)) {
+		process_swap(ppIBuffer, ppOBuffer, nframes);
+		return;
+	}
+
 #if defined(CONFIG_LV2_EVENT) || defined(CONFIG_LV2_ATOM)
 	qtractorMidiManager *pMidiManager = NULL;
 	qtractorLv2PluginType *pLv2Type
@@ -2860,8 +3376,25 @@ void qtractorLv2Plugin::process (
 	unsigned short iOChannel = 0;
 	unsigned short i, j;
 
+	// Plain audio instances may be spread across worker threads...
+	bool bParallel = (iInstances > 1);
+#ifdef CONFIG_LV2_EVENT
+	if (iEventIns > 0 || iEventOuts > 0)
+		bParallel = false;
+#endif
+#ifdef CONFIG_LV2_ATOM
+	if (iAtomIns > 0 || iAtomOuts > 0)
+		bParallel = false;
+#endif
+#ifdef CONFIG_LV2_WORKER
+	if (m_lv2_worker)
+		bParallel = false;
+#endif
+	if (bParallel)
+		bParallel = processInstances(ppIBuffer, ppOBuffer, nframes);
+
 	// For each plugin instance...
-	for (i = 0; i < iInstances; ++i) {
+	for (i = 0; i < iInstances && !bParallel; ++i) {
 		LilvInstance *instance = m_ppInstances[i];
 		if (instance) {
 			// For each instance audio input port...
@@ -3032,6 +3565,100 @@ void qtractorLv2Plugin::process (
 }
 
 
+// Swap and crossfade executive (real-time).
+void qtractorLv2Plugin::process_swap (
+	float **ppIBuffer, float **ppOBuffer, unsigned int nframes )
+{
+	const unsigned short iChannels = channels();
+
+	// Let the retiring instances run one last time...
+	if (m_ppSwapBuffers && m_iSwapChannels == iChannels) {
+	#ifdef CONFIG_LV2_TIME_POSITION
+		const unsigned int iTimePositionChanged = m_lv2_time_position_changed;
+	#endif
+	#ifdef CONFIG_LV2_PATCH
+		const unsigned int iPatchChanged = m_lv2_patch_changed;
+	#endif
+		process(ppIBuffer, m_ppSwapBuffers, nframes);
+	#ifdef CONFIG_LV2_TIME_POSITION
+		m_lv2_time_position_changed = iTimePositionChanged;
+	#endif
+	#ifdef CONFIG_LV2_PATCH
+		m_lv2_patch_changed = iPatchChanged;
+	#endif
+	}
+
+	// Swap instances over...
+	LilvInstance **ppInstances = m_ppInstances;
+	m_ppInstances = m_ppSwapInstances;
+	m_ppSwapInstances = ppInstances;
+
+	// Have the fresh ones run as usual...
+	process(ppIBuffer, ppOBuffer, nframes);
+
+	// Crossfade from old to new, over the whole period...
+	if (m_ppSwapBuffers && m_iSwapChannels == iChannels && nframes > 0) {
+		const float fDelta = 1.0f / float(nframes);
+		for (unsigned short i = 0; i < iChannels; ++i) {
+			float *pOBuffer = ppOBuffer[i];
+			const float *pSwapBuffer = m_ppSwapBuffers[i];
+			float fGain = 0.0f;
+			for (unsigned int n = 0; n < nframes; ++n) {
+				pOBuffer[n] = fGain * pOBuffer[n]
+					+ (1.0f - fGain) * pSwapBuffer[n];
+				fGain += fDelta;
+			}
+		}
+	}
+
+	// Retired instances are now up for cleanup.
+	ATOMIC_SET(&m_swapState, SwapDone);
+}
+
+
+// Plugin latency (in frames), from the reported latency port.
+unsigned long qtractorLv2Plugin::latency (void) const
+{
+	if (m_iLatencyOut < 0 || m_pfControlOuts == NULL)
+		return 0;
+
+	const float fLatency = m_pfControlOuts[m_iLatencyOut];
+	return (fLatency > 0.0f ? (unsigned long) fLatency : 0);
+}
+
+
+// Single instance processing procedure (parallel dispatch).
+void qtractorLv2Plugin::processInstance ( unsigned short iInstance,
+	float **ppIBuffer, float **ppOBuffer, unsigned int nframes )
+{
+	LilvInstance *instance = m_ppInstances[iInstance];
+	if (instance == NULL)
+		return;
+
+	// Same channel crossing as if instances were run in sequence...
+	const unsigned short iChannels  = channels();
+	const unsigned short iAudioIns  = audioIns();
+	const unsigned short iAudioOuts = audioOuts();
+
+	unsigned short iIChannel = iInstance * iAudioIns;
+	unsigned short iOChannel = iInstance * iAudioOuts;
+	unsigned short j;
+
+	// For each instance audio input port...
+	for (j = 0; j < iAudioIns && iIChannel < iChannels; ++j) {
+		lilv_instance_connect_port(instance,
+			m_piAudioIns[j], ppIBuffer[iIChannel++]);
+	}
+	// For each instance audio output port...
+	for (j = 0; j < iAudioOuts && iOChannel < iChannels; ++j) {
+		lilv_instance_connect_port(instance,
+			m_piAudioOuts[j], ppOBuffer[iOChannel++]);
+	}
+	// Make it run...
+	lilv_instance_run(instance, nframes);
+}
+
+
 #ifdef CONFIG_LV2_UI
 
 // Open editor.
@@ -3047,6 +3674,11 @@ void qtractorLv2Plugin::openEditor ( QWidget */*pParent*/ )
 	if (pLv2Type == NULL)
 		return;
 
+	// No instant switching while the UI is open, as it may get
+	// the current instance handle (instance-access) to keep...
+	QMutexLocker locker(&m_swapMutex);
+	lv2_swap_settle();
+
 	// Check the UI inventory...
 	m_lv2_uis = lilv_plugin_get_uis(pLv2Type->lv2_plugin());
 	if (m_lv2_uis == NULL)
@@ -4476,18 +5108,29 @@ void qtractorLv2Plugin::selectProgram ( int iBank, int iProg )
 	qDebug("qtractorLv2Plugin[%p]::selectProgram(%d, %d)", this, iBank, iProg);
 #endif
 
+	// Select it on spare instances, if instant switching applies...
+	QMutexLocker locker(&m_swapMutex);
+	const bool bSwap = lv2_swap_prepare();
+	LilvInstance **ppInstances = (bSwap ? m_ppSwapInstances : m_ppInstances);
+
 	// For each plugin instance...
 	const unsigned short iInstances = instances();
-	for (unsigned short i = 0; i < iInstances; ++i) {
+	for (unsigned short i = 0; i < iInstances && ppInstances; ++i) {
 		const LV2_Programs_Interface *programs = lv2_programs_descriptor(i);
 		if (programs && programs->select_program) {
-			LV2_Handle handle = lv2_handle(i);
+			LV2_Handle handle = (ppInstances[i]
+				? lilv_instance_get_handle(ppInstances[i]) : NULL);
 			if (handle) {
 				(*programs->select_program)(handle, iBank, iProg);
 			}
 		}
 	}
 
+	if (bSwap)
+		lv2_swap_commit();
+
+	locker.unlock();
+
 #ifdef CONFIG_LV2_UI
 	const LV2_Programs_UI_Interface *ui_programs
 		= (const LV2_Programs_UI_Interface *)
@@ -4761,12 +5404,22 @@ bool qtractorLv2Plugin::loadPreset ( const QString& sPreset )
 		return false;
 	}
 
+	// Restore it on spare instances, if instant switching applies...
+	QMutexLocker locker(&m_swapMutex);
+	const bool bSwap = lv2_swap_prepare();
+	LilvInstance **ppInstances = (bSwap ? m_ppSwapInstances : m_ppInstances);
+
 	const unsigned short iInstances = instances();
-	for (unsigned short i = 0; i < iInstances; ++i) {
-		lilv_state_restore(state, m_ppInstances[i],
+	for (unsigned short i = 0; i < iInstances && ppInstances; ++i) {
+		lilv_state_restore(state, ppInstances[i],
 			qtractor_lv2_set_port_value, this, 0, m_lv2_features);
 	}
 
+	if (bSwap)
+		lv2_swap_commit();
+
+	locker.unlock();
+
 	lilv_state_free(state);
 	lilv_node_free(preset_uri);
 
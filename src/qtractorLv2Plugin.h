@@ -105,6 +105,8 @@ class qtractorLv2Worker;
 #include <QVariant>
 #endif
 
+#include <QMutex>
+
 
 //----------------------------------------------------------------------------
 // qtractorLv2PluginType -- LV2 plugin type instance.
@@ -141,13 +143,17 @@ public:
 	LilvPlugin *lv2_plugin() const
 		{ return m_lv2_plugin; }
 
-	// LV2 World stuff (ref. counted).
+	// LV2 World stuff (ref. counted, loaded on first need).
 	static void lv2_open();
 	static void lv2_close();
+	static void lv2_reload();
 
 	// Plugin type (URI) listing (static).
 	static QStringList lv2_plugins();
 
+	// Plugin bundle directory path (static).
+	static QString lv2_bundle_path(const QString& sUri);
+
 #ifdef CONFIG_LV2_EVENT
 	unsigned short eventIns()   const { return m_iEventIns;   }
 	unsigned short eventOuts()  const { return m_iEventOuts;  }
@@ -209,6 +215,9 @@ public:
 	// The main plugin processing procedure.
 	void process(float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
 
+	// Plugin latency (in frames), from the reported latency port.
+	unsigned long latency() const;
+
 	// Specific accessors.
 	LilvPlugin *lv2_plugin() const;
 	LilvInstance *lv2_instance(unsigned short iInstance) const;
@@ -221,6 +230,9 @@ public:
 	unsigned long audioOut(unsigned short i)
 		{ return m_piAudioOuts[i]; }
 
+	// Free all retired spare instances (static).
+	static void reclaimSwapAll();
+
 #ifdef CONFIG_LV2_UI
 
 	// GUI Editor stuff.
@@ -437,16 +449,73 @@ protected:
 	void lv2_patch_properties(const char *pszPatch);
 #endif
 
+protected:
+
+	// Single instance processing procedure (parallel dispatch).
+	void processInstance(unsigned short iInstance,
+		float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
+
+	// Create and connect a new plugin instance.
+	LilvInstance *lv2_instantiate(unsigned short iInstance,
+		unsigned short iChannels, unsigned int iSampleRate,
+		LV2_Feature **features);
+
+	// Double-buffered (instant) preset/program switching:
+	// prepare a spare set of instances (non real-time)...
+	bool lv2_swap_prepare();
+	// ...have them swapped in on next cycle...
+	void lv2_swap_commit();
+	// ...and retire the used or pending ones, for later;
+	// false if the real-time thread is still swapping.
+	bool lv2_swap_cleanup();
+	// Let a pending swap be taken, then clean it up.
+	void lv2_swap_settle();
+	// Free all retired instances for good (main thread).
+	void lv2_swap_reclaim(bool bForce = true);
+
+	// Swap and crossfade executive (real-time).
+	void process_swap(
+		float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
+
 private:
 
 	// Instance variables.
 	LilvInstance **m_ppInstances;
 
+	// Double-buffered (spare) instances and crossfade buffers.
+	enum SwapState { SwapNone = 0, SwapReady, SwapBusy, SwapDone };
+
+	LilvInstance **m_ppSwapInstances;
+	float        **m_ppSwapBuffers;
+	unsigned short m_iSwapChannels;
+	qtractorAtomic m_swapState;
+
+	// Retired instances and crossfade buffers, freed later.
+	struct SwapRetired
+	{
+		LilvInstance **instances;
+		unsigned short count;
+		float        **buffers;
+		unsigned short channels;
+	};
+
+	QList<SwapRetired> m_swapRetired;
+	qtractorAtomic     m_swapRetiring;
+
+	// Serializes preparation, commit and cleanup (non real-time).
+	QMutex         m_swapMutex;
+
 	// List of output control port indexes and data.
 	unsigned long *m_piControlOuts;
 	float         *m_pfControlOuts;
 	float         *m_pfControlOutsLast;
 
+	// Output control port data of any extra instances.
+	float         *m_pfControlOutsEx;
+
+	// Latency output control port (index into the above).
+	int m_iLatencyOut;
+
 	// List of audio port indexes.
 	unsigned long *m_piAudioIns;
 	unsigned long *m_piAudioOuts;
@@ -39,6 +39,7 @@
 
 #include "qtractorAudioPeak.h"
 #include "qtractorAudioBuffer.h"
+#include "qtractorAudioDelay.h"
 #include "qtractorAudioEngine.h"
 #include "qtractorMidiEngine.h"
 
@@ -77,6 +78,7 @@
 
 #include "qtractorTrackCommand.h"
 #include "qtractorCurveCommand.h"
+#include "qtractorCurveFile.h"
 
 #include "qtractorMessageList.h"
 
@@ -124,6 +126,7 @@
 #include <QProgressBar>
 
 #include <QColorDialog>
+#include <QInputDialog>
 
 #include <QContextMenuEvent>
 #include <QDragEnterEvent>
@@ -870,6 +873,9 @@ qtractorMainForm::qtractorMainForm (
 	QObject::connect(m_ui.trackCurveCaptureAction,
 		SIGNAL(triggered(bool)),
 		SLOT(trackCurveCapture(bool)));
+	QObject::connect(m_ui.trackCurveSimplifyAction,
+		SIGNAL(triggered(bool)),
+		SLOT(trackCurveSimplify()));
 	QObject::connect(m_ui.trackCurveClearAction,
 		SIGNAL(triggered(bool)),
 		SLOT(trackCurveClear()));
@@ -1417,6 +1423,13 @@ void qtractorMainForm::setup ( qtractorOptions *pOptions )
 	qtractorAudioBuffer::setResampleType(m_pOptions->iAudioResampleType);
 	qtractorAudioBuffer::setWsolaTimeStretch(m_pOptions->bAudioWsolaTimeStretch);
 	qtractorAudioBuffer::setWsolaQuickSeek(m_pOptions->bAudioWsolaQuickSeek);
+	// Set plugin output guard stage mode...
+	qtractorPluginList::setGuardEnabled(m_pOptions->bPluginGuard);
+	// Set undo/redo history memory limit...
+	m_pSession->commands()->setMaxSize(
+		(unsigned long) m_pOptions->iUndoMaxSize << 20);
+	// Set automation curve file format...
+	qtractorCurveFile::setBinaryFormat(m_pOptions->bSaveCurveBinary);
 
 	// Load (action) keyboard shortcuts...
 	m_pOptions->loadActionShortcuts(this);
@@ -1805,12 +1818,6 @@ bool qtractorMainForm::newSession (void)
 	if (!closeSession())
 		return false;
 
-#ifdef CONFIG_LV2
-	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-	qtractorLv2PluginType::lv2_open();
-	QApplication::restoreOverrideCursor();
-#endif
-
 	// We're supposedly clean...
 	m_iDirtyCount = 0;
 
@@ -2266,11 +2273,6 @@ bool qtractorMainForm::loadSessionFileEx (
 				#endif
 					// Restarting...
 					if (!bArchiveRemove) {
-					#ifdef CONFIG_LV2
-						QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-						qtractorLv2PluginType::lv2_open();
-						QApplication::restoreOverrideCursor();
-					#endif
 						updateSessionPre();
 						++m_iUntitled;
 						m_sFilename.clear();
@@ -2286,12 +2288,6 @@ bool qtractorMainForm::loadSessionFileEx (
 	// Tell the world we'll take some time...
 	appendMessages(tr("Opening \"%1\"...").arg(sFilename));
 
-#ifdef CONFIG_LV2
-	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-	qtractorLv2PluginType::lv2_open();
-	QApplication::restoreOverrideCursor();
-#endif
-
 	// Warm-up the session engines...
 	updateSessionPre();
 
@@ -2352,6 +2348,16 @@ bool qtractorMainForm::loadSessionFileEx (
 
 	appendMessages(tr("Open session: \"%1\".").arg(sessionName(sFilename)));
 
+	// Report load stage timings...
+	if (bLoadSessionFileEx) {
+		const qtractorSession::LoadTimes& times = m_pSession->loadTimes();
+		appendMessages(
+			tr("Session load: setup %1, tracks %2, commit %3 msecs "
+			"(%4 files pre-fetched in background).")
+			.arg(times.setup).arg(times.tracks).arg(times.commit)
+			.arg(times.files));
+	}
+
 	// Now we'll try to create (update) the whole GUI session.
 	updateSessionPost();
 
@@ -2416,22 +2422,7 @@ bool qtractorMainForm::saveSessionFileEx (
 	appendMessages(tr("Saving \"%1\"...").arg(sFilename));
 	
 	// Trap dirty clips (only MIDI at this time...)
-	for (qtractorTrack *pTrack = m_pSession->tracks().first();
-			pTrack; pTrack = pTrack->next()) {
-		// Only MIDI track/clips...
-		if (pTrack->trackType() != qtractorTrack::Midi)
-			continue;
-		for (qtractorClip *pClip = pTrack->clips().first();
-				pClip; pClip = pClip->next()) {
-			// Are any dirty changes pending commit?
-			if (pClip->isDirty()) {
-				qtractorMidiClip *pMidiClip
-					= static_cast<qtractorMidiClip *> (pClip);
-				if (pMidiClip)
-					pMidiClip->saveCopyFile(bUpdate);
-			}
-		}
-	}
+	saveDirtyClips(bUpdate);
 
 	// Soft-house-keeping...
 	m_pSession->files()->cleanup(false);
@@ -2495,6 +2486,28 @@ bool qtractorMainForm::saveSessionFileEx (
 }
 
 
+// Commit dirty clips to new file revisions (only MIDI at this time...)
+void qtractorMainForm::saveDirtyClips ( bool bUpdate )
+{
+	for (qtractorTrack *pTrack = m_pSession->tracks().first();
+			pTrack; pTrack = pTrack->next()) {
+		// Only MIDI track/clips...
+		if (pTrack->trackType() != qtractorTrack::Midi)
+			continue;
+		for (qtractorClip *pClip = pTrack->clips().first();
+				pClip; pClip = pClip->next()) {
+			// Are any dirty changes pending commit?
+			if (pClip->isDirty()) {
+				qtractorMidiClip *pMidiClip
+					= static_cast<qtractorMidiClip *> (pClip);
+				if (pMidiClip)
+					pMidiClip->saveCopyFile(bUpdate);
+			}
+		}
+	}
+}
+
+
 bool qtractorMainForm::saveSessionFile ( const QString& sFilename )
 {
 	return saveSessionFileEx(sFilename, false, true);
@@ -2579,11 +2592,6 @@ void qtractorMainForm::openNsmSession (void)
 			if (bLoaded) m_sNsmFile = sFilename;
 		} else {
 			updateSessionPre();
-		#ifdef CONFIG_LV2
-			QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-			qtractorLv2PluginType::lv2_open();
-			QApplication::restoreOverrideCursor();
-		#endif
 			appendMessages(tr("New session: \"%1\".")
 				.arg(sessionName(sFilename)));
 			updateSessionPost();
@@ -2742,6 +2750,18 @@ void qtractorMainForm::autoSaveSession (void)
 		qtractorSession::sanitize(sAutoSaveName)).filePath()
 		+ ".auto-save." + qtractorDocument::defaultExt();
 
+	// Previous auto-save still being written? Try again later...
+	if (qtractorDocument::isSnapshotBusy())
+		return;
+
+	// Last one has failed somehow?
+	if (!qtractorDocument::waitSnapshot()) {
+		appendMessagesError(
+			tr("Session could not be auto-saved\n"
+			"to \"%1\".\n\n"
+			"Sorry.").arg(m_pOptions->sAutoSavePathname));
+	}
+
 	const QString& sOldAutoSavePathname = m_pOptions->sAutoSavePathname;
 
 	if (!sOldAutoSavePathname.isEmpty()
@@ -2754,7 +2774,17 @@ void qtractorMainForm::autoSaveSession (void)
 		sAutoSavePathname.toUtf8().constData());
 #endif
 
-	if (saveSessionFileEx(sAutoSavePathname, false, false)) {
+	// Dirty clips are still committed in the foreground...
+	saveDirtyClips(false);
+
+	// Soft-house-keeping...
+	m_pSession->files()->cleanup(false);
+
+	// Take a snapshot of the current session state,
+	// to be written out in the background...
+	QDomDocument doc("qtractorSession");
+	if (qtractorSessionDocument(&doc, m_pSession, m_pFiles)
+			.saveSnapshot(sAutoSavePathname)) {
 		m_pOptions->sAutoSavePathname = sAutoSavePathname;
 		m_pOptions->sAutoSaveFilename = m_sFilename;
 		m_pOptions->saveOptions();
@@ -2799,6 +2829,9 @@ bool qtractorMainForm::autoSaveOpen (void)
 // Auto-save/crash-recovery cleanup.
 void qtractorMainForm::autoSaveClose (void)
 {
+	// Make sure no background auto-save is left behind...
+	qtractorDocument::waitSnapshot();
+
 	const QString& sAutoSavePathname = m_pOptions->sAutoSavePathname;
 
 #ifdef CONFIG_DEBUG_0
@@ -3938,6 +3971,50 @@ void qtractorMainForm::trackCurveClear (void)
 }
 
 
+// Track automation curve simplify (node thinning).
+void qtractorMainForm::trackCurveSimplify (void)
+{
+	qtractorTrack *pTrack = NULL;
+	if (m_pTracks)
+		pTrack = m_pTracks->currentTrack();
+	if (pTrack == NULL)
+		return;
+
+	qtractorCurve *pCurrentCurve = pTrack->currentCurve();
+	if (pCurrentCurve == NULL)
+		return;
+
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorMainForm::trackCurveSimplify()");
+#endif
+
+	// Thinning is off by default (zero tolerance)...
+	float fTolerance = pCurrentCurve->tolerance();
+	if (fTolerance <= 0.0f)
+		fTolerance = 0.005f;
+
+	bool bOk = false;
+	const QString& sTitle = pCurrentCurve->subject()->name();
+	fTolerance = 0.01f * QInputDialog::getDouble(this,
+		sTitle + " - " QTRACTOR_TITLE, tr("Tolerance (%):"),
+		100.0 * fTolerance, 0.0, 50.0, 2, &bOk);
+	if (!bOk)
+		return;
+
+	qtractorCurveSimplifyCommand *pCurveCommand
+		= new qtractorCurveSimplifyCommand(pCurrentCurve, fTolerance);
+
+	// Nothing to remove? just take the tolerance as is...
+	if (pCurveCommand->isEmpty()) {
+		delete pCurveCommand;
+		pCurrentCurve->setTolerance(fTolerance);
+		return;
+	}
+
+	m_pSession->execute(pCurveCommand);
+}
+
+
 // Track automation all curves lock toggle.
 void qtractorMainForm::trackCurveLockedAll ( bool bOn )
 {
@@ -4917,6 +4994,13 @@ void qtractorMainForm::viewOptions (void)
 			m_pOptions->bAudioOutputBus);
 		qtractorMidiManager::setDefaultAudioOutputAutoConnect(
 			m_pOptions->bAudioOutputAutoConnect);
+		// Set plugin output guard stage mode...
+		qtractorPluginList::setGuardEnabled(m_pOptions->bPluginGuard);
+		// Set undo/redo history memory limit...
+		m_pSession->commands()->setMaxSize(
+			(unsigned long) m_pOptions->iUndoMaxSize << 20);
+		// Set automation curve file format...
+		qtractorCurveFile::setBinaryFormat(m_pOptions->bSaveCurveBinary);
 		// Auto time-stretching, loop-recording global modes...
 		if (m_pSession) {
 			m_pSession->setAutoTimeStretch(m_pOptions->bAudioAutoTimeStretch);
@@ -6567,6 +6651,7 @@ void qtractorMainForm::updateCurveMenu (void)
 	m_ui.trackCurveCaptureAction->setChecked(
 		pCurrentCurve && pCurrentCurve->isCapture());
 
+	m_ui.trackCurveSimplifyAction->setEnabled(bCurveEnabled);
 	m_ui.trackCurveClearAction->setEnabled(bCurveEnabled);
 
 	m_ui.trackCurveLockedAllAction->setEnabled(bEnabled);
@@ -7229,6 +7314,35 @@ void qtractorMainForm::timerSlot (void)
 		m_pTracks->trackView()->updateContents();
 	}
 
+	// Adopt any dormant plugins woken up in the background...
+	qtractorPlugin::updateWakeUps();
+
+	// Check whether some plugin output went astray...
+	qtractorPlugin *pGuardPlugin = qtractorPluginList::guardReport();
+	while (pGuardPlugin) {
+		qtractorPluginList *pGuardList = pGuardPlugin->list();
+		appendMessagesColor(
+			tr("Plugin \"%1\" on \"%2\": NaN/Inf output muted (%3 times).")
+			.arg((pGuardPlugin->type())->name())
+			.arg(pGuardList ? pGuardList->name() : QString())
+			.arg(pGuardPlugin->guardCount()), "#cc0033");
+		pGuardPlugin = qtractorPluginList::guardReport();
+	}
+
+	// Check whether latency compensation fell short...
+	const unsigned long iClampedDelay = qtractorAudioDelay::clampReport();
+	if (iClampedDelay > 0) {
+		appendMessagesColor(
+			tr("Latency compensation: %1 frames delay exceeds "
+			"the maximum of %2 frames; paths are misaligned.")
+			.arg(iClampedDelay).arg(int(qtractorAudioDelay::MaxDelay) - 1),
+			"#cc0033");
+	}
+
+	// Have JACK recompute latencies, if compensation has changed...
+	if (!pAudioEngine->isFreewheel())
+		pAudioEngine->updateLatencyRange();
+
 	// Check if we've got some XRUN callbacks...
 	if ( m_iXrunTimer  > 0 &&
 		(m_iXrunTimer -= QTRACTOR_TIMER_MSECS) < 0) {
@@ -7302,6 +7416,8 @@ void qtractorMainForm::timerSlot (void)
 	qtractorSubject::flushQueue(true);
 
 #ifdef CONFIG_LV2
+	// Free any retired plugin LV2 spare instances...
+	qtractorLv2Plugin::reclaimSwapAll();
 #ifdef CONFIG_LV2_TIME
 	// Update plugin LV2 Time designated ports, if any...
 	qtractorLv2Plugin::updateTimePost();
@@ -190,6 +190,7 @@ public slots:
 	void trackCurveLogarithmic(bool bOn);
 	void trackCurveColor();
 	void trackCurveClear();
+	void trackCurveSimplify();
 	void trackCurveProcessAll(bool bOn);
 	void trackCurveCaptureAll(bool bOn);
 	void trackCurveLockedAll(bool bOn);
@@ -373,6 +374,8 @@ protected:
 		const QString& sFilename, bool bTemplate, bool bUpdate);
 	bool saveSessionFile(const QString& sFilename);
 
+	void saveDirtyClips(bool bUpdate);
+
 	QString sessionBackupPath(const QString& sFilename);
 
 	bool startSession();
@@ -702,6 +702,12 @@ void qtractorMidiControlObserverForm::addMidiControlMenu (
 
 	pMenu->addSeparator();
 
+	pAction = pMenu->addAction(tr("Si&mplify..."));
+	pAction->setEnabled(pCurve != NULL);
+	QObject::connect(
+		pAction, SIGNAL(triggered(bool)),
+		pMainForm, SLOT(trackCurveSimplify()));
+
 	pAction = pMenu->addAction(tr("&Clear"));
 	pAction->setEnabled(pCurve != NULL);
 	QObject::connect(
@@ -52,27 +52,39 @@ qtractorMidiEditCommand::~qtractorMidiEditCommand (void)
 
 	qDeleteAll(m_items);
 	m_items.clear();
+	m_events.clear();
+}
+
+
+// Primitive command item appender.
+void qtractorMidiEditCommand::addItem ( CommandType cmd,
+	qtractorMidiEvent *pEvent, int iNote, unsigned long iTime,
+	unsigned long iDuration, int iValue )
+{
+	m_items.append(new Item(cmd, pEvent, iNote, iTime, iDuration, iValue));
+
+	m_events[pEvent] |= (1 << int(cmd));
 }
 
 
 // Primitive command methods.
 void qtractorMidiEditCommand::insertEvent ( qtractorMidiEvent *pEvent )
 {
-	m_items.append(new Item(InsertEvent, pEvent));
+	addItem(InsertEvent, pEvent);
 }
 
 
 void qtractorMidiEditCommand::moveEvent ( qtractorMidiEvent *pEvent,
 	int iNote, unsigned long iTime )
 {
-	m_items.append(new Item(MoveEvent, pEvent, iNote, iTime));
+	addItem(MoveEvent, pEvent, iNote, iTime);
 }
 
 
 void qtractorMidiEditCommand::resizeEventTime ( qtractorMidiEvent *pEvent,
 	unsigned long iTime, unsigned long iDuration )
 {
-	m_items.append(new Item(ResizeEventTime, pEvent, 0, iTime, iDuration));
+	addItem(ResizeEventTime, pEvent, 0, iTime, iDuration);
 }
 
 
@@ -82,13 +94,13 @@ void qtractorMidiEditCommand::resizeEventValue ( qtractorMidiEvent *pEvent,
 	if (pEvent->type() == qtractorMidiEvent::NOTEON && iValue < 1)
 		iValue = 1;	// Avoid zero velocity (aka. NOTEOFF)
 
-	m_items.append(new Item(ResizeEventValue, pEvent, 0, 0, 0, iValue));
+	addItem(ResizeEventValue, pEvent, 0, 0, 0, iValue);
 }
 
 
 void qtractorMidiEditCommand::removeEvent ( qtractorMidiEvent *pEvent )
 {
-	m_items.append(new Item(RemoveEvent, pEvent));
+	addItem(RemoveEvent, pEvent);
 }
 
 
@@ -96,14 +108,8 @@ void qtractorMidiEditCommand::removeEvent ( qtractorMidiEvent *pEvent )
 bool qtractorMidiEditCommand::findEvent ( qtractorMidiEvent *pEvent,
 	qtractorMidiEditCommand::CommandType cmd ) const
 {
-	QListIterator<Item *> iter(m_items);
-	while (iter.hasNext()) {
-		Item *pItem = iter.next();
-		if (pItem->event == pEvent
-			&& (pItem->command == InsertEvent || pItem->command == cmd))
-			return true;
-	}
-	return false;
+	const unsigned int iFlags = m_events.value(pEvent, 0);
+	return (iFlags & ((1 << int(InsertEvent)) | (1 << int(cmd))));
 }
 
 
@@ -130,6 +136,10 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 	const unsigned long iOldDuration = pSeq->duration();
 	int iSelectClear = 0;
 
+	// Large batches get their (re)timed events changed in place
+	// and the whole sequence sorted only once in the end...
+	const bool bBatch = (m_items.count() > BatchThreshold);
+
 	// Changes are due...
 	QListIterator<Item *> iter(m_items);
 	if (!bRedo)
@@ -151,10 +161,12 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 		case MoveEvent: {
 			const int iOldNote = int(pEvent->note());
 			const unsigned long iOldTime = pEvent->time();
-			pSeq->unlinkEvent(pEvent);
+			if (!bBatch)
+				pSeq->unlinkEvent(pEvent);
 			pEvent->setNote(pItem->note);
 			pEvent->setTime(pItem->time);
-			pSeq->insertEvent(pEvent);
+			if (!bBatch)
+				pSeq->insertEvent(pEvent);
 			pItem->note = iOldNote;
 			pItem->time = iOldTime;
 			break;
@@ -162,11 +174,13 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 		case ResizeEventTime: {
 			const unsigned long iOldTime = pEvent->time();
 			const unsigned long iOldDuration = pEvent->duration();
-			pSeq->unlinkEvent(pEvent);
+			if (!bBatch)
+				pSeq->unlinkEvent(pEvent);
 			pEvent->setTime(pItem->time);
 			if (pEvent->type() == qtractorMidiEvent::NOTEON)
 				pEvent->setDuration(pItem->duration);
-			pSeq->insertEvent(pEvent);
+			if (!bBatch)
+				pSeq->insertEvent(pEvent);
 			pItem->time = iOldTime;
 			pItem->duration = iOldDuration;
 			break;
@@ -197,6 +211,20 @@ bool qtractorMidiEditCommand::execute ( bool bRedo )
 		}
 	}
 
+	// Put it all back in order, once: sort a copy first,
+	// then swap it in while MIDI output is being held back...
+	if (bBatch) {
+		QVector<qtractorMidiEvent *> events;
+		pSeq->sortEvents(events);
+		qtractorMidiEngine *pMidiEngine
+			= (pSession ? pSession->midiEngine() : NULL);
+		if (pMidiEngine)
+			pMidiEngine->lockOutput();
+		pSeq->replaceEvents(events);
+		if (pMidiEngine)
+			pMidiEngine->unlockOutput();
+	}
+
 	// It's dirty, definitely...
 	m_pMidiClip->setDirtyEx(true);
 
@@ -380,4 +408,13 @@ bool qtractorMidiEditCommand::undo (void)
 }
 
 
+// Approximate memory footprint: each item may hold on to its own event.
+unsigned long qtractorMidiEditCommand::size (void) const
+{
+	return qtractorCommand::size()
+		+ m_items.count() * (sizeof(Item) + sizeof(qtractorMidiEvent))
+		+ m_events.count() * (sizeof(qtractorMidiEvent *) + sizeof(unsigned int));
+}
+
+
 // end of qtractorMidiEditCommand.cpp
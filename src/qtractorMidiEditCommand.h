@@ -27,6 +27,7 @@
 #include "qtractorMidiEvent.h"
 
 #include <QList>
+#include <QHash>
 
 
 // Forward declarations.
@@ -50,6 +51,9 @@ public:
 	// Sequence accessor.
 	qtractorMidiClip *midiClip() const { return m_pMidiClip; }
 
+	// Item count above which execution is batched.
+	enum { BatchThreshold = 64 };
+
 	// Primitive command types.
 	enum CommandType {
 		InsertEvent,
@@ -75,6 +79,9 @@ public:
 	bool redo();
 	bool undo();
 
+	// Approximate memory footprint.
+	unsigned long size() const;
+
 	// Adjust edit-command result to prevent event overlapping.
 	bool adjust();
 
@@ -83,6 +90,11 @@ protected:
 	// Common executive method.
 	bool execute(bool bRedo);
 
+	// Primitive command item appender.
+	void addItem(CommandType cmd, qtractorMidiEvent *pEvent,
+		int iNote = 0, unsigned long iTime = 0,
+		unsigned long iDuration = 0, int iValue = 0);
+
 private:
 
 	// Event item struct.
@@ -110,6 +122,9 @@ private:
 
 	QList<Item *> m_items;
 
+	// Event to command-type flags index (for findEvent).
+	QHash<qtractorMidiEvent *, unsigned int> m_events;
+
 	bool m_bAdjusted;
 
 	unsigned long m_iDuration;
@@ -167,6 +167,10 @@ public:
 	// MIDI output flush/drain (locked).
 	void flushSync();
 
+	// MIDI output process cycle hold back (lock/unlock).
+	void lock()   { m_mutex.lock();   }
+	void unlock() { m_mutex.unlock(); }
+
 	// Wake from executive wait condition.
 	void sync();
 
@@ -576,6 +580,13 @@ void qtractorMidiOutputThread::process (void)
 	// Free overriden SysEx queued events.
 	m_pMidiEngine->clearSysexCache();
 
+	// Drain all MIDI tracks record buffers, in one go...
+	qtractorTrack *pTrack = pSession->tracks().first();
+	for ( ; pTrack; pTrack = pTrack->next()) {
+		if (pTrack->trackType() == qtractorTrack::Midi)
+			pTrack->drainRecord();
+	}
+
 	// Now for the next readahead bunch...
 	unsigned long iFrameStart = pMidiCursor->frame();
 	unsigned long iFrameEnd   = iFrameStart + m_iReadAhead;
@@ -1805,13 +1816,15 @@ void qtractorMidiEngine::capture ( snd_seq_event_t *pEv )
 						if (type != qtractorMidiEvent::NOTEOFF)
 							pSeq = NULL;
 					}
-					// Yep, maybe we have a new MIDI event on record...
+					// Yep, maybe we have a new MIDI event on record;
+					// get it buffered, to be drained in batch by the
+					// MIDI output thread into the clip sequence...
 					if (pSeq) {
 						qtractorMidiEvent *pEvent = new qtractorMidiEvent(
 							tick, type, param, value, duration);
 						if (pSysex)
 							pEvent->setSysex(pSysex, iSysex);
-						pSeq->addEvent(pEvent);
+						pTrack->recordEvent(pMidiClip, pEvent);
 					}
 				}
 				// Track input monitoring...
@@ -1837,12 +1850,12 @@ void qtractorMidiEngine::capture ( snd_seq_event_t *pEv )
 						// Do it for the MIDI plugins too...
 						pMidiManager = (pTrack->pluginList())->midiManager();
 						if (pMidiManager)
-							pMidiManager->queued(pEv, t1); //..t2
+							pMidiManager->captured(pEv, t1);
 						if (!pMidiBus->isMonitor()
 							&& pMidiBus->pluginList_out()) {
 							pMidiManager = (pMidiBus->pluginList_out())->midiManager();
 							if (pMidiManager)
-								pMidiManager->queued(pEv, t1); //..t2
+								pMidiManager->captured(pEv, t1);
 						}
 						// FIXME: MIDI-thru channel filtering epilog...
 						pEv->data.note.channel = iOldChannel;
@@ -1862,7 +1875,7 @@ void qtractorMidiEngine::capture ( snd_seq_event_t *pEv )
 		if (pMidiBus->pluginList_in()) {
 			pMidiManager = (pMidiBus->pluginList_in())->midiManager();
 			if (pMidiManager)
-				pMidiManager->queued(pEv, t1); //..t2
+				pMidiManager->captured(pEv, t1);
 		}
 		// Output monitoring on passthru...
 		if (pMidiBus->isMonitor()) {
@@ -1870,7 +1883,7 @@ void qtractorMidiEngine::capture ( snd_seq_event_t *pEv )
 			if (pMidiBus->pluginList_out()) {
 				pMidiManager = (pMidiBus->pluginList_out())->midiManager();
 				if (pMidiManager)
-					pMidiManager->queued(pEv, t1); //..t2
+					pMidiManager->captured(pEv, t1);
 			}
 			if (pMidiBus->midiMonitor_out()) {
 				// MIDI-thru: same event redirected...
@@ -2225,6 +2238,20 @@ void qtractorMidiEngine::flush (void)
 }
 
 
+// Hold back MIDI output process cycles (eg. sequence re-ordering)...
+void qtractorMidiEngine::lockOutput (void)
+{
+	if (m_pOutputThread)
+		m_pOutputThread->lock();
+}
+
+void qtractorMidiEngine::unlockOutput (void)
+{
+	if (m_pOutputThread)
+		m_pOutputThread->unlock();
+}
+
+
 // Device engine initialization method.
 bool qtractorMidiEngine::init (void)
 {
@@ -2367,6 +2394,9 @@ bool qtractorMidiEngine::start (void)
 	// Reset output queue drift compensator...
 	resetDrift();
 
+	// Make room for some recording, off the input thread...
+	qtractorMidiEvent::reserve(4096);
+
 	// Start queue timer...
 	m_iFrameStart = long(pMidiCursor->frame());
 	m_iTimeStart  = long(pSession->tickFromFrame(m_iFrameStart));
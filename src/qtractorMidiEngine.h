@@ -152,6 +152,10 @@ public:
 	// Flush ouput queue (if necessary)...
 	void flush();
 
+	// Hold back MIDI output process cycles (eg. sequence re-ordering)...
+	void lockOutput();
+	void unlockOutput();
+
 	// Special rewind method, on queue loop.
 	void restartLoop();
 
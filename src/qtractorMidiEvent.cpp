@@ -0,0 +1,210 @@
+// qtractorMidiEvent.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2016, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorMidiEvent.h"
+
+#include "qtractorAtomic.h"
+
+#include <sched.h>
+
+#include <new>
+
+
+//----------------------------------------------------------------------
+// class qtractorMidiEventPool -- MIDI event slab allocator (singleton).
+//
+// Events are carved out of fixed-size chunks and recycled through
+// a free-list, guarded by a tiny spin-lock, so that heavy recording
+// and editing won't fragment the heap nor hit the system allocator
+// from the MIDI input thread, most of the time. New chunks are
+// always allocated outside the lock and are never given back:
+// the pool is purposely leaked, as events may still be deleted
+// from other static destructors (eg. the MIDI editor clipboard).
+// Note that SysEx payloads are variable sized and still go
+// through the system allocator, one per event.
+
+class qtractorMidiEventPool
+{
+public:
+
+	// Chunk size (in number of events).
+	enum { ChunkSize = 4096 };
+
+	// Constructor.
+	qtractorMidiEventPool()
+		: m_pFreeList(NULL), m_iFree(0), m_pChunks(NULL)
+		{ ATOMIC_SET(&m_lock, 0); }
+
+	// Allocate one event slot (NULL on failure).
+	void *alloc()
+	{
+		lock();
+		while (m_pFreeList == NULL) {
+			unlock();
+			Slot *pChunk = newChunk(ChunkSize);
+			if (pChunk == NULL)
+				return NULL;
+			lock();
+			linkChunk(pChunk, ChunkSize);
+		}
+		Slot *pSlot = m_pFreeList;
+		m_pFreeList = pSlot->pNext;
+		--m_iFree;
+		unlock();
+		return pSlot;
+	}
+
+	// Give one event slot back.
+	void free(void *pvSlot)
+	{
+		Slot *pSlot = static_cast<Slot *> (pvSlot);
+		lock();
+		pSlot->pNext = m_pFreeList;
+		m_pFreeList = pSlot;
+		++m_iFree;
+		unlock();
+	}
+
+	// Make sure there's this many free slots around.
+	bool reserve(unsigned int iEvents)
+	{
+		lock();
+		const unsigned int iFree = m_iFree;
+		unlock();
+		if (iFree >= iEvents)
+			return true;
+		iEvents -= iFree;
+		if (iEvents < (unsigned int) ChunkSize)
+			iEvents = ChunkSize;
+		Slot *pChunk = newChunk(iEvents);
+		if (pChunk == NULL)
+			return false;
+		lock();
+		linkChunk(pChunk, iEvents);
+		unlock();
+		return true;
+	}
+
+	// Singleton instance accessor.
+	static qtractorMidiEventPool *getInstance()
+	{
+		if (g_pMidiEventPool == NULL)
+			g_pMidiEventPool = new qtractorMidiEventPool();
+		return g_pMidiEventPool;
+	}
+
+private:
+
+	// Slot storage.
+	union Slot
+	{
+		Slot *pNext;
+		unsigned char data[sizeof(qtractorMidiEvent)];
+		unsigned long align;
+	};
+
+	// Spin-lock primitives.
+	void lock()   { while (!ATOMIC_TAS(&m_lock)) ::sched_yield(); }
+	void unlock() { m_lock.fetchAndStoreRelease(0); }
+
+	// Allocate a new chunk (no lock held); the very
+	// first slot is reserved as the chunk list link.
+	static Slot *newChunk(unsigned int iEvents)
+	{
+		Slot *pChunk = static_cast<Slot *> (
+			::malloc((iEvents + 1) * sizeof(Slot)));
+		if (pChunk == NULL)
+			return NULL;
+		Slot *pFreeList = NULL;
+		for (unsigned int i = 1; i <= iEvents; ++i) {
+			Slot *pSlot = &pChunk[i];
+			pSlot->pNext = pFreeList;
+			pFreeList = pSlot;
+		}
+		pChunk[0].pNext = pFreeList;
+		return pChunk;
+	}
+
+	// Thread a new chunk into the free-list (lock held).
+	void linkChunk(Slot *pChunk, unsigned int iEvents)
+	{
+		Slot *pLast = &pChunk[1];
+		pLast->pNext = m_pFreeList;
+		m_pFreeList = pChunk[0].pNext;
+		m_iFree += iEvents;
+		pChunk[0].pNext = m_pChunks;
+		m_pChunks = pChunk;
+	}
+
+	// Instance members.
+	qtractorAtomic m_lock;
+	Slot          *m_pFreeList;
+	unsigned int   m_iFree;
+	Slot          *m_pChunks;
+
+	// The singleton instance (eagerly constructed, never deleted).
+	static qtractorMidiEventPool *g_pMidiEventPool;
+};
+
+
+// The singleton instance, eagerly constructed before any of the
+// (MIDI input, output, GUI) threads start; purposely leaked.
+qtractorMidiEventPool *qtractorMidiEventPool::g_pMidiEventPool
+	= qtractorMidiEventPool::getInstance();
+
+
+//----------------------------------------------------------------------
+// class qtractorMidiEvent -- The generic MIDI event element.
+//
+
+// Pooled (slab) allocation operators.
+void *qtractorMidiEvent::operator new ( size_t iSize )
+{
+	if (iSize != sizeof(qtractorMidiEvent))
+		return ::operator new(iSize);
+
+	void *pEvent = qtractorMidiEventPool::getInstance()->alloc();
+	if (pEvent == NULL)
+		throw std::bad_alloc();
+
+	return pEvent;
+}
+
+void qtractorMidiEvent::operator delete ( void *pEvent, size_t iSize )
+{
+	if (pEvent == NULL)
+		return;
+
+	if (iSize != sizeof(qtractorMidiEvent))
+		::operator delete(pEvent);
+	else
+		qtractorMidiEventPool::getInstance()->free(pEvent);
+}
+
+
+// Pool pre-allocation (eg. before recording).
+void qtractorMidiEvent::reserve ( unsigned int iEvents )
+{
+	qtractorMidiEventPool::getInstance()->reserve(iEvents);
+}
+
+
+// end of qtractorMidiEvent.cpp
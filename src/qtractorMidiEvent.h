@@ -25,6 +25,7 @@
 #include "qtractorList.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 
@@ -151,6 +152,13 @@ public:
 	void setPitchBend(int iPitchBend)
 		{ m_v.value = (unsigned short) (0x2000 + iPitchBend); }
 
+	// Pooled (slab) allocation operators.
+	static void *operator new(size_t iSize);
+	static void operator delete(void *pEvent, size_t iSize);
+
+	// Pool pre-allocation (eg. before recording).
+	static void reserve(unsigned int iEvents);
+
 private:
 
 	// Event instance members.
@@ -405,6 +405,53 @@ bool qtractorMidiManager::g_bAudioOutputAutoConnect = true;
 // AG: Buffer size large enough to hold some sysex events.
 const long c_iMaxMidiData = 512;
 
+
+// Encode plain channel events into raw MIDI bytes (fast path);
+// returns zero when it must be left to the full MIDI parser.
+static inline long midi_event_encode (
+	const snd_seq_event_t *pEv, unsigned char *pMidiData )
+{
+	switch (pEv->type) {
+	case SND_SEQ_EVENT_NOTEON:
+		pMidiData[0] = 0x90 | (pEv->data.note.channel & 0x0f);
+		pMidiData[1] = pEv->data.note.note & 0x7f;
+		pMidiData[2] = pEv->data.note.velocity & 0x7f;
+		return 3;
+	case SND_SEQ_EVENT_NOTEOFF:
+		pMidiData[0] = 0x80 | (pEv->data.note.channel & 0x0f);
+		pMidiData[1] = pEv->data.note.note & 0x7f;
+		pMidiData[2] = pEv->data.note.velocity & 0x7f;
+		return 3;
+	case SND_SEQ_EVENT_KEYPRESS:
+		pMidiData[0] = 0xa0 | (pEv->data.note.channel & 0x0f);
+		pMidiData[1] = pEv->data.note.note & 0x7f;
+		pMidiData[2] = pEv->data.note.velocity & 0x7f;
+		return 3;
+	case SND_SEQ_EVENT_CONTROLLER:
+		pMidiData[0] = 0xb0 | (pEv->data.control.channel & 0x0f);
+		pMidiData[1] = pEv->data.control.param & 0x7f;
+		pMidiData[2] = pEv->data.control.value & 0x7f;
+		return 3;
+	case SND_SEQ_EVENT_PGMCHANGE:
+		pMidiData[0] = 0xc0 | (pEv->data.control.channel & 0x0f);
+		pMidiData[1] = pEv->data.control.value & 0x7f;
+		return 2;
+	case SND_SEQ_EVENT_CHANPRESS:
+		pMidiData[0] = 0xd0 | (pEv->data.control.channel & 0x0f);
+		pMidiData[1] = pEv->data.control.value & 0x7f;
+		return 2;
+	case SND_SEQ_EVENT_PITCHBEND: {
+		const int iValue = pEv->data.control.value + 0x2000;
+		pMidiData[0] = 0xe0 | (pEv->data.control.channel & 0x0f);
+		pMidiData[1] = iValue & 0x7f;
+		pMidiData[2] = (iValue >> 7) & 0x7f;
+		return 3;
+	}
+	default:
+		return 0;
+	}
+}
+
 // Constructor.
 qtractorMidiManager::qtractorMidiManager (
 	qtractorPluginList *pPluginList, unsigned int iBufferSize ) :
@@ -413,6 +460,7 @@ qtractorMidiManager::qtractorMidiManager (
 	m_directBuffer(iBufferSize >> 1),
 	m_queuedBuffer(iBufferSize),
 	m_postedBuffer(iBufferSize),
+	m_capturedBuffer(iBufferSize >> 1),
 	m_controllerBuffer(iBufferSize >> 2),
 	m_pEventBuffer(NULL), m_iEventCount(0),
 #ifdef CONFIG_MIDI_PARSER
@@ -548,6 +596,20 @@ bool qtractorMidiManager::queued (
 }
 
 
+// Captured buffering (MIDI input thread only).
+//
+// Unlike queued(), which is fed by the MIDI output thread with
+// an ordered insert, this one is a plain single-producer push,
+// so that MIDI input (thru) events never contend or shuffle the
+// same ring-buffer slots the audio thread might be reading from;
+// events come in already time-stamped on reception, in order.
+bool qtractorMidiManager::captured (
+	snd_seq_event_t *pEvent, unsigned long iTime )
+{
+	return m_capturedBuffer.push(pEvent, iTime);
+}
+
+
 // Clears buffers for processing.
 void qtractorMidiManager::clear (void)
 {
@@ -584,35 +646,52 @@ void qtractorMidiManager::process (
 		qtractorMidiSyncItem::syncItem(m_pSyncItem);
 
 	// Merge events in buffer for plugin processing...
+	const unsigned int MaxMidiEvents = bufferSize();
+
 	snd_seq_event_t *pEv0 = m_directBuffer.peek();
-	snd_seq_event_t *pEv1 = m_queuedBuffer.peek();
-	snd_seq_event_t *pEv2 = m_postedBuffer.peek();
 
 	// Direct events...
-	while (pEv0) {
+	while (pEv0 && m_iEventCount < MaxMidiEvents) {
 		m_pEventBuffer[m_iEventCount++] = *pEv0;
 		pEv0 = m_directBuffer.next();
 	}
 
-	// Queued/posted events...
-	while ((pEv1 && pEv1->time.tick < iTimeEnd)
-		|| (pEv2 && pEv2->time.tick < iTimeEnd)) {
-		while (pEv1 && pEv1->time.tick < iTimeEnd
-			&& ((pEv2 && pEv2->time.tick >= pEv1->time.tick) || !pEv2)) {
-			m_pEventBuffer[m_iEventCount] = *pEv1;
-			m_pEventBuffer[m_iEventCount++].time.tick
-				= (pEv1->time.tick > iTimeStart
-					? pEv1->time.tick - iTimeStart : 0);
-			pEv1 = m_queuedBuffer.next();
-		}
-		while (pEv2 && pEv2->time.tick < iTimeEnd
-			&& ((pEv1 && pEv1->time.tick > pEv2->time.tick) || !pEv1)) {
-			m_pEventBuffer[m_iEventCount] = *pEv2;
-			m_pEventBuffer[m_iEventCount++].time.tick
-				= (pEv2->time.tick > iTimeStart
-					? pEv2->time.tick - iTimeStart : 0);
-			pEv2 = m_postedBuffer.next();
+	// Queued/posted/captured events (k-way merge);
+	// ties are resolved in source order (queued first)...
+	qtractorMidiBuffer *sources[] = {
+		&m_queuedBuffer, &m_postedBuffer, &m_capturedBuffer };
+	const unsigned short iSources = sizeof(sources) / sizeof(sources[0]);
+	snd_seq_event_t *heads[iSources];
+	unsigned short k;
+
+	for (k = 0; k < iSources; ++k)
+		heads[k] = sources[k]->peek();
+
+	unsigned long iTimeLast = 0;
+	while (m_iEventCount < MaxMidiEvents) {
+		snd_seq_event_t *pEv = NULL;
+		unsigned short iSource = 0;
+		for (k = 0; k < iSources; ++k) {
+			snd_seq_event_t *pEvk = heads[k];
+			if (pEvk && pEvk->time.tick < iTimeEnd
+				&& (pEv == NULL || pEvk->time.tick < pEv->time.tick)) {
+				pEv = pEvk;
+				iSource = k;
+			}
 		}
+		if (pEv == NULL)
+			break;
+		// Captured events may be slightly out of order
+		// (eg. capture quantize) so keep it monotonic...
+		unsigned long iTime = (pEv->time.tick > iTimeStart
+			? pEv->time.tick - iTimeStart : 0);
+		if (iTime < iTimeLast)
+			iTime = iTimeLast;
+		m_pEventBuffer[m_iEventCount] = *pEv;
+		m_pEventBuffer[m_iEventCount++].time.tick = iTime;
+		iTimeLast = iTime;
+		// Move on (to next)...
+		heads[iSource] = sources[iSource]->next();
 	}
 
 #ifdef CONFIG_DEBUG_0
@@ -641,13 +720,19 @@ void qtractorMidiManager::process (
 	// Now's time to process the plugins as usual...
 	if (m_pAudioOutputBus) {
 		const unsigned int nframes = iTimeEnd - iTimeStart;
+		const unsigned long iPathLatency
+			= m_pAudioOutputBus->trackLatency();
 		if (m_bAudioOutputBus) {
 			m_pAudioOutputBus->process_prepare(nframes);
 			m_pPluginList->process(m_pAudioOutputBus->out(), nframes);
+			m_pPluginList->process_latency(
+				m_pAudioOutputBus->out(), nframes, iPathLatency);
 			m_pAudioOutputBus->process_commit(nframes);
 		} else {
 			m_pAudioOutputBus->buffer_prepare(nframes);
 			m_pPluginList->process(m_pAudioOutputBus->buffer(), nframes);
+			m_pPluginList->process_latency(
+				m_pAudioOutputBus->buffer(), nframes, iPathLatency);
 			m_pAudioOutputBus->buffer_commit(nframes);
 		}
 	}
@@ -713,6 +798,7 @@ void qtractorMidiManager::reset (void)
 	m_directBuffer.clear();
 	m_queuedBuffer.clear();
 	m_postedBuffer.reset(); // formerly .clear();
+	m_capturedBuffer.clear();
 
 	clear();
 
@@ -874,11 +960,16 @@ void qtractorMidiManager::processEventBuffers (void)
 		snd_seq_event_t *pEv = &m_pEventBuffer[i];
 		unsigned char midiData[c_iMaxMidiData];
 		pMidiData = &midiData[0];
-		iMidiData = sizeof(midiData);
-		iMidiData = snd_midi_event_decode(m_pMidiParser,
-			pMidiData, iMidiData, pEv);
-		if (iMidiData < 0)
-			break;
+		// Plain channel events are encoded right away,
+		// only the odd ones (sysex, 14bit, RPN/NRPN...)
+		// have to go through the full MIDI parser...
+		iMidiData = midi_event_encode(pEv, pMidiData);
+		if (iMidiData == 0) {
+			iMidiData = snd_midi_event_decode(m_pMidiParser,
+				pMidiData, sizeof(midiData), pEv);
+			if (iMidiData < 0)
+				break;
+		}
 	#ifdef CONFIG_DEBUG_0
 		// - show event for debug purposes...
 		unsigned long iTime = pEv->time.tick;
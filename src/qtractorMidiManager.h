@@ -199,6 +199,9 @@ public:
 	bool queued(snd_seq_event_t *pEvent,
 		unsigned long iTime, unsigned long iTimeOff = 0);
 
+	// Captured buffering (MIDI input thread only).
+	bool captured(snd_seq_event_t *pEvent, unsigned long iTime);
+
 	// Process buffers.
 	void process(unsigned long iTimeStart, unsigned long iTimeEnd);
 
@@ -356,6 +359,7 @@ private:
 	qtractorMidiBuffer  m_directBuffer;
 	qtractorMidiBuffer  m_queuedBuffer;
 	qtractorMidiBuffer  m_postedBuffer;
+	qtractorMidiBuffer  m_capturedBuffer;
 
 	qtractorMidiBuffer  m_controllerBuffer;
 
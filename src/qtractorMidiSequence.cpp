@@ -163,6 +163,65 @@ void qtractorMidiSequence::removeEvent ( qtractorMidiEvent *pEvent )
 }
 
 
+// Re-sort all events in time order (batch edits).
+//
+// Events which had their time changed in place are all put
+// back in order at once, instead of being unlinked and
+// re-inserted one by one, which is quadratic on large edits.
+static bool sortEventLessThan (
+	const qtractorMidiEvent *pEvent1, const qtractorMidiEvent *pEvent2 )
+{
+	return (pEvent1->time() < pEvent2->time());
+}
+
+// Sorted copy of all events, leaving the sequence untouched.
+void qtractorMidiSequence::sortEvents (
+	QVector<qtractorMidiEvent *>& events ) const
+{
+	events.clear();
+	events.reserve(m_events.count());
+
+	qtractorMidiEvent *pEvent = m_events.first();
+	while (pEvent) {
+		events.append(pEvent);
+		pEvent = pEvent->next();
+	}
+
+	qStableSort(events.begin(), events.end(), sortEventLessThan);
+}
+
+// Swap in a sorted copy of all events (the very same ones);
+// meant to be done while playback is held back.
+void qtractorMidiSequence::replaceEvents (
+	const QVector<qtractorMidiEvent *>& events )
+{
+	qtractorMidiEvent *pEvent = m_events.first();
+	while (pEvent) {
+		qtractorMidiEvent *pNextEvent = pEvent->next();
+		m_events.unlink(pEvent);
+		pEvent = pNextEvent;
+	}
+
+	QVectorIterator<qtractorMidiEvent *> iter(events);
+	while (iter.hasNext()) {
+		pEvent = iter.next();
+		m_events.append(pEvent);
+		unsigned long iTime = pEvent->time();
+		// NOTEON: Keep note stats...
+		if (pEvent->type() == qtractorMidiEvent::NOTEON) {
+			const unsigned char note = pEvent->note();
+			if (m_noteMin > note || m_noteMin == 0)
+				m_noteMin = note;
+			if (m_noteMax < note || m_noteMax == 0)
+				m_noteMax = note;
+			iTime += pEvent->duration();
+		}
+		if (m_duration < iTime)
+			m_duration = iTime;
+	}
+}
+
+
 // Sequence closure method.
 void qtractorMidiSequence::close (void)
 {
@@ -26,6 +26,7 @@
 
 #include <QString>
 #include <QMultiHash>
+#include <QVector>
 
 // typedef unsigned long long uint64_t;
 #include <stdint.h>
@@ -102,6 +103,11 @@ public:
 	void unlinkEvent (qtractorMidiEvent *pEvent);
 	void removeEvent (qtractorMidiEvent *pEvent);
 
+	// Re-sort all events in time order (batch edits):
+	// sorted copy first, then swapped in as a whole.
+	void sortEvents(QVector<qtractorMidiEvent *>& events) const;
+	void replaceEvents(const QVector<qtractorMidiEvent *>& events);
+
 	// Adjust time resolutions (64bit).
 	unsigned long timep(unsigned long iTime, unsigned short p) const
 		{ return uint64_t(iTime) * p / m_iTicksPerBeat; }
@@ -820,6 +820,15 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 		iter = items.constBegin();
 	}
 
+	// Timeshift edit range, invariant for the whole pass...
+	unsigned long iEditHeadTime = 0;
+	unsigned long iEditTailTime = 0;
+	if (m_ui.TimeshiftCheckBox->isChecked()) {
+		qtractorSession *pSession = qtractorSession::getInstance();
+		iEditHeadTime = pSession->tickFromFrame(pSession->editHead());
+		iEditTailTime = pSession->tickFromFrame(pSession->editTail());
+	}
+
 	// Go for the main pass...
 	qtractorTimeScale::Cursor cursor(m_pTimeScale);
 
@@ -832,7 +841,6 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 		qtractorTimeScale::Node *pNode = cursor.seekTick(iTime);
 		// Quantize tool...
 		if (m_ui.QuantizeCheckBox->isChecked()) {
-			tools.append(tr("quantize"));
 			// Swing quantize...
 			if (m_ui.QuantizeSwingCheckBox->isChecked()) {
 				const unsigned short p = qtractorTimeScale::snapFromIndex(
@@ -900,7 +908,6 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 		}
 		// Transpose tool...
 		if (m_ui.TransposeCheckBox->isChecked()) {
-			tools.append(tr("transpose"));
 			int iNote = int(pEvent->note());
 			if (m_ui.TransposeNoteCheckBox->isChecked()
 				&& pEvent->type() == qtractorMidiEvent::NOTEON) {
@@ -921,7 +928,6 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 		}
 		// Normalize tool...
 		if (m_ui.NormalizeCheckBox->isChecked()) {
-			tools.append(tr("normalize"));
 			float p, q = float(iMaxValue);
 			if (m_ui.NormalizeValueCheckBox->isChecked())
 				p = float(m_ui.NormalizeValueSpinBox->value());
@@ -951,7 +957,6 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 		}
 		// Randomize tool...
 		if (m_ui.RandomizeCheckBox->isChecked()) {
-			tools.append(tr("randomize"));
 			float p; int q;
 			if (m_ui.RandomizeNoteCheckBox->isChecked()) {
 				int iNote = int(pEvent->note());
@@ -1013,7 +1018,6 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 		}
 		// Resize tool...
 		if (m_ui.ResizeCheckBox->isChecked()) {
-			tools.append(tr("resize"));
 			if (m_ui.ResizeDurationCheckBox->isChecked()) {
 				iDuration = pNode->tickFromFrame(pNode->frameFromTick(iTime)
 					+ m_ui.ResizeDurationSpinBox->value()) - iTime;
@@ -1037,7 +1041,6 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 		}
 		// Rescale tool...
 		if (m_ui.RescaleCheckBox->isChecked()) {
-			tools.append(tr("rescale"));
 			float p;
 			if (m_ui.RescaleTimeCheckBox->isChecked()) {
 				p = 0.01f * float(m_ui.RescaleTimeSpinBox->value());
@@ -1076,12 +1079,6 @@ qtractorMidiEditCommand *qtractorMidiToolsForm::editCommand (
 		}
 		// Timeshift tool...
 		if (m_ui.TimeshiftCheckBox->isChecked()) {
-			tools.append(tr("timeshift"));
-			qtractorSession *pSession = qtractorSession::getInstance();
-			const unsigned long iEditHeadTime
-				= pSession->tickFromFrame(pSession->editHead());
-			const unsigned long iEditTailTime
-				= pSession->tickFromFrame(pSession->editTail());
 			const float d = float(iEditTailTime - iEditHeadTime);
 			const float p = float(m_ui.TimeshiftSpinBox->value());
 			if ((p < -1e-6f || p > 1e-6f) && (d > 0.0f)) {
@@ -22,88 +22,85 @@
 #include "qtractorAbout.h"
 #include "qtractorObserver.h"
 
+#include <QAtomicPointer>
+
 
 //---------------------------------------------------------------------------
 // qtractorSubjectQueue - Update/notify subject queue.
+//
+// Lock-free, multi-producer (audio, MIDI and GUI threads) and single
+// consumer (GUI thread); subjects are linked in intrusively and only
+// ever once (coalescing), so there's no such thing as an overflow.
 
 class qtractorSubjectQueue
 {
 public:
 
-	struct QueueItem
-	{
-		qtractorSubject  *subject;
-		qtractorObserver *sender;
-	};
-
-	qtractorSubjectQueue ( unsigned int iQueueSize = 1024 )
-		: m_iQueueIndex(0), m_iQueueSize(0), m_pQueueItems(NULL)
-		{ resize(iQueueSize); }
+	qtractorSubjectQueue () : m_pHead(NULL) {}
 
 	~qtractorSubjectQueue ()
-		{ clear(); delete [] m_pQueueItems; }
+		{ clear(); }
 
-	void clear()
-		{ m_iQueueIndex = 0; }
+	// Hard clear (subjects may be already gone).
+	void clear ()
+		{ m_pHead.fetchAndStoreOrdered(NULL); }
 
-	bool push ( qtractorSubject *pSubject, qtractorObserver *pSender )
+	// Link an already claimed subject in (any thread).
+	void push ( qtractorSubject *pSubject, qtractorObserver *pSender )
 	{
-		if (m_iQueueIndex >= m_iQueueSize)
-			return false;
-		pSubject->setQueued(true);
-		QueueItem *pItem = &m_pQueueItems[m_iQueueIndex++];
-		pItem->subject = pSubject;
-		pItem->sender  = pSender;
-		return true;
+		pSubject->m_pQueueSender = pSender;
+		qtractorSubject *pHead;
+		do {
+		#if QT_VERSION >= 0x050000
+			pHead = m_pHead.load();
+		#else
+			pHead = m_pHead;
+		#endif
+			pSubject->m_pQueueNext = pHead;
+		} while (!m_pHead.testAndSetRelease(pHead, pSubject));
 	}
 
-	bool pop (bool bUpdate)
+	// Unlink all pending subjects, in arrival order (consumer only).
+	qtractorSubject *take ()
 	{
-		if (m_iQueueIndex == 0)
-			return false;
-		QueueItem *pItem = &m_pQueueItems[--m_iQueueIndex];
-		qtractorSubject *pSubject = pItem->subject;
-		pSubject->notify(pItem->sender, bUpdate);
-		pSubject->setQueued(false);
-		return true;
+		qtractorSubject *pSubject = m_pHead.fetchAndStoreAcquire(NULL);
+		qtractorSubject *pList = NULL;
+		while (pSubject) {
+			qtractorSubject *pNext = pSubject->m_pQueueNext;
+			pSubject->m_pQueueNext = pList;
+			pList = pSubject;
+			pSubject = pNext;
+		}
+		return pList;
 	}
 
-	void flush (bool bUpdate)
-		{ while (pop(bUpdate)) ; }
-
-	void reset ()
+	void flush ( bool bUpdate )
 	{
-		while (m_iQueueIndex > 0) {
-			QueueItem *pItem = &m_pQueueItems[--m_iQueueIndex];
-			(pItem->subject)->setQueued(false);
+		qtractorSubject *pSubject = take();
+		while (pSubject) {
+			qtractorSubject *pNext = pSubject->m_pQueueNext;
+			qtractorObserver *pSender = pSubject->m_pQueueSender;
+			// Re-arm before notifying, so that any
+			// change from now on gets queued again...
+			pSubject->m_queued.fetchAndStoreOrdered(0);
+			pSubject->notify(pSender, bUpdate);
+			pSubject = pNext;
 		}
-		clear();
 	}
 
-	void resize ( unsigned int iNewSize )
+	void reset ()
 	{
-		QueueItem *pOldItems = m_pQueueItems;
-		QueueItem *pNewItems = new QueueItem [iNewSize];
-		if (pOldItems) {
-			unsigned int iOldSize = m_iQueueIndex;
-			if (iOldSize > iNewSize)
-				iOldSize = iNewSize;
-			if (iOldSize > 0)
-				::memcpy(pNewItems, pOldItems, iOldSize * sizeof(QueueItem));
-			m_iQueueSize  = iNewSize;
-			m_pQueueItems = pNewItems;
-			delete [] pOldItems;
-		} else {
-			m_iQueueSize  = iNewSize;
-			m_pQueueItems = pNewItems;
+		qtractorSubject *pSubject = take();
+		while (pSubject) {
+			qtractorSubject *pNext = pSubject->m_pQueueNext;
+			pSubject->m_queued.fetchAndStoreOrdered(0);
+			pSubject = pNext;
 		}
 	}
 
 private:
 
-	unsigned int m_iQueueIndex;
-	unsigned int m_iQueueSize;
-	QueueItem   *m_pQueueItems;
+	QAtomicPointer<qtractorSubject> m_pHead;
 };
 
 
@@ -116,7 +113,8 @@ static qtractorSubjectQueue g_subjectQueue;
 
 // Constructor.
 qtractorSubject::qtractorSubject ( float fValue, float fDefaultValue )
-	: m_fValue(fValue), m_bQueued(false), m_fPrevValue(fValue),
+	: m_fValue(fValue), m_pQueueNext(NULL), m_pQueueSender(NULL),
+		m_fPrevValue(fValue),
 		m_fMinValue(0.0f), m_fMaxValue(1.0f), m_fDefaultValue(fDefaultValue),
 		m_bToggled(false), m_bInteger(false), m_pCurve(NULL)
 {
@@ -139,12 +137,15 @@ void qtractorSubject::setValue ( float fValue, qtractorObserver *pSender )
 	if (fValue == m_fValue)
 		return;
 
-	if (!m_bQueued) {
-		m_fPrevValue = m_fValue;
+	const float fPrevValue = m_fValue;
+	m_fValue = safeValue(fValue);
+
+	// Only the first change gets queued, later ones
+	// are coalesced, until observers get notified...
+	if (ATOMIC_CAS(&m_queued, 0, 1)) {
+		m_fPrevValue = fPrevValue;
 		g_subjectQueue.push(this, pSender);
 	}
-
-	m_fValue = safeValue(fValue);
 }
 
 
@@ -22,6 +22,8 @@
 #ifndef __qtractorObserver_h
 #define __qtractorObserver_h
 
+#include "qtractorAtomic.h"
+
 #include <QString>
 #include <QList>
 
@@ -33,6 +35,8 @@ class qtractorSubject;
 class qtractorObserver;
 class qtractorCurve;
 
+class qtractorSubjectQueue;
+
 
 //---------------------------------------------------------------------------
 // qtractorSubject - Scalar parameter value model.
@@ -69,9 +73,9 @@ public:
 
 	// Queue status accessors.
 	void setQueued(bool bQueued)
-		{ m_bQueued = bQueued; }
+		{ ATOMIC_SET(&m_queued, bQueued ? 1 : 0); }
 	bool isQueued() const
-		{ return m_bQueued; }
+		{ return ATOMIC_GET(&m_queued) != 0; }
 
 	// Direct address accessor.
 	float *data() { return &m_fValue; }
@@ -159,9 +163,16 @@ public:
 
 private:
 
+	// Queue (intrusive) link access.
+	friend class qtractorSubjectQueue;
+
 	// Instance variables.
 	float   m_fValue;
-	bool	m_bQueued;
+
+	// Queue status and (intrusive) link.
+	qtractorAtomic    m_queued;
+	qtractorSubject  *m_pQueueNext;
+	qtractorObserver *m_pQueueSender;
 
 	float   m_fPrevValue;
 
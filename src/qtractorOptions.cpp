@@ -94,6 +94,7 @@ void qtractorOptions::loadOptions (void)
 	bKeepToolsOnTop = m_settings.value("/KeepToolsOnTop", true).toBool();
 	iDisplayFormat  = m_settings.value("/DisplayFormat", 1).toInt();
 	iMaxRecentFiles = m_settings.value("/MaxRecentFiles", 5).toInt();
+	iUndoMaxSize    = m_settings.value("/UndoMaxSize", 1024).toInt();
 	iBaseFontSize   = m_settings.value("/BaseFontSize", 0).toInt();
 	m_settings.endGroup();
 
@@ -211,6 +212,7 @@ void qtractorOptions::loadOptions (void)
 	bMidButtonModifier = m_settings.value("/MidButtonModifier", false).toBool();
 	bMidiControlSync = m_settings.value("/MidiControlSync", false).toBool();
 	bExportAddTrack = m_settings.value("/ExportAddTrack", false).toBool();
+	bExportStems = m_settings.value("/ExportStems", false).toBool();
 	m_settings.endGroup();
 
 	// Session auto-save group.
@@ -234,6 +236,11 @@ void qtractorOptions::loadOptions (void)
 	bDummyVstScan = m_settings.value("/DummyVstScan", true).toBool();
 	bLv2DynManifest = m_settings.value("/Lv2DynManifest", false).toBool();
 	bSaveCurve14bit = m_settings.value("/SaveCurve14bit", false).toBool();
+	bPluginBridge = m_settings.value("/PluginBridge", false).toBool();
+	bPluginInstantSwap = m_settings.value("/PluginInstantSwap", false).toBool();
+	bPluginGuard = m_settings.value("/PluginGuard", false).toBool();
+	bSaveCurveBinary = m_settings.value("/SaveCurveBinary", false).toBool();
+	bPluginLazyLoad = m_settings.value("/PluginLazyLoad", false).toBool();
 	m_settings.endGroup();
 
 	// Instrument file list.
@@ -380,6 +387,7 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/KeepToolsOnTop", bKeepToolsOnTop);
 	m_settings.setValue("/DisplayFormat", iDisplayFormat);
 	m_settings.setValue("/MaxRecentFiles", iMaxRecentFiles);
+	m_settings.setValue("/UndoMaxSize", iUndoMaxSize);
 	m_settings.setValue("/BaseFontSize", iBaseFontSize);
 	m_settings.endGroup();
 
@@ -497,6 +505,7 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/MidButtonModifier", bMidButtonModifier);
 	m_settings.setValue("/MidiControlSync", bMidiControlSync);
 	m_settings.setValue("/ExportAddTrack", bExportAddTrack);
+	m_settings.setValue("/ExportStems", bExportStems);
 	m_settings.endGroup();
 
 	// Session auto-save group.
@@ -520,6 +529,11 @@ void qtractorOptions::saveOptions (void)
 	m_settings.setValue("/DummyVstScan", bDummyVstScan);
 	m_settings.setValue("/Lv2DynManifest", bLv2DynManifest);
 	m_settings.setValue("/SaveCurve14bit", bSaveCurve14bit);
+	m_settings.setValue("/PluginBridge", bPluginBridge);
+	m_settings.setValue("/PluginInstantSwap", bPluginInstantSwap);
+	m_settings.setValue("/PluginGuard", bPluginGuard);
+	m_settings.setValue("/SaveCurveBinary", bSaveCurveBinary);
+	m_settings.setValue("/PluginLazyLoad", bPluginLazyLoad);
 	m_settings.endGroup();
 
 	// Instrument file list.
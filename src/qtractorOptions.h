@@ -189,8 +189,9 @@ public:
 	// MIDI control non catch-up/hook option.
 	bool    bMidiControlSync;
 
-	// Export add new track(s) option.
+	// Export add new track(s) and track stems options.
 	bool    bExportAddTrack;
+	bool    bExportStems;
 
 	// Session auto-save options.
 	bool    bAutoSaveEnabled;
@@ -222,6 +223,21 @@ public:
 	// Automation preferred resolution (14bit).
 	bool bSaveCurve14bit;
 
+	// Out-of-process (bridged) plugin hosting.
+	bool bPluginBridge;
+
+	// Instant (double-buffered) LV2 preset switching.
+	bool bPluginInstantSwap;
+
+	// Plugin output guard (denormals and NaN/Inf).
+	bool bPluginGuard;
+
+	// Automation curve files binary format (vs. SMF).
+	bool bSaveCurveBinary;
+
+	// Lazy instantiation of deactivated plugins on load.
+	bool bPluginLazyLoad;
+
 	// The instrument file list.
 	QStringList instrumentFiles;
 
@@ -232,6 +248,9 @@ public:
 	int iMaxRecentFiles;
 	QStringList recentFiles;
 
+	// Undo/redo history memory limit (MB, 0=unlimited).
+	int iUndoMaxSize;
+
 	// Tracks view options...
 	int  iTrackViewSelectMode;
 	bool bTrackViewDropSpan;
@@ -170,6 +170,11 @@ qtractorOptionsForm::qtractorOptionsForm (
 		qtractorPluginType::textFromHint(qtractorPluginType::Lv2));
 #else
 	m_ui.Lv2DynManifestCheckBox->hide();
+	m_ui.PluginInstantSwapCheckBox->hide();
+#endif
+
+#ifndef CONFIG_PLUGIN_BRIDGE
+	m_ui.PluginBridgeCheckBox->hide();
 #endif
 
 #ifndef CONFIG_LV2_PRESETS
@@ -336,6 +341,9 @@ qtractorOptionsForm::qtractorOptionsForm (
 	QObject::connect(m_ui.MaxRecentFilesSpinBox,
 		SIGNAL(valueChanged(int)),
 		SLOT(changed()));
+	QObject::connect(m_ui.UndoMaxSizeSpinBox,
+		SIGNAL(valueChanged(int)),
+		SLOT(changed()));
 	QObject::connect(m_ui.BaseFontSizeComboBox,
 		SIGNAL(editTextChanged(const QString&)),
 		SLOT(changed()));
@@ -441,6 +449,21 @@ qtractorOptionsForm::qtractorOptionsForm (
 	QObject::connect(m_ui.SaveCurve14bitCheckBox,
 		SIGNAL(stateChanged(int)),
 		SLOT(changed()));
+	QObject::connect(m_ui.PluginBridgeCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.PluginInstantSwapCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.PluginGuardCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.SaveCurveBinaryCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
+	QObject::connect(m_ui.PluginLazyLoadCheckBox,
+		SIGNAL(stateChanged(int)),
+		SLOT(changed()));
 	QObject::connect(m_ui.MessagesFontPushButton,
 		SIGNAL(clicked()),
 		SLOT(chooseMessagesFont()));
@@ -651,6 +674,7 @@ void qtractorOptionsForm::setOptions ( qtractorOptions *pOptions )
 	m_ui.TrackViewDropSpanCheckBox->setChecked(m_pOptions->bTrackViewDropSpan);
 	m_ui.MidButtonModifierCheckBox->setChecked(m_pOptions->bMidButtonModifier);
 	m_ui.MaxRecentFilesSpinBox->setValue(m_pOptions->iMaxRecentFiles);
+	m_ui.UndoMaxSizeSpinBox->setValue(m_pOptions->iUndoMaxSize);
 	m_ui.LoopRecordingModeComboBox->setCurrentIndex(m_pOptions->iLoopRecordingMode);
 	m_ui.DisplayFormatComboBox->setCurrentIndex(m_pOptions->iDisplayFormat);
 	if (m_pOptions->iBaseFontSize > 0)
@@ -683,6 +707,11 @@ void qtractorOptionsForm::setOptions ( qtractorOptions *pOptions )
 	m_ui.DummyVstScanCheckBox->setChecked(m_pOptions->bDummyVstScan);
 	m_ui.Lv2DynManifestCheckBox->setChecked(m_pOptions->bLv2DynManifest);
 	m_ui.SaveCurve14bitCheckBox->setChecked(m_pOptions->bSaveCurve14bit);
+	m_ui.PluginBridgeCheckBox->setChecked(m_pOptions->bPluginBridge);
+	m_ui.PluginInstantSwapCheckBox->setChecked(m_pOptions->bPluginInstantSwap);
+	m_ui.PluginGuardCheckBox->setChecked(m_pOptions->bPluginGuard);
+	m_ui.SaveCurveBinaryCheckBox->setChecked(m_pOptions->bSaveCurveBinary);
+	m_ui.PluginLazyLoadCheckBox->setChecked(m_pOptions->bPluginLazyLoad);
 
 	int iPluginType = m_pOptions->iPluginType - 1;
 	if (iPluginType < 0)
@@ -773,6 +802,7 @@ void qtractorOptionsForm::accept (void)
 		m_pOptions->bTrackViewDropSpan   = m_ui.TrackViewDropSpanCheckBox->isChecked();
 		m_pOptions->bMidButtonModifier   = m_ui.MidButtonModifierCheckBox->isChecked();
 		m_pOptions->iMaxRecentFiles      = m_ui.MaxRecentFilesSpinBox->value();
+		m_pOptions->iUndoMaxSize         = m_ui.UndoMaxSizeSpinBox->value();
 		m_pOptions->iLoopRecordingMode   = m_ui.LoopRecordingModeComboBox->currentIndex();
 		m_pOptions->iDisplayFormat       = m_ui.DisplayFormatComboBox->currentIndex();
 		m_pOptions->iBaseFontSize        = m_ui.BaseFontSizeComboBox->currentText().toInt();
@@ -790,6 +820,11 @@ void qtractorOptionsForm::accept (void)
 		m_pOptions->bDummyVstScan        = m_ui.DummyVstScanCheckBox->isChecked();
 		m_pOptions->bLv2DynManifest      = m_ui.Lv2DynManifestCheckBox->isChecked();
 		m_pOptions->bSaveCurve14bit      = m_ui.SaveCurve14bitCheckBox->isChecked();
+		m_pOptions->bPluginBridge        = m_ui.PluginBridgeCheckBox->isChecked();
+		m_pOptions->bPluginInstantSwap   = m_ui.PluginInstantSwapCheckBox->isChecked();
+		m_pOptions->bPluginGuard         = m_ui.PluginGuardCheckBox->isChecked();
+		m_pOptions->bSaveCurveBinary     = m_ui.SaveCurveBinaryCheckBox->isChecked();
+		m_pOptions->bPluginLazyLoad      = m_ui.PluginLazyLoadCheckBox->isChecked();
 		// Messages options...
 		m_pOptions->sMessagesFont        = m_ui.MessagesFontTextLabel->font().toString();
 		m_pOptions->bMessagesLimit       = m_ui.MessagesLimitCheckBox->isChecked();
@@ -36,16 +36,40 @@
 #include "qtractorSession.h"
 #include "qtractorDocument.h"
 #include "qtractorCurveFile.h"
+#include "qtractorCurve.h"
 
 #include "qtractorMessageList.h"
 
+#include "qtractorAtomic.h"
+
 #include <QTextStream>
 #include <QFileInfo>
 #include <QDir>
+#include <QHash>
 
 #include <QDomDocument>
 
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <jack/thread.h>
+
+#include <semaphore.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
 #include <math.h>
+#include <float.h>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 
 #if QT_VERSION < 0x040500
@@ -229,6 +253,656 @@ QString qtractorPluginType::textFromHint (
 }
 
 
+//----------------------------------------------------------------------------
+// qtractorPluginInstancePool -- Parallel plugin instance dispatcher.
+//
+// Worker threads are created through JACK, as real-time threads on
+// the very same scheduling class and priority of the process cycle
+// itself. The audio thread never blocks: workers are woken up by a
+// semaphore post, whatever instances haven't been claimed yet are
+// processed inline, and the join spin is bounded by a fraction of
+// the period. Workers run their instance on private (scratch) audio
+// buffers, only copied back while the job is still being joined;
+// past the deadline the job is abandoned, unfinished instances pass
+// their dry input through, and the pool backs off to serial for a
+// little while (about a second). The abandoned plugin stays on
+// hold (dry) until its stragglers are over, so that no instance
+// is ever run concurrently nor deactivated while still running.
+
+class qtractorPluginInstancePool
+{
+public:
+
+	// Constructor.
+	qtractorPluginInstancePool(
+		jack_client_t *pJackClient, unsigned int iThreads);
+
+	// Destructor.
+	~qtractorPluginInstancePool();
+
+	// Dispatch all plugin instances and join (audio thread).
+	bool process(qtractorPlugin *pPlugin,
+		float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
+
+	// Wait for any abandoned job stragglers of a plugin.
+	void release(qtractorPlugin *pPlugin);
+
+	// Pool (shared) instance management (non real-time).
+	static void createInstance();
+	static void deleteInstance();
+
+	static qtractorPluginInstancePool *getInstance()
+	{
+	#if QT_VERSION >= 0x050000
+		return g_pInstancePool.loadAcquire();
+	#else
+		return g_pInstancePool;
+	#endif
+	}
+
+protected:
+
+	// Worker private audio buffers.
+	enum { MaxChannels = 64, MaxPorts = 8 };
+
+	struct Scratch
+	{
+		float *ins[MaxChannels];
+		float *outs[MaxChannels];
+		float *data;
+	};
+
+	// Claim and process pending instances, if any
+	// (on scratch buffers when on a worker thread).
+	void work(Scratch *pScratch = NULL);
+
+	// Pass dry input through an instance output channels.
+	void dryInstance(unsigned short iInstance);
+
+	// Whether an abandoned job of this plugin is still running.
+	bool isAbandoned(qtractorPlugin *pPlugin) const;
+
+	// Worker thread executive.
+	void run();
+
+	static void *thread_func(void *pvArg);
+
+	// Monotonic clock (nanoseconds).
+	static long long clock_nsecs();
+
+private:
+
+	// Instance variables.
+	jack_client_t *m_pJackClient;
+
+	jack_native_thread_t *m_pThreads;
+	unsigned int m_iThreads;
+
+	// Current job (valid while there are instances pending).
+	qtractorPlugin *m_pPlugin;
+	float **m_ppIBuffer;
+	float **m_ppOBuffer;
+	unsigned int m_nframes;
+	unsigned int m_iCount;
+
+	qtractorAtomic m_busy;
+	qtractorAtomic m_iPending;
+	qtractorAtomic m_iDone;
+
+	// Abandoned job state (joiner gave up on it).
+	qtractorAtomic m_abandoned;
+	qtractorAtomic m_iWriters;
+	qtractorAtomic m_done[MaxChannels];
+
+	// Worker private buffers (one per thread).
+	Scratch *m_pScratch;
+	unsigned int m_iScratch;
+	unsigned int m_iBufferSize;
+
+	qtractorAtomic m_iThreadIndex;
+
+	// Whether the threads are logically running.
+	qtractorAtomic m_running;
+
+	// Worker wake-up semaphore (never blocks on post).
+	sem_t m_sem;
+
+	// Join time budget (nanoseconds per frame).
+	long long m_iFrameNsecs;
+
+	// Serial back-off (in process cycles, audio thread only).
+	unsigned int m_iSerialCycles;
+	unsigned int m_iSerialBackoff;
+
+	// The shared pool instance.
+	static QAtomicPointer<qtractorPluginInstancePool> g_pInstancePool;
+	static QMutex g_mutex;
+};
+
+
+QAtomicPointer<qtractorPluginInstancePool>
+	qtractorPluginInstancePool::g_pInstancePool;
+
+QMutex qtractorPluginInstancePool::g_mutex;
+
+
+// Constructor.
+qtractorPluginInstancePool::qtractorPluginInstancePool (
+	jack_client_t *pJackClient, unsigned int iThreads )
+	: m_pJackClient(pJackClient), m_pThreads(NULL), m_iThreads(0),
+		m_pPlugin(NULL), m_ppIBuffer(NULL), m_ppOBuffer(NULL),
+		m_nframes(0), m_iCount(0), m_pScratch(NULL), m_iScratch(0),
+		m_iBufferSize(0),
+		m_iFrameNsecs(0), m_iSerialCycles(0), m_iSerialBackoff(0)
+{
+	ATOMIC_SET(&m_busy, 0);
+	ATOMIC_SET(&m_iPending, 0);
+	ATOMIC_SET(&m_iDone, 0);
+	ATOMIC_SET(&m_abandoned, 0);
+	ATOMIC_SET(&m_iWriters, 0);
+	ATOMIC_SET(&m_iThreadIndex, 0);
+	ATOMIC_SET(&m_running, 1);
+
+	unsigned int i;
+	for (i = 0; i < MaxChannels; ++i)
+		ATOMIC_SET(&m_done[i], 0);
+
+	::sem_init(&m_sem, 0, 0);
+
+	// Join budget: half the period, per frame...
+	const unsigned int iSampleRate = jack_get_sample_rate(m_pJackClient);
+	if (iSampleRate > 0)
+		m_iFrameNsecs = 500000000LL / iSampleRate;
+
+	// Back-off for about a second worth of cycles...
+	const unsigned int iBufferSize = jack_get_buffer_size(m_pJackClient);
+	m_iSerialBackoff = (iBufferSize > 0 ? iSampleRate / iBufferSize : 1000);
+
+	// Worker private buffers: as many input and output ports...
+	m_iBufferSize = iBufferSize;
+	m_iScratch = iThreads;
+	m_pScratch = new Scratch [m_iScratch];
+	for (i = 0; i < m_iScratch; ++i) {
+		Scratch *pScratch = &m_pScratch[i];
+		::memset(pScratch->ins,  0, sizeof(pScratch->ins));
+		::memset(pScratch->outs, 0, sizeof(pScratch->outs));
+		pScratch->data = new float [2 * MaxPorts * m_iBufferSize];
+	}
+
+	// Real-time workers, just like the process cycle (if any)...
+	const int iRealtime = jack_is_realtime(m_pJackClient);
+	int iPriority = jack_client_real_time_priority(m_pJackClient);
+	if (iPriority < 0)
+		iPriority = 0;
+
+	m_pThreads = new jack_native_thread_t [iThreads];
+	for (i = 0; i < iThreads; ++i) {
+		if (jack_client_create_thread(m_pJackClient, &m_pThreads[i],
+				iPriority, iRealtime, thread_func, this) != 0)
+			break;
+		++m_iThreads;
+	}
+}
+
+
+// Destructor.
+qtractorPluginInstancePool::~qtractorPluginInstancePool (void)
+{
+	// Wake and terminate all worker threads...
+	ATOMIC_SET(&m_running, 0);
+
+	unsigned int i;
+	for (i = 0; i < m_iThreads; ++i)
+		::sem_post(&m_sem);
+	for (i = 0; i < m_iThreads; ++i)
+		::pthread_join(m_pThreads[i], NULL);
+
+	delete [] m_pThreads;
+
+	for (i = 0; i < m_iScratch; ++i)
+		delete [] m_pScratch[i].data;
+	delete [] m_pScratch;
+
+	::sem_destroy(&m_sem);
+}
+
+
+// Monotonic clock (nanoseconds).
+long long qtractorPluginInstancePool::clock_nsecs (void)
+{
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+
+// Dispatch all plugin instances and join (audio thread).
+bool qtractorPluginInstancePool::process ( qtractorPlugin *pPlugin,
+	float **ppIBuffer, float **ppOBuffer, unsigned int nframes )
+{
+	const unsigned short iInstances = pPlugin->instances();
+	if (iInstances < 2 || m_iThreads < 1)
+		return false;
+
+	// Still on hold, waiting for its own stragglers? pass dry...
+	if (isAbandoned(pPlugin)) {
+		const unsigned short iChannels = pPlugin->channels();
+		for (unsigned short i = 0; i < iChannels; ++i) {
+			if (ppOBuffer[i] != ppIBuffer[i])
+				::memcpy(ppOBuffer[i], ppIBuffer[i], nframes * sizeof(float));
+		}
+		return true;
+	}
+
+	// Still backing off to serial processing?
+	if (m_iSerialCycles > 0) {
+		--m_iSerialCycles;
+		return false;
+	}
+
+	// Only what fits on the worker private buffers...
+	if (nframes > m_iBufferSize
+		|| pPlugin->channels() > MaxChannels
+		|| pPlugin->audioIns() > MaxPorts
+		|| pPlugin->audioOuts() > MaxPorts)
+		return false;
+
+	// One job at a time...
+	if (!ATOMIC_TAS(&m_busy))
+		return false;
+
+	// Set up the job, then publish it as pending...
+	m_pPlugin   = pPlugin;
+	m_ppIBuffer = ppIBuffer;
+	m_ppOBuffer = ppOBuffer;
+	m_nframes   = nframes;
+	m_iCount    = iInstances;
+
+	unsigned short i;
+	for (i = 0; i < iInstances; ++i)
+		ATOMIC_SET(&m_done[i], 0);
+
+	ATOMIC_SET(&m_iDone, 0);
+	ATOMIC_CAS(&m_iPending, 0, iInstances); // ordered.
+
+	// Wake just as many workers as may help (never blocks)...
+	unsigned int iWake = iInstances - 1;
+	if (iWake > m_iThreads)
+		iWake = m_iThreads;
+	for (unsigned int k = 0; k < iWake; ++k)
+		::sem_post(&m_sem);
+
+	// Lend a hand; whatever wasn't claimed yet gets done right here...
+	work();
+
+	// Join: only instances already claimed by (real-time) workers
+	// may still be in flight; spin for them, but not forever...
+	if (ATOMIC_GET(&m_iDone) < int(iInstances)) {
+		const long long iDeadline = clock_nsecs() + m_iFrameNsecs * nframes;
+		while (ATOMIC_GET(&m_iDone) < int(iInstances)) {
+			if (clock_nsecs() > iDeadline)
+				break;
+		}
+	}
+
+	// Too late: abandon the job, go serial for a while...
+	if (ATOMIC_GET(&m_iDone) < int(iInstances)) {
+		m_iSerialCycles = m_iSerialBackoff;
+		ATOMIC_CAS(&m_abandoned, 0, 1); // ordered.
+		// No more copying back, once the ones at it are over...
+		while (!ATOMIC_CAS(&m_iWriters, 0, 0))
+			;
+		// Whatever didn't make it in time goes dry...
+		for (i = 0; i < iInstances; ++i) {
+			if (!ATOMIC_GET(&m_done[i]))
+				dryInstance(i);
+		}
+		// Last one out turns off the lights (may be us)...
+		if (ATOMIC_GET(&m_iDone) >= int(iInstances)
+			&& ATOMIC_CAS(&m_abandoned, 1, 0))
+			ATOMIC_SET(&m_busy, 0);
+		return true;
+	}
+
+	ATOMIC_SET(&m_busy, 0);
+	return true;
+}
+
+
+// Pass dry input through an instance output channels.
+void qtractorPluginInstancePool::dryInstance ( unsigned short iInstance )
+{
+	const unsigned short iChannels  = m_pPlugin->channels();
+	const unsigned short iAudioOuts = m_pPlugin->audioOuts();
+
+	unsigned short iOChannel = iInstance * iAudioOuts;
+	for (unsigned short j = 0; j < iAudioOuts && iOChannel < iChannels;
+			++j, ++iOChannel) {
+		float *pOBuffer = m_ppOBuffer[iOChannel];
+		float *pIBuffer = m_ppIBuffer[iOChannel];
+		if (pOBuffer != pIBuffer)
+			::memcpy(pOBuffer, pIBuffer, m_nframes * sizeof(float));
+	}
+}
+
+
+// Whether an abandoned job of this plugin is still running.
+bool qtractorPluginInstancePool::isAbandoned ( qtractorPlugin *pPlugin ) const
+{
+	return (ATOMIC_GET(&m_abandoned) && m_pPlugin == pPlugin);
+}
+
+
+// Wait for any abandoned job stragglers of a plugin
+// (before deactivating or dropping its instances).
+void qtractorPluginInstancePool::release ( qtractorPlugin *pPlugin )
+{
+	while (isAbandoned(pPlugin))
+		::sched_yield();
+}
+
+
+// Claim and process pending instances, if any.
+void qtractorPluginInstancePool::work ( Scratch *pScratch )
+{
+	for (;;) {
+		// Claim one pending instance, if any left...
+		int iPending;
+		do {
+			iPending = ATOMIC_GET(&m_iPending);
+			if (iPending < 1)
+				return;
+		} while (!ATOMIC_CAS(&m_iPending, iPending, iPending - 1));
+		// The job stays valid until our claim gets done...
+		const unsigned short i = m_iCount - iPending;
+		if (pScratch == NULL) {
+			// Joiner (audio thread) works in-place...
+			m_pPlugin->processInstance(i, m_ppIBuffer, m_ppOBuffer, m_nframes);
+			ATOMIC_SET(&m_done[i], 1);
+			ATOMIC_INC(&m_iDone);
+			continue;
+		}
+		// Workers run on their private buffers...
+		const unsigned short iChannels  = m_pPlugin->channels();
+		const unsigned short iAudioIns  = m_pPlugin->audioIns();
+		const unsigned short iAudioOuts = m_pPlugin->audioOuts();
+		const unsigned int nbytes = m_nframes * sizeof(float);
+		unsigned short iIChannel = i * iAudioIns;
+		unsigned short iOChannel = i * iAudioOuts;
+		unsigned short j;
+		for (j = 0; j < iAudioIns && iIChannel + j < iChannels; ++j) {
+			float *pIBuffer = &pScratch->data[j * m_iBufferSize];
+			::memcpy(pIBuffer, m_ppIBuffer[iIChannel + j], nbytes);
+			pScratch->ins[iIChannel + j] = pIBuffer;
+		}
+		for (j = 0; j < iAudioOuts && iOChannel + j < iChannels; ++j) {
+			pScratch->outs[iOChannel + j]
+				= &pScratch->data[(MaxPorts + j) * m_iBufferSize];
+		}
+		m_pPlugin->processInstance(i, pScratch->ins, pScratch->outs, m_nframes);
+		// Copy back, only if the joiner is still waiting for it...
+		ATOMIC_INC(&m_iWriters); // ordered.
+		if (!ATOMIC_GET(&m_abandoned)) {
+			for (j = 0; j < iAudioOuts && iOChannel + j < iChannels; ++j) {
+				::memcpy(m_ppOBuffer[iOChannel + j],
+					pScratch->outs[iOChannel + j], nbytes);
+			}
+			ATOMIC_SET(&m_done[i], 1);
+		}
+		ATOMIC_DEC(&m_iWriters);
+		// Last one out of an abandoned job turns off the lights...
+		if (ATOMIC_INC(&m_iDone) >= int(m_iCount)
+			&& ATOMIC_CAS(&m_abandoned, 1, 0))
+			ATOMIC_SET(&m_busy, 0);
+	}
+}
+
+
+// Worker thread executive.
+void qtractorPluginInstancePool::run (void)
+{
+	int iDenormalsState = -1;
+
+	// Our own private buffers...
+	const unsigned int iThread = ATOMIC_INC(&m_iThreadIndex) - 1;
+	Scratch *pScratch = &m_pScratch[iThread % m_iScratch];
+
+	while (ATOMIC_GET(&m_running)) {
+		// Wait for a job...
+		if (::sem_wait(&m_sem) != 0)
+			continue; // EINTR.
+		if (!ATOMIC_GET(&m_running))
+			break;
+		qtractorPluginList::updateDenormalsZero(&iDenormalsState);
+		work(pScratch);
+	}
+}
+
+
+void *qtractorPluginInstancePool::thread_func ( void *pvArg )
+{
+	qtractorPluginInstancePool *pPool
+		= static_cast<qtractorPluginInstancePool *> (pvArg);
+	if (pPool)
+		pPool->run();
+
+	return NULL;
+}
+
+
+// Pool (shared) instance management (non real-time).
+void qtractorPluginInstancePool::createInstance (void)
+{
+	QMutexLocker locker(&g_mutex);
+
+	if (getInstance())
+		return;
+
+	const int iThreads = QThread::idealThreadCount() - 1;
+	if (iThreads < 1)
+		return;
+
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession == NULL)
+		return;
+
+	qtractorAudioEngine *pAudioEngine = pSession->audioEngine();
+	if (pAudioEngine == NULL)
+		return;
+
+	jack_client_t *pJackClient = pAudioEngine->jackClient();
+	if (pJackClient == NULL)
+		return;
+
+	qtractorPluginInstancePool *pInstancePool
+		= new qtractorPluginInstancePool(pJackClient, iThreads);
+#if QT_VERSION >= 0x050000
+	g_pInstancePool.storeRelease(pInstancePool);
+#else
+	g_pInstancePool = pInstancePool;
+#endif
+}
+
+
+// Engine shutdown only (no process cycle running).
+void qtractorPluginInstancePool::deleteInstance (void)
+{
+	QMutexLocker locker(&g_mutex);
+
+	qtractorPluginInstancePool *pInstancePool = getInstance();
+	if (pInstancePool == NULL)
+		return;
+
+#if QT_VERSION >= 0x050000
+	g_pInstancePool.storeRelease(NULL);
+#else
+	g_pInstancePool = NULL;
+#endif
+
+	delete pInstancePool;
+}
+
+
+//----------------------------------------------------------------------------
+// qtractorPluginWakeThread -- Dormant plugins wake-up worker thread.
+//
+// Dormant plugins that can (LADSPA) get their spare instances
+// created over here, off the main thread; finished ones are picked
+// up later on the main thread (see qtractorPlugin::updateWakeUps)
+// where the spare instances are adopted, before any activation, so
+// that the audio thread only takes them on the next process cycle.
+
+class qtractorPluginWakeThread : public QThread
+{
+public:
+
+	// Constructor.
+	qtractorPluginWakeThread()
+		: QThread(), m_bRunState(true), m_pPlugin(NULL) {}
+
+	// Destructor.
+	~qtractorPluginWakeThread()
+	{
+		m_mutex.lock();
+		m_bRunState = false;
+		m_pending.clear();
+		m_done.clear();
+		m_cond.wakeAll();
+		m_mutex.unlock();
+
+		QThread::wait();
+	}
+
+	// Queue a plugin to prepare (main thread).
+	void queue(qtractorPlugin *pPlugin)
+	{
+		QMutexLocker locker(&m_mutex);
+
+		if (m_pPlugin != pPlugin
+			&& !m_pending.contains(pPlugin)
+			&& !m_done.contains(pPlugin)) {
+			m_pending.append(pPlugin);
+			m_cond.wakeAll();
+		}
+	}
+
+	// Whether a plugin is still waking (main thread).
+	bool isWaking(qtractorPlugin *pPlugin)
+	{
+		QMutexLocker locker(&m_mutex);
+
+		return (m_pPlugin == pPlugin
+			|| m_pending.contains(pPlugin)
+			|| m_done.contains(pPlugin));
+	}
+
+	// Drop a plugin, waiting for it if being prepared (main thread).
+	void cancel(qtractorPlugin *pPlugin)
+	{
+		QMutexLocker locker(&m_mutex);
+
+		m_pending.removeAll(pPlugin);
+		m_done.removeAll(pPlugin);
+
+		while (m_pPlugin == pPlugin)
+			m_idle.wait(&m_mutex);
+	}
+
+	// Take next finished one, if any (main thread).
+	qtractorPlugin *next()
+	{
+		QMutexLocker locker(&m_mutex);
+
+		return (m_done.isEmpty() ? NULL : m_done.takeFirst());
+	}
+
+	// The (single) wake-up thread instance.
+	static qtractorPluginWakeThread *getInstance(bool bCreate = false)
+	{
+		if (g_pWakeThread == NULL && bCreate) {
+			g_pWakeThread = new qtractorPluginWakeThread();
+			g_pWakeThread->start(QThread::LowPriority);
+		}
+
+		return g_pWakeThread;
+	}
+
+	static void deleteInstance()
+	{
+		if (g_pWakeThread) {
+			delete g_pWakeThread;
+			g_pWakeThread = NULL;
+		}
+	}
+
+protected:
+
+	// The main thread executive.
+	void run()
+	{
+		QMutexLocker locker(&m_mutex);
+
+		while (m_bRunState) {
+			if (m_pending.isEmpty()) {
+				m_cond.wait(&m_mutex);
+				continue;
+			}
+			m_pPlugin = m_pending.takeFirst();
+			m_mutex.unlock();
+			m_pPlugin->prepareInstances();
+			m_mutex.lock();
+			m_done.append(m_pPlugin);
+			m_pPlugin = NULL;
+			m_idle.wakeAll();
+		}
+	}
+
+private:
+
+	// Instance variables.
+	bool m_bRunState;
+
+	qtractorPlugin *m_pPlugin;
+
+	QList<qtractorPlugin *> m_pending;
+	QList<qtractorPlugin *> m_done;
+
+	QMutex         m_mutex;
+	QWaitCondition m_cond;
+	QWaitCondition m_idle;
+
+	// The shared thread instance (main thread only).
+	static qtractorPluginWakeThread *g_pWakeThread;
+};
+
+
+qtractorPluginWakeThread *qtractorPluginWakeThread::g_pWakeThread = NULL;
+
+
+//----------------------------------------------------------------------------
+// Output guard reports (real-time to GUI thread) ring-buffer.
+//
+// Reports carry the plugin serial number, as of the time of report;
+// live plugins are registered by serial number (main thread only),
+// so that stale reports are told apart and skipped, no matter what.
+
+static const unsigned int c_iGuardReports = 64;
+
+struct GuardReport
+{
+	qtractorPlugin *plugin;
+	unsigned int    serial;
+};
+
+static GuardReport g_aGuardReports[c_iGuardReports];
+
+static qtractorAtomic g_iGuardReportRead;
+static qtractorAtomic g_iGuardReportWrite;
+
+static QHash<qtractorPlugin *, unsigned int> g_guardSerials;
+static unsigned int g_iGuardSerial = 0;
+
+
 //----------------------------------------------------------------------------
 // qtractorPlugin -- Plugin instance.
 //
@@ -241,7 +915,8 @@ QString qtractorPlugin::g_sDefPreset = QObject::tr("(default)");
 qtractorPlugin::qtractorPlugin (
 	qtractorPluginList *pList, qtractorPluginType *pType )
 	: m_pList(pList), m_pType(pType), m_iUniqueID(0), m_iInstances(0),
-		m_bActivated(false), m_activateObserver(this),
+		m_bActivated(false), m_bDormant(false), m_bWakeActivate(false),
+		m_activateObserver(this),
 		m_iActivateSubjectIndex(0), m_pForm(NULL),
 		m_iDirectAccessParamIndex(-1)
 {
@@ -252,12 +927,31 @@ qtractorPlugin::qtractorPlugin (
 	// Activate subject properties.
 	m_activateSubject.setName(QObject::tr("Activate"));
 	m_activateSubject.setToggled(true);
+
+	// No pending parameter changes yet.
+	ATOMIC_SET(&m_paramSync, 0);
+
+	// No output guard diagnostics yet.
+	ATOMIC_SET(&m_guardCount, 0);
+	ATOMIC_SET(&m_guardReport, 0);
+
+	// Register for output guard reports (never zero)...
+	if (++g_iGuardSerial == 0)
+		++g_iGuardSerial;
+	m_iGuardSerial = g_iGuardSerial;
+	g_guardSerials.insert(this, m_iGuardSerial);
 }
 
 
 // Destructor.
 qtractorPlugin::~qtractorPlugin (void)
 {
+	// No more background wake-up...
+	cancelWakeUp();
+
+	// Any pending output guard reports are stale from now on...
+	g_guardSerials.remove(this);
+
 	// Clear out all dependables...
 	clearItems();
 
@@ -291,7 +985,249 @@ void qtractorPlugin::setInstances ( unsigned short iInstances )
 		}
 	}
 
+	// No instances may be dropped while still running...
+	releaseInstancePool();
+
 	m_iInstances = iInstances;
+
+	// Instantiated for real, whatever the path...
+	if (iInstances > 0)
+		m_bDormant = false;
+
+	// Get the parallel instance pool ready, on first need...
+	if (iInstances > 1)
+		qtractorPluginInstancePool::createInstance();
+}
+
+
+// Parallel instance processing pool cleanup (static).
+void qtractorPlugin::deleteInstancePool (void)
+{
+	qtractorPluginInstancePool::deleteInstance();
+}
+
+
+// Wait for any parallel instances still running (stragglers).
+void qtractorPlugin::releaseInstancePool (void)
+{
+	qtractorPluginInstancePool *pInstancePool
+		= qtractorPluginInstancePool::getInstance();
+	if (pInstancePool)
+		pInstancePool->release(this);
+}
+
+
+// Dormant plugins background wake-up completion (main thread).
+void qtractorPlugin::updateWakeUps (void)
+{
+	qtractorPluginWakeThread *pWakeThread
+		= qtractorPluginWakeThread::getInstance();
+	if (pWakeThread == NULL)
+		return;
+
+	qtractorPlugin *pPlugin = pWakeThread->next();
+	while (pPlugin) {
+		pPlugin->setDormant(false);
+		pPlugin = pWakeThread->next();
+	}
+}
+
+
+// Dormant plugins wake-up thread cleanup (static).
+void qtractorPlugin::deleteWakeThread (void)
+{
+	qtractorPluginWakeThread::deleteInstance();
+}
+
+
+// Wake up from dormant state in the background, if possible.
+bool qtractorPlugin::wakeUp (void)
+{
+	if (!m_bDormant || !canPrepareInstances() || channels() < 1)
+		return false;
+
+	qtractorPluginWakeThread *pWakeThread
+		= qtractorPluginWakeThread::getInstance(true);
+	if (pWakeThread == NULL)
+		return false;
+
+	pWakeThread->queue(this);
+	return true;
+}
+
+
+// Drop any background wake-up, waiting for it if in progress.
+void qtractorPlugin::cancelWakeUp (void)
+{
+	qtractorPluginWakeThread *pWakeThread
+		= qtractorPluginWakeThread::getInstance();
+	if (pWakeThread)
+		pWakeThread->cancel(this);
+}
+
+
+// Parallel instance processing dispatcher (join on return, dry on time-out).
+bool qtractorPlugin::processInstances (
+	float **ppIBuffer, float **ppOBuffer, unsigned int nframes )
+{
+	qtractorPluginInstancePool *pInstancePool
+		= qtractorPluginInstancePool::getInstance();
+	if (pInstancePool == NULL)
+		return false;
+
+	if (!pInstancePool->process(this, ppIBuffer, ppOBuffer, nframes))
+		return false;
+
+	// Wrap dangling output channels?...
+	const unsigned short iChannels = channels();
+	unsigned int iOChannel = m_iInstances * audioOuts();
+	for ( ; iOChannel < iChannels; ++iOChannel)
+		::memset(ppOBuffer[iOChannel], 0, nframes * sizeof(float));
+
+	return true;
+}
+
+
+// Parameter change queue (lock-free).
+void qtractorPlugin::queueParam ( qtractorPluginParam *pParam,
+	float fValue, unsigned long iOffset )
+{
+	// Always let it go through the queue, never applying it right
+	// away, as activation might be just about to happen elsewhere;
+	// it's drained by the audio thread or else on (re)activation.
+	// On overflow, ask for a full resync later.
+	if (!m_paramQueue.push(pParam, fValue, iOffset))
+		ATOMIC_SET(&m_paramSync, 1);
+}
+
+
+// Apply all pending parameter changes, iif. not activated
+// (non real-time, same thread as activation).
+void qtractorPlugin::flushParams (void)
+{
+	if (!m_bActivated)
+		process_params(0);
+}
+
+
+// Apply all pending parameter changes (real-time thread).
+void qtractorPlugin::process_params ( unsigned int nframes )
+{
+	Params::ConstIterator param;
+	const Params::ConstIterator& param_end = m_params.constEnd();
+
+	// Have we missed anything? resync all...
+	if (ATOMIC_TAZ(&m_paramSync)) {
+		for (param = m_params.constBegin(); param != param_end; ++param) {
+			qtractorPluginParam *pParam = param.value();
+			processParam(pParam, pParam->subject()->value(), 0);
+		}
+	}
+
+	// Pending changes, in order...
+	qtractorPluginParamQueue::Event event;
+	while (m_paramQueue.pop(event)) {
+		if (event.offset >= nframes)
+			event.offset = (nframes > 0 ? nframes - 1 : 0);
+		processParam(event.param, event.value, event.offset);
+	}
+
+	// Automation curves are processed in this very same thread,
+	// just before us, so their subject values are safe to poll...
+	qtractorCurveList *pCurveList = m_pList->curveList();
+	if (pCurveList && pCurveList->isProcess()) {
+		for (param = m_params.constBegin(); param != param_end; ++param) {
+			qtractorPluginParam *pParam = param.value();
+			qtractorSubject *pSubject = pParam->subject();
+			qtractorCurve *pCurve = pSubject->curve();
+			if (pCurve && pCurve->isProcess()
+				&& *pParam->data() != pSubject->value())
+				processParam(pParam, pSubject->value(), 0);
+		}
+	}
+}
+
+
+// Output guard stage scan: flush denormals in-place and
+// tell whether there's any NaN/Inf value (real-time thread).
+//
+// All tests are made on the IEEE-754 bits (integer domain),
+// as floating-point ones are unreliable under -ffast-math:
+// an all-ones exponent is either NaN or Inf, a zero one is
+// either zero or denormal.
+static inline bool qtractor_plugin_guard_scan (
+	float *pFrames, unsigned int nframes )
+{
+	const unsigned int c_iExpMask = 0x7f800000;
+
+	unsigned int i = 0;
+	bool bNaN = false;
+
+#if defined(__SSE2__)
+	const __m128i vexp  = _mm_set1_epi32(int(c_iExpMask));
+	const __m128i vabs  = _mm_set1_epi32(0x7fffffff);
+	const __m128i vzero = _mm_setzero_si128();
+	__m128i vnan = _mm_setzero_si128();
+	for (; i + 4 <= nframes; i += 4) {
+		const __m128i v = _mm_loadu_si128((const __m128i *) (pFrames + i));
+		const __m128i e = _mm_and_si128(v, vexp);
+		// All-ones exponent: NaN or Inf...
+		vnan = _mm_or_si128(vnan, _mm_cmpeq_epi32(e, vexp));
+		// Zero exponent, non-zero value: flush denormals to (signed) zero...
+		const __m128i vden = _mm_andnot_si128(
+			_mm_cmpeq_epi32(_mm_and_si128(v, vabs), vzero),
+			_mm_cmpeq_epi32(e, vzero));
+		if (_mm_movemask_epi8(vden)) {
+			_mm_storeu_si128((__m128i *) (pFrames + i),
+				_mm_andnot_si128(_mm_and_si128(vden, vabs), v));
+		}
+	}
+	bNaN = (_mm_movemask_epi8(vnan) != 0);
+#endif
+
+	for (; i < nframes; ++i) {
+		unsigned int x;
+		::memcpy(&x, &pFrames[i], sizeof(x));
+		const unsigned int e = (x & c_iExpMask);
+		if (e == c_iExpMask)
+			bNaN = true;
+		else
+		if (e == 0 && (x & 0x7fffffff)) {
+			x &= 0x80000000;
+			::memcpy(&pFrames[i], &x, sizeof(x));
+		}
+	}
+
+	return bNaN;
+}
+
+
+// Output guard stage: flush denormals and mute the whole
+// output on any NaN/Inf value (real-time thread).
+bool qtractorPlugin::process_guard ( float **ppBuffer, unsigned int nframes )
+{
+	const unsigned short iChannels = channels();
+
+	bool bNaN = false;
+	for (unsigned short i = 0; i < iChannels; ++i) {
+		if (qtractor_plugin_guard_scan(ppBuffer[i], nframes))
+			bNaN = true;
+	}
+
+	if (!bNaN)
+		return false;
+
+	// Mute it all, not passing garbage downstream...
+	for (unsigned short i = 0; i < iChannels; ++i)
+		::memset(ppBuffer[i], 0, nframes * sizeof(float));
+
+	ATOMIC_INC(&m_guardCount);
+
+	// Report it, once per activation...
+	if (ATOMIC_TAS(&m_guardReport))
+		qtractorPluginList::guardReportAdd(this);
+
+	return true;
 }
 
 
@@ -318,17 +1254,77 @@ bool qtractorPlugin::isActivated (void) const
 void qtractorPlugin::updateActivated ( bool bActivated )
 {
 	if (bActivated && !m_bActivated) {
+		// Instantiate for real, if left dormant; in the background
+		// if possible, activation being deferred until done...
+		if (wakeUp()) {
+			m_bWakeActivate = true;
+			return;
+		}
+		setDormant(false);
+		// Fresh start, fresh output guard report...
+		ATOMIC_SET(&m_guardReport, 0);
+		// Catch up with changes made while deactivated...
+		flushParams();
 		activate();
 		m_pList->updateActivated(true);
 	} else if (!bActivated && m_bActivated) {
+		// No instances may be deactivated while still running...
+		releaseInstancePool();
 		deactivate();
 		m_pList->updateActivated(false);
 	}
 
+	if (!bActivated)
+		m_bWakeActivate = false;
+
 	m_bActivated = bActivated;
 }
 
 
+// Lazy instantiation (dormant) methods.
+void qtractorPlugin::setDormant ( bool bDormant )
+{
+	if (bDormant) {
+		if (m_bDormant)
+			return;
+		m_bDormant = true;
+		// Parameter values are kept on hand as usual,
+		// while configuration stays pending (unrealized)...
+		realizeValues();
+		releaseValues();
+		return;
+	}
+
+	// Any background wake-up must be over by now...
+	cancelWakeUp();
+
+	if (m_bDormant) {
+		m_bDormant = false;
+		if (channels() > 0) {
+			// Instantiate now (adopting any spare instances prepared
+			// in the background) while still deactivated, so that
+			// the audio thread only picks it up when activated,
+			// on the very next process cycle...
+			const float fActivated = m_activateSubject.value();
+			freezeValues();
+			setChannels(channels());
+			// Restore activation state, which might
+			// have been reset while instantiating...
+			m_activateObserver.setValue(fActivated);
+		}
+	}
+
+	// Unused spare instances are of no use anymore...
+	releaseInstances();
+
+	// Deferred activation, if any...
+	if (m_bWakeActivate) {
+		m_bWakeActivate = false;
+		updateActivated(true);
+	}
+}
+
+
 void qtractorPlugin::updateActivatedEx ( bool bActivated )
 {
 	updateActivated(bActivated);
@@ -459,6 +1455,9 @@ void qtractorPlugin::clearItems (void)
 // Special plugin form methods.
 void qtractorPlugin::openForm ( QWidget *pParent )
 {
+	// Can't really show up while dormant...
+	setDormant(false);
+
 	// Take the change and create the form if it doesn't current exist.
 	const bool bCreate = (m_pForm == NULL);
 
@@ -726,6 +1725,9 @@ bool qtractorPlugin::loadPresetEx ( const QString& sPreset )
 	if (pMainForm == NULL)
 		return false;
 
+	// Presets are meant for the real thing...
+	setDormant(false);
+
 	if (sPreset.isEmpty() || sPreset == g_sDefPreset) {
 		// Reset to default...
 		return pSession->execute(new qtractorResetPluginCommand(this));
@@ -1139,6 +2141,7 @@ void qtractorPlugin::saveCurveFile ( qtractorDocument *pDocument,
 			pCurveItem->locked = pCurve->isLocked();
 			pCurveItem->logarithmic = pCurve->isLogarithmic();
 			pCurveItem->color = pCurve->color();
+			pCurveItem->tolerance = pCurve->tolerance();
 			pCurveItem->subject = pCurve->subject();
 			pCurveFile->addItem(pCurveItem);
 			++iParam;
@@ -1163,6 +2166,7 @@ void qtractorPlugin::saveCurveFile ( qtractorDocument *pDocument,
 		pCurveItem->locked = pCurve->isLocked();
 		pCurveItem->logarithmic = pCurve->isLogarithmic();
 		pCurveItem->color = pCurve->color();
+		pCurveItem->tolerance = pCurve->tolerance();
 		pCurveItem->subject = pCurve->subject();
 		pCurveFile->addItem(pCurveItem);
 	}
@@ -1177,7 +2181,8 @@ void qtractorPlugin::saveCurveFile ( qtractorDocument *pDocument,
 	sBaseName += QString::number(uniqueID(), 16);
 	sBaseName += "_curve";
 //	int iClipNo = (pCurveFile->filename().isEmpty() ? 0 : 1);
-	pCurveFile->setFilename(pSession->createFilePath(sBaseName, "mid", 1));
+	pCurveFile->setFilename(pSession->createFilePath(
+		sBaseName, qtractorCurveFile::defaultExt(), 1));
 
 	pCurveFile->save(pDocument, pElement, pSession->timeScale());
 }
@@ -1259,6 +2264,9 @@ void qtractorPluginParam::setValue ( float fValue, bool bUpdate )
 
 	m_observer.setValue(fValue);
 
+	// Let the plugin ports have it (lock-free)...
+	m_pPlugin->queueParam(this, m_subject.value());
+
 	// Update specifics.
 	if (bUpdate) m_pPlugin->updateParam(this, fValue, true);
 
@@ -1298,6 +2306,7 @@ void qtractorPluginParam::Observer::update ( bool bUpdate )
 	qtractorPlugin *pPlugin = m_pParam->plugin();
 	if (bUpdate && pPlugin->directAccessParamIndex() == long(m_pParam->index()))
 		pPlugin->updateDirectAccessParam();
+	pPlugin->queueParam(m_pParam, qtractorMidiControlObserver::value());
 	pPlugin->updateParam(m_pParam, qtractorMidiControlObserver::value(), bUpdate);
 }
 
@@ -1312,7 +2321,7 @@ qtractorPluginList::qtractorPluginList (
 	: m_iChannels(iChannels), m_iFlags(iFlags),
 		m_iActivated(0), m_pMidiManager(NULL),
 		m_iMidiBank(-1), m_iMidiProg(-1),
-		m_pMidiProgramSubject(NULL)
+		m_iLatency(0), m_pMidiProgramSubject(NULL)
 {
 	setAutoDelete(true);
 
@@ -1427,6 +2436,9 @@ void qtractorPluginList::setChannelsEx (
 	// Go, go, go...
 	m_iChannels = iChannels;
 
+	// Latency compensation delay-line...
+	m_latencyDelay.setChannels(m_iChannels);
+
 	qtractorSession *pSession = qtractorSession::getInstance();
 	if (pSession == NULL)
 		return;
@@ -1449,6 +2461,9 @@ void qtractorPluginList::setChannelsEx (
 	// Reset all plugin chain channels...
 	for (qtractorPlugin *pPlugin = first();
 			pPlugin; pPlugin = pPlugin->next()) {
+		// Dormant ones will be instantiated when activated...
+		if (pPlugin->isDormant())
+			continue;
 		if (bReset && m_iChannels > 0) {
 			pPlugin->freezeConfigs();
 			pPlugin->freezeValues();
@@ -1464,6 +2479,18 @@ void qtractorPluginList::setChannelsEx (
 }
 
 
+// Instantiate dormant plugins with automated activation,
+// before their curves get to be processed in real-time.
+void qtractorPluginList::wakeAutomated (void)
+{
+	for (qtractorPlugin *pPlugin = first();
+			pPlugin; pPlugin = pPlugin->next()) {
+		if (pPlugin->isDormant() && (pPlugin->activateSubject())->curve())
+			pPlugin->setDormant(false);
+	}
+}
+
+
 // Reset and (re)activate all plugin chain.
 void qtractorPluginList::resetBuffers (void)
 {
@@ -1494,6 +2521,9 @@ void qtractorPluginList::resetBuffers (void)
 		for (unsigned short i = 0; i < m_iChannels; ++i)
 			::memset(m_pppBuffers[1][i], 0, iBufferSize * sizeof(float));
 	}
+
+	// Reset latency compensation delay-line...
+	m_latencyDelay.reset();
 #if 0
 	// Restore activation of all previously deactivated plugins...
 	for (qtractorPlugin *pPlugin = first();
@@ -1520,8 +2550,10 @@ void qtractorPluginList::addPlugin ( qtractorPlugin *pPlugin )
 void qtractorPluginList::insertPlugin (
 	qtractorPlugin *pPlugin, qtractorPlugin *pNextPlugin )
 {
-	// We'll get prepared before plugging it in...
-	pPlugin->setChannels(m_iChannels);
+	// We'll get prepared before plugging it in
+	// (dormant ones get instantiated when activated)...
+	if (!pPlugin->isDormant())
+		pPlugin->setChannels(m_iChannels);
 
 	if (pNextPlugin)
 		insertBefore(pPlugin, pNextPlugin);
@@ -1588,7 +2620,8 @@ void qtractorPluginList::movePlugin (
 		}
 		// Now for the real thing...
 		pPlugin->setPluginList(this);
-		pPlugin->setChannels(channels());
+		if (!pPlugin->isDormant())
+			pPlugin->setChannels(channels());
 		if (pPlugin->isActivated()) {
 			pPluginList->updateActivated(false);
 			updateActivated(true);
@@ -1638,7 +2671,8 @@ qtractorPlugin *qtractorPluginList::copyPlugin ( qtractorPlugin *pPlugin )
 
 	// Clone the plugin instance...
 	pPlugin->freezeValues();
-	pPlugin->freezeConfigs();
+	if (!pPlugin->isDormant())
+		pPlugin->freezeConfigs();
 
 #if 0
 	// MIDI bank program whether necessary...
@@ -1668,7 +2702,8 @@ qtractorPlugin *qtractorPluginList::copyPlugin ( qtractorPlugin *pPlugin )
 			pPlugin->directAccessParamIndex());
 	}
 
-	pPlugin->releaseConfigs();
+	if (!pPlugin->isDormant())
+		pPlugin->releaseConfigs();
 	pPlugin->releaseValues();
 
 	return pNewPlugin;
@@ -1714,8 +2749,13 @@ void qtractorPluginList::process ( float **ppBuffer, unsigned int nframes )
 		// Set proper buffers for this plugin...
 		float **ppIBuffer = m_pppBuffers[  iBuffer & 1];
 		float **ppOBuffer = m_pppBuffers[++iBuffer & 1];
+		// Pending parameter changes go first...
+		pPlugin->process_params(nframes);
 		// Time for the real thing...
 		pPlugin->process(ppIBuffer, ppOBuffer, nframes);
+		// Optional output guard stage...
+		if (g_bGuardEnabled)
+			pPlugin->process_guard(ppOBuffer, nframes);
 	}
 
 	// Now for the output buffer commitment...
@@ -1728,6 +2768,133 @@ void qtractorPluginList::process ( float **ppBuffer, unsigned int nframes )
 }
 
 
+// Plugin-chain latency (in frames; cached on update).
+unsigned long qtractorPluginList::updateLatency (void)
+{
+	m_iLatency = 0;
+
+	if (isActivated()) {
+		for (qtractorPlugin *pPlugin = first();
+				pPlugin; pPlugin = pPlugin->next()) {
+			if (pPlugin->isActivated())
+				m_iLatency += pPlugin->latency();
+		}
+	}
+
+	return m_iLatency;
+}
+
+
+// Plugin-chain latency downstream from a given plugin.
+unsigned long qtractorPluginList::latencyAfter ( qtractorPlugin *pPlugin ) const
+{
+	unsigned long iLatency = 0;
+
+	if (pPlugin)
+		pPlugin = pPlugin->next();
+
+	for ( ; pPlugin; pPlugin = pPlugin->next()) {
+		if (pPlugin->isActivated())
+			iLatency += pPlugin->latency();
+	}
+
+	return iLatency;
+}
+
+
+// Latency compensation: delays the plugin-chain output
+// so that it aligns to the given (maximum) path latency.
+void qtractorPluginList::process_latency ( float **ppBuffer,
+	unsigned int nframes, unsigned long iPathLatency )
+{
+	if (m_latencyDelay.channels() != m_iChannels)
+		return;
+
+	const unsigned long iDelay
+		= (iPathLatency > m_iLatency ? iPathLatency - m_iLatency : 0);
+
+	m_latencyDelay.process(ppBuffer, nframes, iDelay);
+}
+
+
+// Plugin output guard stage (global) option.
+bool qtractorPluginList::g_bGuardEnabled = false;
+
+void qtractorPluginList::setGuardEnabled ( bool bGuardEnabled )
+{
+	g_bGuardEnabled = bGuardEnabled;
+}
+
+bool qtractorPluginList::isGuardEnabled (void)
+{
+	return g_bGuardEnabled;
+}
+
+
+// Flush-to-zero/denormals-are-zero (calling thread) while the
+// output guard is enabled; previous state is restored otherwise.
+// The state holder must start as -1 (nothing saved).
+void qtractorPluginList::updateDenormalsZero ( int *piDenormalsState )
+{
+#if defined(__SSE__)
+#if defined(__SSE2__)
+	const unsigned int iMask = 0x8040;	// FTZ | DAZ
+#else
+	const unsigned int iMask = 0x8000;	// FTZ only
+#endif
+	if (g_bGuardEnabled) {
+		if (*piDenormalsState < 0) {
+			const unsigned int iCsr = _mm_getcsr();
+			*piDenormalsState = int(iCsr & iMask);
+			_mm_setcsr(iCsr | iMask);
+		}
+	}
+	else
+	if (*piDenormalsState >= 0) {
+		_mm_setcsr((_mm_getcsr() & ~iMask) | (unsigned int) *piDenormalsState);
+		*piDenormalsState = -1;
+	}
+#else
+	(void) piDenormalsState;
+#endif
+}
+
+
+// Report a plugin caught by the output guard (real-time thread).
+void qtractorPluginList::guardReportAdd ( qtractorPlugin *pPlugin )
+{
+	const unsigned int w = ATOMIC_GET(&g_iGuardReportWrite);
+	const unsigned int w1 = (w + 1) & (c_iGuardReports - 1);
+	if (w1 != (unsigned int) ATOMIC_GET(&g_iGuardReportRead)) {
+		GuardReport *pReport = &g_aGuardReports[w];
+		pReport->plugin = pPlugin;
+		pReport->serial = pPlugin->guardSerial();
+		ATOMIC_SET(&g_iGuardReportWrite, w1);
+	}
+}
+
+
+// Next plugin caught by the output guard, if any (GUI thread);
+// reports of plugins gone in the meantime are just skipped.
+qtractorPlugin *qtractorPluginList::guardReport (void)
+{
+	qtractorPlugin *pPlugin = NULL;
+
+	unsigned int r = ATOMIC_GET(&g_iGuardReportRead);
+	const unsigned int w = ATOMIC_GET(&g_iGuardReportWrite);
+	while (pPlugin == NULL && r != w) {
+		const GuardReport *pReport = &g_aGuardReports[r];
+		if (g_guardSerials.value(pReport->plugin, 0) == pReport->serial)
+			pPlugin = pReport->plugin;
+		r = (r + 1) & (c_iGuardReports - 1);
+	}
+
+	ATOMIC_SET(&g_iGuardReportRead, r);
+
+	return pPlugin;
+}
+
+
 // Document element methods.
 bool qtractorPluginList::loadElement (
 	qtractorDocument *pDocument, QDomElement *pElement )
@@ -1740,6 +2907,10 @@ bool qtractorPluginList::loadElement (
 	m_sAudioOutputBusName.clear();
 	m_audioOutputs.clear();
 
+	// Lazy instantiation of deactivated plugins?
+	qtractorOptions *pOptions = qtractorOptions::getInstance();
+	const bool bLazyLoad = (pOptions && pOptions->bPluginLazyLoad);
+
 	// Load plugin-list children...
 	for (QDomNode nPlugin = pElement->firstChild();
 			!nPlugin.isNull();
@@ -1877,6 +3048,12 @@ bool qtractorPluginList::loadElement (
 				pPlugin->setActivated(bActivated); // Later's better!
 				pPlugin->setEditorPos(posEditor);
 				pPlugin->setFormPos(posForm);
+				// Deactivated ones may be left dormant, if not yet
+				// instantiated, until activated for the first time
+				// (insert pseudo-plugins are always instantiated)...
+				if (!bActivated && bLazyLoad && !sFilename.isEmpty()
+					&& pPlugin->instances() < 1)
+					pPlugin->setDormant(true);
 			} else {
 				qtractorMessageList::append(
 					QObject::tr("%1(%2): %3 plugin not found.")
@@ -1933,8 +3110,10 @@ bool qtractorPluginList::saveElement ( qtractorDocument *pDocument,
 		// Freeze form position, if currently visible...
 		pPlugin->freezeFormPos();
 
-		// Do freeze plugin state...
-		pPlugin->freezeConfigs();
+		// Do freeze plugin state, unless still dormant...
+		const bool bDormant = pPlugin->isDormant();
+		if (!bDormant)
+			pPlugin->freezeConfigs();
 
 		// Create the new plugin element...
 		QDomElement ePlugin = pDocument->document()->createElement("plugin");
@@ -2007,7 +3186,8 @@ bool qtractorPluginList::saveElement ( qtractorDocument *pDocument,
 		pElement->appendChild(ePlugin);
 
 		// May release plugin state...
-		pPlugin->releaseConfigs();
+		if (!bDormant)
+			pPlugin->releaseConfigs();
 	}
 
 	// Save audio output-bus connects...
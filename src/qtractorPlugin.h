@@ -26,6 +26,10 @@
 
 #include "qtractorMidiControlObserver.h"
 
+#include "qtractorAudioDelay.h"
+
+#include "qtractorAtomic.h"
+
 #include <QLibrary>
 
 #include <QStringList>
@@ -225,7 +229,7 @@ public:
 
 	// Constructor.
 	qtractorPluginParam(qtractorPlugin *pPlugin, unsigned long iIndex)
-		: m_pPlugin(pPlugin), m_iIndex(iIndex),
+		: m_pPlugin(pPlugin), m_iIndex(iIndex), m_fPortValue(0.0f),
 			m_subject(0.0f), m_observer(this), m_iDecimals(-1) {}
 
 	// Virtual destructor.
@@ -288,6 +292,9 @@ public:
 	// Direct parameter subject value.
 	qtractorSubject *subject() { return &m_subject; }
 
+	// Direct port value address (real-time side only).
+	float *data() { return &m_fPortValue; }
+
 	// Specialized observer value.
 	qtractorMidiControlObserver *observer() { return &m_observer; }
 
@@ -301,6 +308,9 @@ private:
 	qtractorPlugin *m_pPlugin;
 	unsigned long   m_iIndex;
 
+	// Actual port value, as seen by the plugin.
+	float m_fPortValue;
+
 	// Port subject value.
 	qtractorSubject m_subject;
 
@@ -329,6 +339,103 @@ private:
 };
 
 
+//----------------------------------------------------------------------------
+// qtractorPluginParamQueue -- Plugin parameter change (lock-free) queue.
+//
+// Many producers (GUI, MIDI controllers, automation) vs. one consumer
+// (the audio thread, at the start of each plugin process cycle).
+
+class qtractorPluginParamQueue
+{
+public:
+
+	// Minimum queue size.
+	enum { MinQueueSize = 0x100 };
+
+	// Queue item.
+	struct Event
+	{
+		qtractorPluginParam *param;
+		float value;
+		unsigned long offset; // frame offset in current period.
+	};
+
+	// Constructor.
+	qtractorPluginParamQueue(unsigned int iQueueSize = MinQueueSize)
+		: m_pSlots(NULL), m_iQueueSize(0), m_iQueueMask(0), m_iReadIndex(0)
+	{
+		// Adjust size to nearest power-of-two, if necessary.
+		m_iQueueSize = MinQueueSize;
+		while (m_iQueueSize < iQueueSize)
+			m_iQueueSize <<= 1;
+		m_iQueueMask = (m_iQueueSize - 1);
+		m_pSlots = new Slot [m_iQueueSize];
+		for (unsigned int i = 0; i < m_iQueueSize; ++i)
+			ATOMIC_SET(&m_pSlots[i].seq, int(i));
+		ATOMIC_SET(&m_iWriteIndex, 0);
+	}
+
+	// Destructor.
+	~qtractorPluginParamQueue() { delete [] m_pSlots; }
+
+	// Enqueue a change (any thread); false when full.
+	bool push(qtractorPluginParam *pParam, float fValue,
+		unsigned long iOffset = 0)
+	{
+		Slot *pSlot;
+		unsigned int iWriteIndex;
+		for (;;) {
+			iWriteIndex = ATOMIC_GET(&m_iWriteIndex);
+			pSlot = &m_pSlots[iWriteIndex & m_iQueueMask];
+			const int iDiff = int(ATOMIC_GET(&pSlot->seq) - iWriteIndex);
+			if (iDiff < 0)
+				return false;
+			if (iDiff == 0 && ATOMIC_CAS(&m_iWriteIndex,
+					iWriteIndex, iWriteIndex + 1))
+				break;
+		}
+		pSlot->event.param  = pParam;
+		pSlot->event.value  = fValue;
+		pSlot->event.offset = iOffset;
+		// Publish (ordered)...
+		ATOMIC_CAS(&pSlot->seq, iWriteIndex, iWriteIndex + 1);
+		return true;
+	}
+
+	// Dequeue next change (real-time thread only).
+	bool pop(Event& event)
+	{
+		const unsigned int iReadIndex = m_iReadIndex;
+		Slot *pSlot = &m_pSlots[iReadIndex & m_iQueueMask];
+		if (!ATOMIC_CAS(&pSlot->seq, iReadIndex + 1, iReadIndex + 1))
+			return false;
+		event = pSlot->event;
+		// Recycle (ordered)...
+		ATOMIC_CAS(&pSlot->seq, iReadIndex + 1, iReadIndex + m_iQueueSize);
+		m_iReadIndex = iReadIndex + 1;
+		return true;
+	}
+
+private:
+
+	// Queue slot.
+	struct Slot
+	{
+		qtractorAtomic seq;
+		Event event;
+	};
+
+	// Instance variables.
+	Slot *m_pSlots;
+
+	unsigned int m_iQueueSize;
+	unsigned int m_iQueueMask;
+
+	qtractorAtomic m_iWriteIndex;
+	unsigned int   m_iReadIndex;
+};
+
+
 //----------------------------------------------------------------------------
 // qtractorPlugin -- Plugin instance.
 //
@@ -366,6 +473,25 @@ public:
 	void setActivatedEx(bool bActivated);
 	bool isActivated() const;
 
+	// Lazy instantiation (dormant) methods;
+	// dormant plugins hold no instances whatsoever,
+	// only their configuration and parameter values.
+	void setDormant(bool bDormant);
+	bool isDormant() const
+		{ return m_bDormant; }
+
+	// Background instantiation support (dormant wake-up):
+	// spare instances may be created off the main thread
+	// (prepare) to be adopted later on (setChannels).
+	virtual bool canPrepareInstances() const { return false; }
+	virtual void prepareInstances() {}
+	virtual void releaseInstances() {}
+
+	// Dormant plugins background wake-up completion (main thread).
+	static void updateWakeUps();
+	// Dormant plugins wake-up thread cleanup.
+	static void deleteWakeThread();
+
 	// Activate subject accessors.
 	qtractorSubject *activateSubject()
 		{ return &m_activateSubject; }
@@ -432,10 +558,36 @@ public:
 	virtual void process(
 		float **ppIBuffer, float **ppOBuffer, unsigned int nframes) = 0;
 
+	// Plugin latency (in frames), as reported by the plugin itself.
+	virtual unsigned long latency() const { return 0; }
+
 	// Parameter update method.
 	virtual void updateParam(
 		qtractorPluginParam */*pParam*/, float /*fValue*/, bool /*bUpdate*/) {}
 
+	// Parameter change queue (lock-free).
+	void queueParam(qtractorPluginParam *pParam, float fValue,
+		unsigned long iOffset = 0);
+
+	// Apply all pending parameter changes (real-time thread).
+	void process_params(unsigned int nframes);
+
+	// Apply all pending parameter changes, iif. not activated
+	// (non real-time, same thread as activation).
+	void flushParams();
+
+	// Output guard stage: flush denormals and mute the whole
+	// output on any NaN/Inf value (real-time thread).
+	bool process_guard(float **ppBuffer, unsigned int nframes);
+
+	// Output guard diagnostics (number of muted cycles).
+	int guardCount() const
+		{ return ATOMIC_GET(&m_guardCount); }
+
+	// Output guard report serial number.
+	unsigned int guardSerial() const
+		{ return m_iGuardSerial; }
+
 	// Specific MIDI instrument selector.
 	virtual void selectProgram(int /*iBank*/, int /*iProg*/) {}
 
@@ -644,15 +796,42 @@ public:
 	// Parameter update executive.
 	void updateParamValue(unsigned long iIndex, float fValue, bool bUpdate);
 
+	// Parallel instance processing pool cleanup (engine shutdown).
+	static void deleteInstancePool();
+
 protected:
 
 	// Instance number settler.
 	void setInstances(unsigned short iInstances);
 
+	// Parallel instance processing dispatcher (join on return, dry on time-out);
+	// returns false whenever the caller should process serially.
+	bool processInstances(
+		float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
+
+	// Single instance processing procedure (parallel dispatch).
+	virtual void processInstance(unsigned short /*iInstance*/,
+		float **/*ppIBuffer*/, float **/*ppOBuffer*/, unsigned int /*nframes*/) {}
+
+	friend class qtractorPluginInstancePool;
+
+	// Real-time parameter change applier.
+	virtual void processParam(qtractorPluginParam *pParam,
+		float fValue, unsigned long /*iOffset*/)
+		{ *pParam->data() = fValue; }
+
 	// Activation stabilizers.
 	void updateActivated(bool bActivated);
 	void updateActivatedEx(bool bActivated);
 
+	// Wait for any parallel instances still running (stragglers).
+	void releaseInstancePool();
+
+	// Wake up from dormant state in the background, if possible...
+	bool wakeUp();
+	// ...or drop it, waiting for it if in progress.
+	void cancelWakeUp();
+
 private:
 
 	// Instance variables.
@@ -668,6 +847,12 @@ private:
 	// Activation flag.
 	bool m_bActivated;
 
+	// Lazy instantiation (dormant) flag.
+	bool m_bDormant;
+
+	// Activation deferred to background wake-up.
+	bool m_bWakeActivate;
+
 	// Activate subject value.
 	qtractorSubject m_activateSubject;
 
@@ -697,6 +882,19 @@ private:
 	// List of input control ports (parameters).
 	Params m_params;
 
+	// Pending parameter changes.
+	qtractorPluginParamQueue m_paramQueue;
+
+	// Whether all parameters need a full resync (queue overflow).
+	qtractorAtomic m_paramSync;
+
+	// Output guard diagnostics (muted cycles and report state).
+	qtractorAtomic m_guardCount;
+	qtractorAtomic m_guardReport;
+
+	// Output guard report serial number (unique).
+	unsigned int m_iGuardSerial;
+
 	// List of parameters (by name).
 	ParamNames m_paramNames;
 
@@ -773,6 +971,9 @@ public:
 	// Reset and (re)activate all plugin chain.
 	void resetBuffers();
 
+	// Instantiate dormant plugins with automated activation.
+	void wakeAutomated();
+
 	// Brainless accessors.
 	unsigned short channels() const { return m_iChannels; }
 	unsigned int flags()      const { return m_iFlags; }
@@ -824,6 +1025,37 @@ public:
 	// The meta-main audio-processing plugin-chain procedure.
 	void process(float **ppBuffer, unsigned int nframes);
 
+	// Plugin-chain latency (in frames; cached on update).
+	unsigned long updateLatency();
+	unsigned long latency() const
+		{ return m_iLatency; }
+
+	// Plugin-chain latency downstream from a given plugin.
+	unsigned long latencyAfter(qtractorPlugin *pPlugin) const;
+
+	// Latency compensation: delays the plugin-chain output
+	// so that it aligns to the given (maximum) path latency.
+	void process_latency(float **ppBuffer,
+		unsigned int nframes, unsigned long iPathLatency);
+
+	// Current latency compensation delay (in frames).
+	unsigned long latencyDelay() const
+		{ return m_latencyDelay.delay(); }
+
+	// Plugin output guard stage (global) option.
+	static void setGuardEnabled(bool bGuardEnabled);
+	static bool isGuardEnabled();
+
+	// Flush-to-zero/denormals-are-zero (calling thread) while the
+	// output guard is enabled; previous state is restored otherwise.
+	static void updateDenormalsZero(int *piDenormalsState);
+
+	// Next plugin caught by the output guard, if any (GUI thread).
+	static qtractorPlugin *guardReport();
+
+	// Report a plugin caught by the output guard (real-time thread).
+	static void guardReportAdd(qtractorPlugin *pPlugin);
+
 	// Document element methods.
 	bool loadElement(qtractorDocument *pDocument, QDomElement *pElement);
 	bool saveElement(qtractorDocument *pDocument, QDomElement *pElement);
@@ -952,11 +1184,19 @@ private:
 	// Internal running buffer chain references.
 	float **m_pppBuffers[2];
 
+	// Plugin-chain latency and compensation delay-line.
+	unsigned long m_iLatency;
+
+	qtractorAudioDelay m_latencyDelay;
+
 	// MIDI bank/program observable subject.
 	MidiProgramSubject *m_pMidiProgramSubject;
 
 	// Plugin registry (chain unique ids.)
 	QHash<unsigned long, unsigned int> m_uniqueIDs;
+
+	// Plugin output guard stage (global) option.
+	static bool g_bGuardEnabled;
 };
 
 
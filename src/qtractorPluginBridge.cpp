@@ -0,0 +1,419 @@
+// qtractorPluginBridge.cpp
+//
+/****************************************************************************
+   Copyright (C) 2005-2016, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "qtractorAbout.h"
+
+#ifdef CONFIG_PLUGIN_BRIDGE
+
+#include "qtractorPluginBridge.h"
+
+#include "qtractor_plugin_host.h"
+
+#include "qtractorSession.h"
+#include "qtractorAudioEngine.h"
+
+#include <QCoreApplication>
+#include <QProcess>
+#include <QStringList>
+#include <QFileInfo>
+#include <QDir>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <string.h>
+
+
+// Host helper program name.
+static const char *c_pszPluginHost = "qtractor_plugin_host";
+
+// Shared-memory segment name serial.
+static unsigned int g_iShmSerial = 0;
+
+
+// Monotonic clock, in nanoseconds.
+static inline long long qtractor_plugin_bridge_nsecs (void)
+{
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+
+//----------------------------------------------------------------------------
+// qtractorPluginBridge -- Out-of-process plugin instance (engine side).
+//
+
+// Constructor.
+qtractorPluginBridge::qtractorPluginBridge (void)
+	: m_pShm(NULL), m_iShmSize(0), m_pProcess(NULL), m_iRequest(0),
+		m_iPeriodNsecs(0), m_iTimeoutNsecs(0), m_iDeadline(0),
+		m_bRunning(false), m_bStalled(false)
+{
+	ATOMIC_SET(&m_busy, 0);
+
+#ifdef CONFIG_DEBUG
+	m_iRunCount = 0;
+	m_fRunNsecs = 0.0;
+#endif
+}
+
+
+// Destructor.
+qtractorPluginBridge::~qtractorPluginBridge (void)
+{
+	close();
+}
+
+
+// Start the host process and instantiate the plugin.
+bool qtractorPluginBridge::open ( const QString& sFilename,
+	unsigned long iIndex, unsigned int iSampleRate, unsigned int iBufferSize,
+	const QVector<unsigned int>& portSizes,
+	const QVector<float>& portValues )
+{
+	close();
+
+	if (!isAvailable() || iSampleRate == 0)
+		return false;
+
+	// Lay out port slots (16-byte aligned each)...
+	const unsigned int iPorts = portSizes.count();
+	QVector<unsigned int> offsets(iPorts);
+	unsigned int iFloats = 0;
+	for (unsigned int i = 0; i < iPorts; ++i) {
+		offsets[i] = iFloats;
+		iFloats += (portSizes.at(i) + 3) & ~3;
+	}
+
+	const size_t iShmSize = qtractor_plugin_host_data_offset(iPorts)
+		+ iFloats * sizeof(float);
+
+	// Create and map the shared-memory segment...
+	m_sShmName = QString("/%1-%2-%3").arg(c_pszPluginHost)
+		.arg(::getpid()).arg(++g_iShmSerial);
+	const QByteArray aShmName = m_sShmName.toLocal8Bit();
+	const int fd = ::shm_open(aShmName.constData(),
+		O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0) {
+		m_sShmName.clear();
+		return false;
+	}
+
+	void *addr = MAP_FAILED;
+	if (::ftruncate(fd, iShmSize) == 0) {
+		addr = ::mmap(NULL, iShmSize,
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	::close(fd);
+
+	if (addr == MAP_FAILED) {
+		close();
+		return false;
+	}
+
+	::memset(addr, 0, iShmSize);
+	::mlock(addr, iShmSize);
+
+	m_pShm = (qtractor_plugin_host_shm *) addr;
+	m_iShmSize = iShmSize;
+
+	const QByteArray aFilename = sFilename.toLocal8Bit();
+	::strncpy(m_pShm->filename, aFilename.constData(),
+		sizeof(m_pShm->filename) - 1);
+
+	m_pShm->magic = QTRACTOR_PLUGIN_HOST_MAGIC;
+	m_pShm->size  = iShmSize;
+	m_pShm->index = iIndex;
+	m_pShm->sample_rate = iSampleRate;
+	m_pShm->buffer_size = iBufferSize;
+	m_pShm->nframes     = iBufferSize;
+	m_pShm->port_count  = iPorts;
+
+	unsigned int *piOffsets = qtractor_plugin_host_offsets(m_pShm);
+	for (unsigned int i = 0; i < iPorts; ++i)
+		piOffsets[i] = offsets.at(i);
+
+	// Control ports start with current values; the plugin may
+	// still override them on instantiation (new defaults)...
+	for (unsigned int i = 0; i < iPorts; ++i) {
+		if (portSizes.at(i) == 1 && i < (unsigned int) portValues.count())
+			*qtractor_plugin_host_port(m_pShm, i) = portValues.at(i);
+	}
+
+	m_iRequest = 0;
+	m_iPeriodNsecs = (1000000000LL * iBufferSize) / iSampleRate;
+
+	// The engine can't wait for the host more than a fraction
+	// of the period, as the rest of the graph must run as well.
+	m_iTimeoutNsecs = (m_iPeriodNsecs >> 1);
+
+	// Have the host running as real-time as the engine itself...
+	int iPriority = 0;
+	qtractorSession *pSession = qtractorSession::getInstance();
+	if (pSession && pSession->audioEngine()) {
+		jack_client_t *pJackClient = pSession->audioEngine()->jackClient();
+		if (pJackClient)
+			iPriority = ::jack_client_real_time_priority(pJackClient);
+	}
+
+	const QDir dir(QCoreApplication::applicationDirPath());
+	const QFileInfo fi(dir, c_pszPluginHost);
+
+	QStringList args;
+	args.append(m_sShmName);
+	if (iPriority > 0)
+		args.append(QString::number(iPriority));
+
+	// Standard input is kept as an open pipe, never written:
+	// the host takes its hang-up as the engine having gone away.
+	m_pProcess = new QProcess();
+	m_pProcess->setProcessChannelMode(QProcess::ForwardedChannels);
+	m_pProcess->start(fi.filePath(), args);
+	if (!m_pProcess->waitForStarted(3000)
+		|| !command(PluginHostOpen, 5000)) {
+		close();
+		return false;
+	}
+
+	// Host has it mapped already; no need for a name anymore.
+	::shm_unlink(aShmName.constData());
+	m_sShmName.clear();
+
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorPluginBridge[%p]::open(\"%s\", %lu) pid=%lld",
+		this, aFilename.constData(), iIndex, (long long) m_pProcess->pid());
+#endif
+
+	return true;
+}
+
+
+// Shutdown the host process.
+void qtractorPluginBridge::close (void)
+{
+	if (m_pProcess) {
+		if (m_pProcess->state() != QProcess::NotRunning) {
+			if (!m_bStalled)
+				command(PluginHostClose, 500);
+			if (!m_pProcess->waitForFinished(500)) {
+				m_pProcess->kill();
+				m_pProcess->waitForFinished(200);
+			}
+		}
+		delete m_pProcess;
+		m_pProcess = NULL;
+	}
+
+	if (m_pShm) {
+		::munmap(m_pShm, m_iShmSize);
+		m_pShm = NULL;
+		m_iShmSize = 0;
+	}
+
+	if (!m_sShmName.isEmpty()) {
+		::shm_unlink(m_sShmName.toLocal8Bit().constData());
+		m_sShmName.clear();
+	}
+
+#ifdef CONFIG_DEBUG
+	if (m_iRunCount > 0) {
+		qDebug("qtractorPluginBridge[%p]::close() cycles=%lu overhead=%g usecs",
+			this, m_iRunCount, 0.001 * m_fRunNsecs / double(m_iRunCount));
+	}
+	m_iRunCount = 0;
+	m_fRunNsecs = 0.0;
+#endif
+
+	m_bRunning = false;
+	m_bStalled = false;
+
+	ATOMIC_SET(&m_busy, 0);
+}
+
+
+// Do the actual (de)activation (synchronous).
+bool qtractorPluginBridge::activate (void)
+{
+	return command(PluginHostActivate, 1000);
+}
+
+bool qtractorPluginBridge::deactivate (void)
+{
+	return command(PluginHostDeactivate, 1000);
+}
+
+
+// Shared port data slot.
+float *qtractorPluginBridge::port ( unsigned long iPort ) const
+{
+	if (m_pShm == NULL || iPort >= m_pShm->port_count)
+		return NULL;
+
+	return qtractor_plugin_host_port(m_pShm, iPort);
+}
+
+
+// Synchronous (non real-time) command handshake.
+bool qtractorPluginBridge::command ( int iCommand, int iTimeout )
+{
+	if (m_pShm == NULL || m_pProcess == NULL)
+		return false;
+
+	// Wait for any real-time cycle in flight...
+	int iRetry = 0;
+	while (!ATOMIC_TAS(&m_busy)) {
+		if (++iRetry > 1000)
+			return false;
+		::usleep(100);
+	}
+
+	// Still hanging on to a previous request?
+	if (m_bStalled) {
+		if (ATOMIC_GET(&m_pShm->response) != m_iRequest) {
+			ATOMIC_SET(&m_busy, 0);
+			return false;
+		}
+		m_bStalled = false;
+	}
+
+	m_pShm->command = iCommand;
+	m_pShm->result  = -1;
+
+	ATOMIC_SET(&m_pShm->request, ++m_iRequest);
+	qtractor_plugin_host_wake(&m_pShm->request);
+
+	const long long iDeadline = qtractor_plugin_bridge_nsecs()
+		+ 1000000LL * iTimeout;
+
+	bool bResult = true;
+	for (;;) {
+		const int iResponse = ATOMIC_GET(&m_pShm->response);
+		if (iResponse == m_iRequest)
+			break;
+		const long long iNow = qtractor_plugin_bridge_nsecs();
+		if (iNow >= iDeadline
+			|| m_pProcess->state() == QProcess::NotRunning) {
+			bResult = false;
+			break;
+		}
+		// Poll on 10msec slices...
+		long long iWait = iDeadline - iNow;
+		if (iWait > 10000000LL)
+			iWait = 10000000LL;
+		qtractor_plugin_host_wait(&m_pShm->response, iResponse, iWait);
+	}
+
+	if (bResult)
+		bResult = (m_pShm->result == 0);
+	else
+		m_bStalled = true;
+
+	ATOMIC_SET(&m_busy, 0);
+
+	return bResult;
+}
+
+
+// Real-time processing: kick the host to run a cycle...
+bool qtractorPluginBridge::run ( unsigned int nframes )
+{
+	m_bRunning = false;
+
+	if (m_pShm == NULL || !ATOMIC_TAS(&m_busy))
+		return false;
+
+	// Have we recovered from a late response yet?
+	if (m_bStalled) {
+		if (ATOMIC_GET(&m_pShm->response) != m_iRequest) {
+			ATOMIC_SET(&m_busy, 0);
+			return false;
+		}
+		m_bStalled = false;
+	}
+
+	m_pShm->nframes = nframes;
+	m_pShm->command = PluginHostRun;
+	m_pShm->result  = -1;
+
+	m_iDeadline = qtractor_plugin_bridge_nsecs() + m_iTimeoutNsecs;
+
+	ATOMIC_SET(&m_pShm->request, ++m_iRequest);
+	qtractor_plugin_host_wake(&m_pShm->request);
+
+	m_bRunning = true;
+	return true;
+}
+
+
+// ...and wait for it, no longer than half a period though.
+bool qtractorPluginBridge::wait (void)
+{
+	if (!m_bRunning)
+		return false;
+
+	m_bRunning = false;
+
+	int iSpin = 0;
+	for (;;) {
+		const int iResponse = ATOMIC_GET(&m_pShm->response);
+		if (iResponse == m_iRequest)
+			break;
+		// Busy-wait a little bit first...
+		if (++iSpin < 256)
+			continue;
+		const long long iNow = qtractor_plugin_bridge_nsecs();
+		if (iNow >= m_iDeadline) {
+			m_bStalled = true;
+			break;
+		}
+		qtractor_plugin_host_wait(&m_pShm->response,
+			iResponse, m_iDeadline - iNow);
+	}
+
+#ifdef CONFIG_DEBUG
+	if (!m_bStalled) {
+		m_fRunNsecs += double(qtractor_plugin_bridge_nsecs()
+			- (m_iDeadline - m_iTimeoutNsecs));
+		++m_iRunCount;
+	}
+#endif
+
+	const bool bResult = (!m_bStalled && m_pShm->result == 0);
+
+	ATOMIC_SET(&m_busy, 0);
+
+	return bResult;
+}
+
+
+// Whether the host helper is installed at all.
+bool qtractorPluginBridge::isAvailable (void)
+{
+	const QDir dir(QCoreApplication::applicationDirPath());
+	const QFileInfo fi(dir, c_pszPluginHost);
+	return fi.isExecutable();
+}
+
+
+#endif	// CONFIG_PLUGIN_BRIDGE
+
+// end of qtractorPluginBridge.cpp
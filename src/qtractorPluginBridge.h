@@ -0,0 +1,124 @@
+// qtractorPluginBridge.h
+//
+/****************************************************************************
+   Copyright (C) 2005-2016, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractorPluginBridge_h
+#define __qtractorPluginBridge_h
+
+#include "qtractorAtomic.h"
+
+#include <QString>
+#include <QVector>
+
+
+// Forward decls.
+struct qtractor_plugin_host_shm;
+
+class QProcess;
+
+
+//----------------------------------------------------------------------------
+// qtractorPluginBridge -- Out-of-process plugin instance (engine side).
+//
+// Talks to a qtractor_plugin_host helper process over a shared-memory
+// segment holding one slot per plugin port; a crashing or hanging
+// plugin won't take the whole engine down with it.
+
+class qtractorPluginBridge
+{
+public:
+
+	// Constructor.
+	qtractorPluginBridge();
+
+	// Destructor.
+	~qtractorPluginBridge();
+
+	// Start the host process and instantiate the plugin
+	// (port sizes are given in floats, one per plugin port;
+	// control port slots are initialized with the given values).
+	bool open(const QString& sFilename, unsigned long iIndex,
+		unsigned int iSampleRate, unsigned int iBufferSize,
+		const QVector<unsigned int>& portSizes,
+		const QVector<float>& portValues);
+
+	// Shutdown the host process.
+	void close();
+
+	bool isOpen() const
+		{ return (m_pShm != NULL); }
+
+	// Do the actual (de)activation (synchronous).
+	bool activate();
+	bool deactivate();
+
+	// Shared port data slot.
+	float *port(unsigned long iPort) const;
+
+	// Real-time processing: kick the host to run a cycle...
+	bool run(unsigned int nframes);
+	// ...and wait for it, no longer than half a period though.
+	bool wait();
+
+	// Whether host has failed to answer in time (or crashed).
+	bool isStalled() const
+		{ return m_bStalled; }
+
+	// Whether the host helper is installed at all.
+	static bool isAvailable();
+
+protected:
+
+	// Synchronous (non real-time) command handshake.
+	bool command(int iCommand, int iTimeout);
+
+private:
+
+	// Instance variables.
+	QString  m_sShmName;
+	qtractor_plugin_host_shm *m_pShm;
+	size_t   m_iShmSize;
+
+	QProcess *m_pProcess;
+
+	int m_iRequest;
+
+	// Real-time cycle deadline (nanoseconds).
+	long long m_iPeriodNsecs;
+	long long m_iTimeoutNsecs;
+	long long m_iDeadline;
+
+	bool m_bRunning;
+	bool m_bStalled;
+
+	// Real-time vs. command handshake guard.
+	qtractorAtomic m_busy;
+
+#ifdef CONFIG_DEBUG
+	// Round-trip overhead statistics.
+	unsigned long m_iRunCount;
+	double        m_fRunNsecs;
+#endif
+};
+
+
+#endif	// __qtractorPluginBridge_h
+
+// end of qtractorPluginBridge.h
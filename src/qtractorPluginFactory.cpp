@@ -40,11 +40,16 @@
 #include "qtractorOptions.h"
 
 #include <QApplication>
+#include <QThread>
 
 #include <QTextStream>
 #include <QFileInfo>
+#include <QDateTime>
+#include <QFile>
 #include <QDir>
 
+#include <QCryptographicHash>
+
 
 //----------------------------------------------------------------------------
 // qtractorPluginFactory -- Plugin path helper.
@@ -62,7 +67,7 @@ qtractorPluginFactory *qtractorPluginFactory::getInstance (void)
 
 // Contructor.
 qtractorPluginFactory::qtractorPluginFactory ( QObject *pParent )
-	: QObject(pParent), m_typeHint(qtractorPluginType::Any), m_pProxy(NULL)
+	: QObject(pParent), m_typeHint(qtractorPluginType::Any)
 {
 	g_pPluginFactory = this;
 }
@@ -249,23 +254,45 @@ void qtractorPluginFactory::scan (void)
 		if (!paths.isEmpty()) {
 			iFileCount += addFiles(qtractorPluginType::Vst, paths);
 			qtractorOptions *pOptions = qtractorOptions::getInstance();
-			if (pOptions && pOptions->bDummyVstScan) {
-				m_pProxy = new qtractorPluginFactoryProxy(this);
-				m_pProxy->start();
-			}
+			if (pOptions && pOptions->bDummyVstScan)
+				startProxies();
 		}
 	}
 #endif
+
+	// Load the persistent scan cache...
+	Cache cache;
+	loadCache(cache);
+
 #ifdef CONFIG_LV2
 	// LV2 default path...
+	QString sLv2Stamp;
 	if (m_typeHint == qtractorPluginType::Any ||
 		m_typeHint == qtractorPluginType::Lv2) {
-		QStringList& files = m_files[qtractorPluginType::Lv2];
-		files.append(qtractorLv2PluginType::lv2_plugins());
-		iFileCount += files.count();
+		// Unchanged LV2 bundles are all taken from cache,
+		// without loading the whole LV2 world at all...
+		sLv2Stamp = lv2CacheStamp();
+		if (!addLv2CacheTypes(cache, sLv2Stamp)) {
+			QStringList& files = m_files[qtractorPluginType::Lv2];
+			files.append(qtractorLv2PluginType::lv2_plugins());
+			iFileCount += files.count();
+		}
 	}
 #endif
 
+	// Keep only those cache entries which are not to be scanned...
+	m_cache = cache;
+	Cache::Iterator cache_iter = m_cache.begin();
+	while (cache_iter != m_cache.end()) {
+		const qtractorPluginType::Hint typeHint
+			= qtractorPluginType::hintFromText(
+				cache_iter.key().section('|', 0, 0));
+		if (m_files.contains(typeHint))
+			cache_iter = m_cache.erase(cache_iter);
+		else
+			++cache_iter;
+	}
+
 	// Do the real scan...
 	int iFile = 0;
 	Paths::ConstIterator files_iter = m_files.constBegin();
@@ -274,23 +301,30 @@ void qtractorPluginFactory::scan (void)
 		const qtractorPluginType::Hint typeHint = files_iter.key();
 		QStringListIterator file_iter(files_iter.value());
 		while (file_iter.hasNext()) {
-			addTypes(typeHint, file_iter.next());
+			const QString& sFilename = file_iter.next();
+			// Unchanged files are just taken from cache...
+			if (!addCacheTypes(cache, typeHint, sFilename)) {
+				addCacheFile(typeHint, sFilename);
+				addTypes(typeHint, sFilename);
+				QApplication::processEvents(
+					QEventLoop::ExcludeUserInputEvents);
+			}
 			emit scanned((++iFile * 100) / iFileCount);
-			QApplication::processEvents(
-				QEventLoop::ExcludeUserInputEvents);
 		}
 	}
 
-	// Check the proxy (out-of-process) client closure...
-	if (m_pProxy) {
-		m_pProxy->closeWriteChannel();
-		for (iFile = 0; iFile < iFileCount; ++iFile) {
-			if (m_pProxy->waitForFinished(200))
-				break;
-			QApplication::processEvents(
-				QEventLoop::ExcludeUserInputEvents);
-		}
-	}
+	// Wait for the proxy (out-of-process) clients to finish...
+	waitProxies();
+
+#ifdef CONFIG_LV2
+	// Stamp the whole of LV2 bundles as scanned...
+	if (m_files.contains(qtractorPluginType::Lv2) && !sLv2Stamp.isEmpty())
+		m_cache[lv2CacheKey()].stamp = sLv2Stamp;
+#endif
+
+	// Save the persistent scan cache...
+	saveCache(m_cache);
+	m_cache.clear();
 
 	// Done.
 	reset();
@@ -299,11 +333,7 @@ void qtractorPluginFactory::scan (void)
 
 void qtractorPluginFactory::reset (void)
 {
-	if (m_pProxy) {
-		m_pProxy->terminate();
-		delete m_pProxy;
-		m_pProxy = NULL;
-	}
+	deleteProxies();
 
 	m_files.clear();
 }
@@ -316,6 +346,394 @@ void qtractorPluginFactory::clear (void)
 }
 
 
+// Proxy (out-of-process) client pool methods.
+//
+// Each client scans one file at a time, so that a hanging or
+// crashing plugin is easily spotted, killed and marked as failed
+// (retried on next scan) while the others carry on in parallel.
+
+// Maximum time a single plugin file scan may take (msecs).
+static const int c_iProxyTimeout = 10000;
+
+void qtractorPluginFactory::startProxies (void)
+{
+	deleteProxies();
+
+	int iProxies = QThread::idealThreadCount();
+	if (iProxies < 1)
+		iProxies = 1;
+
+	for (int i = 0; i < iProxies; ++i) {
+		qtractorPluginFactoryProxy *pProxy
+			= new qtractorPluginFactoryProxy(this);
+		if (pProxy->start()) {
+			m_proxies.append(pProxy);
+		} else {
+			delete pProxy;
+			break;
+		}
+	}
+}
+
+
+qtractorPluginFactoryProxy *qtractorPluginFactory::idleProxy (void)
+{
+	while (!m_proxies.isEmpty()) {
+		QListIterator<qtractorPluginFactoryProxy *> iter(m_proxies);
+		while (iter.hasNext()) {
+			qtractorPluginFactoryProxy *pProxy = iter.next();
+			if (pProxy->isStalled(c_iProxyTimeout)
+				|| pProxy->state() == QProcess::NotRunning) {
+				pProxy->abort();
+				if (!pProxy->start()) {
+					m_proxies.removeAll(pProxy);
+					delete pProxy;
+					break;
+				}
+			}
+			if (!pProxy->isBusy())
+				return pProxy;
+		}
+		// Wait a little for any progress...
+		if (!m_proxies.isEmpty())
+			m_proxies.first()->waitForReadyRead(10);
+		QApplication::processEvents(
+			QEventLoop::ExcludeUserInputEvents);
+	}
+
+	return NULL;
+}
+
+
+void qtractorPluginFactory::waitProxies (void)
+{
+	bool bBusy = true;
+	while (bBusy && !m_proxies.isEmpty()) {
+		bBusy = false;
+		QListIterator<qtractorPluginFactoryProxy *> iter(m_proxies);
+		while (iter.hasNext()) {
+			qtractorPluginFactoryProxy *pProxy = iter.next();
+			if (pProxy->isStalled(c_iProxyTimeout))
+				pProxy->abort();
+			else
+			if (pProxy->isBusy())
+				bBusy = true;
+		}
+		if (bBusy) {
+			m_proxies.first()->waitForReadyRead(10);
+			QApplication::processEvents(
+				QEventLoop::ExcludeUserInputEvents);
+		}
+	}
+
+	QListIterator<qtractorPluginFactoryProxy *> iter(m_proxies);
+	while (iter.hasNext()) {
+		qtractorPluginFactoryProxy *pProxy = iter.next();
+		if (pProxy->state() != QProcess::NotRunning) {
+			pProxy->closeWriteChannel();
+			pProxy->waitForFinished(200);
+		}
+	}
+}
+
+
+void qtractorPluginFactory::deleteProxies (void)
+{
+	QListIterator<qtractorPluginFactoryProxy *> iter(m_proxies);
+	while (iter.hasNext()) {
+		qtractorPluginFactoryProxy *pProxy = iter.next();
+		pProxy->terminate();
+		delete pProxy;
+	}
+
+	m_proxies.clear();
+}
+
+
+// Persistent scan cache file path.
+QString qtractorPluginFactory::cacheFilename (void) const
+{
+	qtractorOptions *pOptions = qtractorOptions::getInstance();
+	if (pOptions == NULL)
+		return QString();
+
+	const QFileInfo info(pOptions->settings().fileName());
+	return info.absoluteDir().filePath(info.completeBaseName() + ".cache");
+}
+
+
+// Persistent scan cache reset method (force full rescan).
+void qtractorPluginFactory::clearCache (void)
+{
+	const QString& sCacheFilename = cacheFilename();
+	if (!sCacheFilename.isEmpty())
+		QFile::remove(sCacheFilename);
+
+#ifdef CONFIG_LV2
+	// Have new and changed LV2 bundles rediscovered,
+	// as far as the current world is not in use...
+	qtractorLv2PluginType::lv2_reload();
+#endif
+}
+
+
+// Persistent scan cache methods.
+void qtractorPluginFactory::loadCache ( Cache& cache ) const
+{
+	const QString& sCacheFilename = cacheFilename();
+	if (sCacheFilename.isEmpty())
+		return;
+
+	QFile file(sCacheFilename);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+		return;
+
+	// Entry header lines are as "@HINT|filename|stamp",
+	// followed by zero or more type descriptor lines;
+	// failed entries (no types) are marked as "!HINT|...",
+	// and are always retried on the next scan...
+	QTextStream ts(&file);
+	CacheItem *pItem = NULL;
+	while (!ts.atEnd()) {
+		const QString& sLine = ts.readLine();
+		if (sLine.isEmpty() || sLine.at(0) == '#')
+			continue;
+		if (sLine.at(0) == '@' || sLine.at(0) == '!') {
+			const QString& sKey = sLine.section('|', 0, 1).mid(1);
+			pItem = &cache[sKey];
+			pItem->stamp = sLine.section('|', 2);
+			pItem->types.clear();
+			pItem->failed = (sLine.at(0) == '!');
+		}
+		else
+		if (pItem)
+			pItem->types.append(sLine);
+	}
+
+	file.close();
+}
+
+
+void qtractorPluginFactory::saveCache ( const Cache& cache ) const
+{
+	const QString& sCacheFilename = cacheFilename();
+	if (sCacheFilename.isEmpty())
+		return;
+
+	QFile file(sCacheFilename);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+		return;
+
+	QTextStream ts(&file);
+	ts << "# " QTRACTOR_TITLE " plug-in scan cache." << endl;
+
+	Cache::ConstIterator iter = cache.constBegin();
+	const Cache::ConstIterator& iter_end = cache.constEnd();
+	for ( ; iter != iter_end; ++iter) {
+		const CacheItem& item = iter.value();
+		ts << (item.failed || item.types.isEmpty() ? '!' : '@');
+		ts << iter.key() << '|' << item.stamp << endl;
+		QStringListIterator type_iter(item.types);
+		while (type_iter.hasNext())
+			ts << type_iter.next() << endl;
+	}
+
+	file.close();
+}
+
+
+// Persistent scan cache file stamp and key helpers (static).
+QString qtractorPluginFactory::cacheStamp (
+	qtractorPluginType::Hint typeHint, const QString& sFilename )
+{
+#ifdef CONFIG_LV2
+	// LV2 plugins are stamped by their bundle's
+	// manifest and data files (*.ttl) altogether...
+	if (typeHint == qtractorPluginType::Lv2) {
+		const QString& sBundlePath
+			= qtractorLv2PluginType::lv2_bundle_path(sFilename);
+		if (sBundlePath.isEmpty())
+			return QString();
+		return lv2BundleStamp(sBundlePath);
+	}
+#else
+	Q_UNUSED(typeHint);
+#endif
+
+	const QFileInfo info(sFilename);
+	return QString::number(info.lastModified().toTime_t())
+		+ '|' + QString::number(info.size());
+}
+
+
+#ifdef CONFIG_LV2
+
+// LV2 bundle stamp helper (static).
+QString qtractorPluginFactory::lv2BundleStamp ( const QString& sBundlePath )
+{
+	uint iLastModified = 0;
+	qint64 iSize = 0;
+	const QDir dir(sBundlePath);
+	const QFileInfoList& info_list
+		= dir.entryInfoList(QStringList() << "*.ttl", QDir::Files);
+	QListIterator<QFileInfo> info_iter(info_list);
+	while (info_iter.hasNext()) {
+		const QFileInfo& info = info_iter.next();
+		const uint iModified = info.lastModified().toTime_t();
+		if (iLastModified < iModified)
+			iLastModified = iModified;
+		iSize += info.size();
+	}
+	return QString::number(iLastModified)
+		+ '|' + QString::number(iSize);
+}
+
+
+// LV2 whole bundles stamp: all bundles found on the
+// LV2 paths, as named and stamped, hashed together;
+// computed without loading the LV2 world (lilv).
+QString qtractorPluginFactory::lv2CacheStamp (void)
+{
+	QStringList bundles;
+
+	QStringListIterator path_iter(pluginPaths(qtractorPluginType::Lv2));
+	while (path_iter.hasNext()) {
+		const QDir dir(path_iter.next());
+		const QFileInfoList& info_list = dir.entryInfoList(
+			QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+		QListIterator<QFileInfo> info_iter(info_list);
+		while (info_iter.hasNext()) {
+			const QString& sBundlePath = info_iter.next().absoluteFilePath();
+			bundles.append(sBundlePath + '|' + lv2BundleStamp(sBundlePath));
+		}
+	}
+
+	if (bundles.isEmpty())
+		return QString();
+
+	return QString::fromLatin1(QCryptographicHash::hash(
+		bundles.join("\n").toUtf8(), QCryptographicHash::Md5).toHex());
+}
+
+
+// LV2 whole bundles stamp cache key.
+QString qtractorPluginFactory::lv2CacheKey (void)
+{
+	return cacheKey(qtractorPluginType::Lv2, "*");
+}
+
+
+// LV2 whole bundles cache lookup (true if hit).
+bool qtractorPluginFactory::addLv2CacheTypes (
+	const Cache& cache, const QString& sLv2Stamp )
+{
+	if (sLv2Stamp.isEmpty())
+		return false;
+
+	const QString& sStampKey = lv2CacheKey();
+	Cache::ConstIterator iter = cache.constFind(sStampKey);
+	if (iter == cache.constEnd() || iter.value().stamp != sLv2Stamp)
+		return false;
+
+	// Failed entries are always retried...
+	const QString& sPrefix
+		= qtractorPluginType::textFromHint(qtractorPluginType::Lv2) + '|';
+	const Cache::ConstIterator& iter_end = cache.constEnd();
+	for (iter = cache.constBegin(); iter != iter_end; ++iter) {
+		if (iter.key().startsWith(sPrefix) && iter.key() != sStampKey) {
+			const CacheItem& item = iter.value();
+			if (item.failed || item.types.isEmpty())
+				return false;
+		}
+	}
+
+	for (iter = cache.constBegin(); iter != iter_end; ++iter) {
+		if (iter.key().startsWith(sPrefix) && iter.key() != sStampKey) {
+			QStringListIterator type_iter(iter.value().types);
+			while (type_iter.hasNext()) {
+				qtractorPluginType *pType
+					= qtractorDummyPluginType::createType(type_iter.next());
+				if (pType)
+					addType(pType);
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif	// CONFIG_LV2
+
+QString qtractorPluginFactory::cacheKey (
+	qtractorPluginType::Hint typeHint, const QString& sFilename )
+{
+	return qtractorPluginType::textFromHint(typeHint)
+		+ '|' + qtractorDummyPluginType::escapeText(sFilename);
+}
+
+
+// Persistent scan cache lookup method (true if hit).
+bool qtractorPluginFactory::addCacheTypes ( const Cache& cache,
+	qtractorPluginType::Hint typeHint, const QString& sFilename )
+{
+	const QString& sKey = cacheKey(typeHint, sFilename);
+	Cache::ConstIterator iter = cache.constFind(sKey);
+	if (iter == cache.constEnd())
+		return false;
+
+	// Failed (void) entries are always retried...
+	const CacheItem& item = iter.value();
+	if (item.failed || item.types.isEmpty())
+		return false;
+
+	const QString& sStamp = cacheStamp(typeHint, sFilename);
+	if (sStamp.isEmpty() || item.stamp != sStamp)
+		return false;
+
+	QStringListIterator type_iter(item.types);
+	while (type_iter.hasNext()) {
+		qtractorPluginType *pType
+			= qtractorDummyPluginType::createType(type_iter.next());
+		if (pType)
+			addType(pType);
+	}
+
+	m_cache.insert(sKey, item);
+	return true;
+}
+
+
+// Persistent scan cache file register method.
+void qtractorPluginFactory::addCacheFile (
+	qtractorPluginType::Hint typeHint, const QString& sFilename )
+{
+	CacheItem& item = m_cache[cacheKey(typeHint, sFilename)];
+	item.stamp = cacheStamp(typeHint, sFilename);
+	item.types.clear();
+	item.failed = false;
+}
+
+
+// Persistent scan cache failure mark method (retry on next scan).
+void qtractorPluginFactory::failCacheFile (
+	qtractorPluginType::Hint typeHint, const QString& sFilename )
+{
+	Cache::Iterator iter = m_cache.find(cacheKey(typeHint, sFilename));
+	if (iter != m_cache.end())
+		iter.value().failed = true;
+}
+
+
+// Persistent scan cache type register method.
+void qtractorPluginFactory::addCacheType ( qtractorPluginType *pType )
+{
+	const QString& sKey = cacheKey(pType->typeHint(), pType->filename());
+	Cache::Iterator iter = m_cache.find(sKey);
+	if (iter != m_cache.end())
+		iter.value().types.append(qtractorDummyPluginType::textFromType(pType));
+}
+
+
 // Recursive plugin file/path inventory method.
 int qtractorPluginFactory::addFiles (
 	qtractorPluginType::Hint typeHint, const QStringList& paths )
@@ -462,6 +880,7 @@ bool qtractorPluginFactory::addTypes (
 		if (pType) {
 			if (pType->open()) {
 				addType(pType);
+				addCacheType(pType);
 				pType->close();
 				return true;
 			} else {
@@ -474,9 +893,12 @@ bool qtractorPluginFactory::addTypes (
 #endif
 
 #ifdef CONFIG_VST
-	// Try VST plugin types (out-of-process scan)...
-	if (typeHint == qtractorPluginType::Vst && m_pProxy)
-		return m_pProxy->addTypes(typeHint, sFilename);
+	// Try VST plugin types (out-of-process scan);
+	// the proxy registers and caches them on its own...
+	if (typeHint == qtractorPluginType::Vst && !m_proxies.isEmpty()) {
+		qtractorPluginFactoryProxy *pProxy = idleProxy();
+		return (pProxy && pProxy->addTypes(typeHint, sFilename));
+	}
 #endif
 
 	qtractorPluginFile *pFile = qtractorPluginFile::addFile(sFilename);
@@ -495,6 +917,7 @@ bool qtractorPluginFactory::addTypes (
 			if (pType->open()) {
 				pFile->addRef();
 				addType(pType);
+				addCacheType(pType);
 				pType->close();
 				++iIndex;
 			} else {
@@ -520,6 +943,7 @@ bool qtractorPluginFactory::addTypes (
 			if (pType->open()) {
 				pFile->addRef();
 				addType(pType);
+				addCacheType(pType);
 				pType->close();
 				++iIndex;
 			} else {
@@ -545,6 +969,7 @@ bool qtractorPluginFactory::addTypes (
 			if (pType->open()) {
 				pFile->addRef();
 				addType(pType);
+				addCacheType(pType);
 				pType->close();
 				++iIndex;
 			} else {
@@ -574,7 +999,7 @@ bool qtractorPluginFactory::addTypes (
 // Constructor.
 qtractorPluginFactoryProxy::qtractorPluginFactoryProxy (
 	qtractorPluginFactory *pPluginFactory )
-	: QProcess(pPluginFactory)
+	: QProcess(pPluginFactory), m_bBusy(false)
 {
 	QObject::connect(this,
 		SIGNAL(readyReadStandardOutput()),
@@ -596,6 +1021,9 @@ bool qtractorPluginFactoryProxy::start (void)
 	if (!fi.isExecutable())
 		return false;
 
+	m_bBusy = false;
+	m_sFilename.clear();
+
 	QProcess::start(fi.filePath());
 	return true;
 }
@@ -608,17 +1036,23 @@ void qtractorPluginFactoryProxy::stdout_slot (void)
 	if (pPluginFactory == NULL)
 		return;
 
-	const QString sData(QProcess::readAllStandardOutput());
-	QStringListIterator iter = sData.split("\n");
-	while (iter.hasNext()) {
-		const QString& sText = iter.next().simplified();
+	while (QProcess::canReadLine()) {
+		const QString& sText
+			= QString::fromUtf8(QProcess::readLine()).simplified();
 		if (sText.isEmpty())
 			continue;
+		// End of current file scan?
+		if (sText.at(0) == '@') {
+			m_bBusy = false;
+			continue;
+		}
+		// The one and only place where proxied types get cached...
 		qtractorPluginType *pType = qtractorDummyPluginType::createType(sText);
-		if (pType)
+		if (pType) {
 			pPluginFactory->addType(pType);
-		else
-			QTextStream(stderr) << sText + '\n';
+			pPluginFactory->addCacheType(pType);
+		}
+		else QTextStream(stderr) << sText + '\n';
 	}
 }
 
@@ -637,9 +1071,46 @@ bool qtractorPluginFactoryProxy::addTypes (
 	const QString& sLine = sHint + ':' + sFilename + '\n';
 	const QByteArray& data = sLine.toUtf8();
 	const bool bResult = (QProcess::write(data) == data.size());
-	QProcess::waitForReadyRead(200);
+	if (bResult) {
+		m_bBusy = true;
+		m_sFilename = sFilename;
+		m_time.start();
+	}
 	return bResult;
+}
 
+
+// Whether current request is hanging or has crashed.
+bool qtractorPluginFactoryProxy::isStalled ( int iTimeout ) const
+{
+	if (!m_bBusy)
+		return false;
+
+	return (QProcess::state() == QProcess::NotRunning
+		|| m_time.elapsed() > iTimeout);
+}
+
+
+// Abort current request (kill).
+void qtractorPluginFactoryProxy::abort (void)
+{
+	if (m_bBusy) {
+		QTextStream(stderr) << QObject::tr(
+			"qtractorPluginFactoryProxy: scan of \"%1\" failed.")
+			.arg(m_sFilename) << '\n';
+		// Mark it for retry on next scan...
+		qtractorPluginFactory *pPluginFactory
+			= static_cast<qtractorPluginFactory *> (QObject::parent());
+		if (pPluginFactory)
+			pPluginFactory->failCacheFile(qtractorPluginType::Vst, m_sFilename);
+	}
+
+	if (QProcess::state() != QProcess::NotRunning) {
+		QProcess::kill();
+		QProcess::waitForFinished(200);
+	}
+
+	m_bBusy = false;
 }
 
 
@@ -674,12 +1145,18 @@ qtractorDummyPluginType::qtractorDummyPluginType (
 	m_bConfigure = flags.contains("EXT");
 	m_bRealtime = flags.contains("RT");
 
-	m_sFilename = props.at(6);
+	m_sFilename = unescapeText(props.at(6));
 
 	bool bOk = false;
 	QString sUniqueID = props.at(8);
-	m_iUniqueID = qHash(sUniqueID.remove("0x").toULong(&bOk, 16));
+	const unsigned long iUniqueID = sUniqueID.remove("0x").toULong(&bOk, 16);
 
+	// Cached type descriptors carry their own label and unique-id...
+	if (props.count() > 9) {
+		m_sLabel = props.at(9);
+		m_iUniqueID = iUniqueID;
+	}
+	else m_iUniqueID = qHash(iUniqueID);
 }
 
 
@@ -702,15 +1179,61 @@ qtractorDummyPluginType *qtractorDummyPluginType::createType (
 	// Sanity check...
 	const QStringList& props = sText.split('|');
 
+	if (props.count() < 9)
+		return NULL;
+
 	const Hint typeHint = qtractorPluginType::hintFromText(props.at(0));
-	if (typeHint != Vst)
+	if (typeHint != Ladspa && typeHint != Dssi
+		&& typeHint != Vst && typeHint != Lv2)
 		return NULL;
 
-	// Yep, most probably it's a dummy VST plugin effect...
+	// Yep, most probably it's a dummy (or cached) plugin type...
 	const unsigned long iIndex = props.at(7).toULong();
 
 	return new qtractorDummyPluginType(sText, iIndex, typeHint);
 }
 
 
+// Textual (cacheable) type descriptor (static).
+QString qtractorDummyPluginType::textFromType ( qtractorPluginType *pType )
+{
+	QStringList flags;
+	if (pType->isEditor())
+		flags.append("GUI");
+	if (pType->isConfigure())
+		flags.append("EXT");
+	if (pType->isRealtime())
+		flags.append("RT");
+
+	QStringList props;
+	props << qtractorPluginType::textFromHint(pType->typeHint());
+	props << QString(pType->name()).replace('|', '/');
+	props << QString::number(pType->audioIns())
+		+ ':' + QString::number(pType->audioOuts());
+	props << QString::number(pType->midiIns())
+		+ ':' + QString::number(pType->midiOuts());
+	props << QString::number(pType->controlIns())
+		+ ':' + QString::number(pType->controlOuts());
+	props << flags.join(",");
+	props << escapeText(pType->filename());
+	props << QString::number(pType->index());
+	props << "0x" + QString::number(pType->uniqueID(), 16);
+	props << QString(pType->label()).replace('|', '/');
+
+	return props.join("|");
+}
+
+
+// Descriptor field (filename) escaping helpers (static).
+QString qtractorDummyPluginType::escapeText ( const QString& sText )
+{
+	return QString(sText).replace('%', "%25").replace('|', "%7C");
+}
+
+QString qtractorDummyPluginType::unescapeText ( const QString& sText )
+{
+	return QString(sText).replace("%7C", "|").replace("%25", "%");
+}
+
+
 // end of qtractorPluginFactory.cpp
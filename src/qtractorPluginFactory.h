@@ -25,6 +25,7 @@
 #include "qtractorPlugin.h"
 
 #include <QProcess>
+#include <QTime>
 
 
 // Forward decls.
@@ -68,6 +69,16 @@ public:
 	// Type list reset method.
 	void clear();
 
+	// Persistent scan cache reset method (force full rescan).
+	void clearCache();
+
+	// Persistent scan cache type register method.
+	void addCacheType(qtractorPluginType *pType);
+
+	// Persistent scan cache failure mark method (retry on next scan).
+	void failCacheFile(
+		qtractorPluginType::Hint typeHint, const QString& sFilename);
+
 	// Global plugin-paths executive methods.
 	QStringList pluginPaths(qtractorPluginType::Hint typeHint);
 	void updatePluginPaths();
@@ -98,6 +109,54 @@ protected:
 	// Plugin scan reset method.
 	void reset();
 
+	// Persistent scan cache file path.
+	QString cacheFilename() const;
+
+	// Persistent scan cache methods.
+	struct CacheItem
+	{
+		CacheItem() : failed(false) {}
+
+		QString     stamp;
+		QStringList types;
+		bool        failed;
+	};
+
+	typedef QHash<QString, CacheItem> Cache;
+
+	void loadCache(Cache& cache) const;
+	void saveCache(const Cache& cache) const;
+
+	// Persistent scan cache file stamp and key helpers.
+	static QString cacheStamp(
+		qtractorPluginType::Hint typeHint, const QString& sFilename);
+	static QString cacheKey(
+		qtractorPluginType::Hint typeHint, const QString& sFilename);
+
+	// Persistent scan cache lookup method (true if hit).
+	bool addCacheTypes(const Cache& cache,
+		qtractorPluginType::Hint typeHint, const QString& sFilename);
+
+#ifdef CONFIG_LV2
+	// LV2 bundle stamp helper.
+	static QString lv2BundleStamp(const QString& sBundlePath);
+
+	// LV2 whole bundles stamp and cache lookup (true if hit).
+	QString lv2CacheStamp();
+	static QString lv2CacheKey();
+	bool addLv2CacheTypes(const Cache& cache, const QString& sLv2Stamp);
+#endif
+
+	// Persistent scan cache file register method.
+	void addCacheFile(
+		qtractorPluginType::Hint typeHint, const QString& sFilename);
+
+	// Proxy (out-of-process) client pool methods.
+	void startProxies();
+	qtractorPluginFactoryProxy *idleProxy();
+	void waitProxies();
+	void deleteProxies();
+
 private:
 
 	// Instance variables.
@@ -112,8 +171,11 @@ private:
 	// Internal plugin types list.
 	Types m_types;
 
-	// Proxy (out-of-process) client.
-	qtractorPluginFactoryProxy *m_pProxy;
+	// Persistent scan cache (current).
+	Cache m_cache;
+
+	// Proxy (out-of-process) client pool.
+	QList<qtractorPluginFactoryProxy *> m_proxies;
 
 	// Pseudo-singleton instance.
 	static qtractorPluginFactory *g_pPluginFactory;
@@ -139,11 +201,29 @@ public:
 	// Service methods.
 	bool addTypes(qtractorPluginType::Hint typeHint, const QString& sFilename);
 
+	// Busy state accessors.
+	bool isBusy() const { return m_bBusy; }
+
+	const QString& filename() const { return m_sFilename; }
+
+	// Whether current request is hanging or has crashed.
+	bool isStalled(int iTimeout) const;
+
+	// Abort current request (kill).
+	void abort();
+
 protected slots:
 
 	// Service slots.
 	void stdout_slot();
 	void stderr_slot();
+
+private:
+
+	// Instance variables.
+	bool    m_bBusy;
+	QString m_sFilename;
+	QTime   m_time;
 };
 
 
@@ -170,6 +250,13 @@ public:
 	// Factory method (static)
 	static qtractorDummyPluginType *createType(const QString& sText);
 
+	// Textual (cacheable) type descriptor (static).
+	static QString textFromType(qtractorPluginType *pType);
+
+	// Descriptor field (filename) escaping helpers (static).
+	static QString escapeText(const QString& sText);
+	static QString unescapeText(const QString& sText);
+
 private:
 
 	// Instance variables.
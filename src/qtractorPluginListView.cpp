@@ -864,8 +864,10 @@ void qtractorPluginListView::editPlugin (void)
 
 	if (pPlugin->isEditorVisible())
 		pPlugin->closeEditor();
-	else
+	else {
+		pPlugin->setDormant(false);
 		pPlugin->openEditor();
+	}
 }
 
 
@@ -1168,10 +1170,12 @@ void qtractorPluginListView::itemActivatedSlot ( QListWidgetItem *item )
 		& (Qt::ShiftModifier | Qt::ControlModifier))
 		bOpenEditor = !bOpenEditor;
 
-	if (bOpenEditor && (pPlugin->type())->isEditor())
+	if (bOpenEditor && (pPlugin->type())->isEditor()) {
+		pPlugin->setDormant(false);
 		pPlugin->openEditor();
-	else
+	} else {
 		pPlugin->openForm();
+	}
 }
 
 
@@ -230,10 +230,6 @@ void qtractorPluginSelectForm::typeHintChanged ( int iTypeHint )
 		= qtractorPluginType::hintFromText(
 			m_ui.PluginTypeComboBox->itemText(iTypeHint));
 
-	// Rescan not applicable to LV2 plug-in world.
-	m_ui.PluginRescanPushButton->setVisible(
-		typeHint != qtractorPluginType::Lv2);
-
 	qtractorPluginFactory *pPluginFactory
 		= qtractorPluginFactory::getInstance();
 	if (pPluginFactory && pPluginFactory->typeHint() != typeHint) {
@@ -258,8 +254,10 @@ void qtractorPluginSelectForm::rescan (void)
 {
 	qtractorPluginFactory *pPluginFactory
 		= qtractorPluginFactory::getInstance();
-	if (pPluginFactory)
+	if (pPluginFactory) {
+		pPluginFactory->clearCache();
 		pPluginFactory->clear();
+	}
 
 	refresh();
 }
@@ -51,7 +51,12 @@
 
 #include <QDomDocument>
 
+#include <QThread>
+#include <QMutex>
+#include <QFile>
+
 #include <stdlib.h>
+#include <fcntl.h>
 
 
 //-------------------------------------------------------------------------
@@ -121,6 +126,8 @@ qtractorSession::qtractorSession (void)
 
 	m_iLoopRecordingMode = 0;
 
+	m_pPrefetch = NULL;
+
 	clear();
 }
 
@@ -238,6 +245,8 @@ void qtractorSession::clear (void)
 
 	ATOMIC_SET(&m_busy, 0);
 
+	stopPrefetch();
+
 	m_pAudioPeakFactory->sync();
 
 	m_pCurrentTrack = NULL;
@@ -1100,6 +1109,46 @@ void qtractorSession::resetAllPlugins (void)
 }
 
 
+// Instantiate all dormant plugins with automated activation...
+void qtractorSession::wakeAutomatedPlugins (void)
+{
+	// All tracks...
+	for (qtractorTrack *pTrack = m_tracks.first();
+			pTrack; pTrack = pTrack->next()) {
+		(pTrack->pluginList())->wakeAutomated();
+	}
+
+	// All audio buses...
+	for (qtractorBus *pBus = m_pAudioEngine->buses().first();
+			pBus; pBus = pBus->next()) {
+		qtractorAudioBus *pAudioBus
+			= static_cast<qtractorAudioBus *> (pBus);
+		if (pAudioBus) {
+			if (pAudioBus->pluginList_in())
+				pAudioBus->pluginList_in()->wakeAutomated();
+			if (pAudioBus->pluginList_out())
+				pAudioBus->pluginList_out()->wakeAutomated();
+		}
+	}
+
+	// All MIDI buses...
+	for (qtractorBus *pBus = m_pMidiEngine->buses().first();
+			pBus; pBus = pBus->next()) {
+		qtractorMidiBus *pMidiBus
+			= static_cast<qtractorMidiBus *> (pBus);
+		if (pMidiBus) {
+			if (pMidiBus->pluginList_in())
+				pMidiBus->pluginList_in()->wakeAutomated();
+			if (pMidiBus->pluginList_out())
+				pMidiBus->pluginList_out()->wakeAutomated();
+		}
+	}
+
+	// Any background wake-up left over...
+	qtractorPlugin::updateWakeUps();
+}
+
+
 // MIDI engine accessor.
 qtractorMidiEngine *qtractorSession::midiEngine (void) const
 {
@@ -1811,6 +1860,220 @@ qtractorFileList *qtractorSession::files (void) const
 }
 
 
+//-------------------------------------------------------------------------
+// qtractorSessionPrefetch -- Session load file pre-fetcher.
+//
+// NOTE: This is a partial, cache-only measure: it just warms up the
+// OS file cache with all clip, curve and plug-in files, on a small
+// worker pool, while tracks, clips and plug-ins are still being
+// instantiated (and those files actually opened) in document order,
+// on the main thread, as ever. Missing or stale audio peak files are
+// (re)built on the peak factory thread; nothing else is staged.
+//
+// It is never joined while loading: it just runs detached, on its own
+// pace, owned by the session, which cancels it on clear (or close).
+//
+// Audio clip files are merely advised for read-ahead, where possible
+// (posix_fadvise), otherwise their leading part is read as for all
+// the rest (MIDI clips, curves and plug-in libraries).
+
+// Maximum prefetch size per file (bytes).
+#define QTRACTOR_SESSION_PREFETCH_MAX_SIZE	(4 << 20)
+
+class qtractorSessionPrefetch
+{
+public:
+
+	// Constructor.
+	qtractorSessionPrefetch(
+		const QStringList& files, const QStringList& audioFiles);
+
+	// Destructor (cancel and wait for workers).
+	~qtractorSessionPrefetch();
+
+	// Next file to fetch (workers).
+	bool next(QString& sFilename, bool& bAudio);
+
+	// Whether it has been cancelled (workers).
+	bool isCancel() const { return ATOMIC_GET(&m_cancel) > 0; }
+
+	// Total number of files to fetch.
+	int count() const { return m_files.count() + m_audioFiles.count(); }
+
+	// Collect file names from session tracks element.
+	static void collect(const QDomElement& eElement,
+		bool bClips, QStringList& files, QStringList& audioFiles);
+
+private:
+
+	// Worker thread.
+	class Thread : public QThread
+	{
+	public:
+
+		Thread(qtractorSessionPrefetch *pPrefetch)
+			: m_pPrefetch(pPrefetch) {}
+
+	protected:
+
+		void run();
+
+	private:
+
+		qtractorSessionPrefetch *m_pPrefetch;
+	};
+
+	// Instance variables.
+	QStringList m_files;
+	QStringList m_audioFiles;
+	int         m_iFile;
+	QMutex      m_mutex;
+
+	mutable qtractorAtomic m_cancel;
+
+	QList<Thread *> m_threads;
+};
+
+
+// Constructor.
+qtractorSessionPrefetch::qtractorSessionPrefetch (
+	const QStringList& files, const QStringList& audioFiles )
+	: m_files(files), m_audioFiles(audioFiles), m_iFile(0)
+{
+	m_files.removeDuplicates();
+	m_audioFiles.removeDuplicates();
+
+	ATOMIC_SET(&m_cancel, 0);
+
+	int iThreads = QThread::idealThreadCount();
+	if (iThreads > 4)
+		iThreads = 4;
+	if (iThreads > count())
+		iThreads = count();
+
+	for (int i = 0; i < iThreads; ++i) {
+		Thread *pThread = new Thread(this);
+		m_threads.append(pThread);
+		pThread->start(QThread::LowPriority);
+	}
+}
+
+
+// Destructor (cancel and wait for workers).
+qtractorSessionPrefetch::~qtractorSessionPrefetch (void)
+{
+	ATOMIC_SET(&m_cancel, 1);
+
+	m_mutex.lock();
+	m_iFile = count();
+	m_mutex.unlock();
+
+	QListIterator<Thread *> iter(m_threads);
+	while (iter.hasNext())
+		iter.next()->wait();
+
+	qDeleteAll(m_threads);
+	m_threads.clear();
+}
+
+
+// Next file to fetch (workers).
+bool qtractorSessionPrefetch::next ( QString& sFilename, bool& bAudio )
+{
+	QMutexLocker locker(&m_mutex);
+
+	if (m_iFile >= count())
+		return false;
+
+	// Audio files go first, as the largest ones...
+	const int iAudioFiles = m_audioFiles.count();
+	bAudio = (m_iFile < iAudioFiles);
+	if (bAudio)
+		sFilename = m_audioFiles.at(m_iFile);
+	else
+		sFilename = m_files.at(m_iFile - iAudioFiles);
+
+	++m_iFile;
+	return true;
+}
+
+
+// Worker thread procedure.
+void qtractorSessionPrefetch::Thread::run (void)
+{
+	char buf[65536];
+
+	QString sFilename;
+	bool bAudio = false;
+	while (m_pPrefetch->next(sFilename, bAudio)) {
+		QFile file(sFilename);
+		if (!file.open(QIODevice::ReadOnly))
+			continue;
+	#ifdef POSIX_FADV_WILLNEED
+		// Audio files are just advised for (asynchronous) read-ahead...
+		if (bAudio && ::posix_fadvise(file.handle(),
+				0, 0, POSIX_FADV_WILLNEED) == 0) {
+			file.close();
+			continue;
+		}
+	#endif
+		qint64 iSize = 0;
+		while (iSize < QTRACTOR_SESSION_PREFETCH_MAX_SIZE
+				&& !m_pPrefetch->isCancel()) {
+			const qint64 nread = file.read(buf, sizeof(buf));
+			if (nread < 1)
+				break;
+			iSize += nread;
+		}
+		file.close();
+	}
+}
+
+
+// Collect file names from session tracks element.
+void qtractorSessionPrefetch::collect ( const QDomElement& eElement,
+	bool bClips, QStringList& files, QStringList& audioFiles )
+{
+	for (QDomNode nChild = eElement.firstChild();
+			!nChild.isNull();
+				nChild = nChild.nextSibling()) {
+		QDomElement eChild = nChild.toElement();
+		if (eChild.isNull())
+			continue;
+		const QString& sTagName = eChild.tagName();
+		if (sTagName == "filename") {
+			const QString& sParentName = eElement.tagName();
+			if (bClips && sParentName == "audio-clip") {
+				const QFileInfo fi(eChild.text());
+				if (fi.isFile())
+					audioFiles.append(fi.absoluteFilePath());
+			}
+			else
+			if ((bClips && sParentName == "midi-clip")
+				|| sParentName == "curve-file"
+				|| sParentName == "plugin") {
+				const QFileInfo fi(eChild.text());
+				if (fi.isFile())
+					files.append(fi.absoluteFilePath());
+			}
+		}
+		else
+		if (bClips || sTagName != "clips")
+			collect(eChild, bClips, files, audioFiles);
+	}
+}
+
+
+// Cancel and wait for any (detached) file pre-fetcher.
+void qtractorSession::stopPrefetch (void)
+{
+	if (m_pPrefetch) {
+		delete m_pPrefetch;
+		m_pPrefetch = NULL;
+	}
+}
+
+
 // Document element methods.
 bool qtractorSession::loadElement (
 	qtractorSessionDocument *pDocument, QDomElement *pElement )
@@ -1818,6 +2081,22 @@ bool qtractorSession::loadElement (
 	qtractorSession::clear();
 	qtractorSession::lock();
 
+	// Keep track of each load stage timing...
+	m_loadTimes = LoadTimes();
+
+	QTime t;
+	t.start();
+
+	// Staged load: first get all the files we're about
+	// to open warming up, concurrently, on the background...
+	QStringList files;
+	QStringList audioFiles;
+	const QDomElement eTracks = pElement->firstChildElement("tracks");
+	qtractorSessionPrefetch::collect(eTracks,
+		!pDocument->isTemplate(), files, audioFiles);
+	m_pPrefetch = new qtractorSessionPrefetch(files, audioFiles);
+	m_loadTimes.files = m_pPrefetch->count();
+
 	// Templates have no session name...
 	if (!pDocument->isTemplate())
 		qtractorSession::setSessionName(pElement->attribute("name"));
@@ -2026,6 +2305,7 @@ bool qtractorSession::loadElement (
 		else
 		// Load tracks...
 		if (eChild.tagName() == "tracks") {
+			m_loadTimes.setup += t.restart();
 			for (QDomNode nTrack = eChild.firstChild();
 					!nTrack.isNull();
 						nTrack = nTrack.nextSibling()) {
@@ -2069,6 +2349,7 @@ bool qtractorSession::loadElement (
 			}
 			// Stabilize things a bit...
 			stabilize();
+			m_loadTimes.tracks += t.restart();
 		}
 	}
 
@@ -2083,6 +2364,14 @@ bool qtractorSession::loadElement (
 
 	qtractorSession::unlock();
 
+	m_loadTimes.commit = t.elapsed();
+
+#ifdef CONFIG_DEBUG
+	qDebug("qtractorSession::loadElement() files=%d setup=%d tracks=%d"
+		" commit=%d (msecs)", m_loadTimes.files,
+		m_loadTimes.setup, m_loadTimes.tracks, m_loadTimes.commit);
+#endif
+
 	return true;
 }
 
@@ -41,6 +41,7 @@ class qtractorInstrumentList;
 class qtractorCommandList;
 class qtractorCommand;
 class qtractorFileList;
+class qtractorSessionPrefetch;
 
 class QDomElement;
 
@@ -215,6 +216,9 @@ public:
 	// Reset (reactivate) all plugin chains...
 	void resetAllPlugins();
 
+	// Instantiate all dormant plugins with automated activation.
+	void wakeAutomatedPlugins();
+
 	// Device engine accessors.
 	qtractorMidiEngine  *midiEngine() const;
 	qtractorAudioEngine *audioEngine() const;
@@ -336,6 +340,20 @@ public:
 	bool loadElement(qtractorSessionDocument *pDocument, QDomElement *pElement);
 	bool saveElement(qtractorSessionDocument *pDocument, QDomElement *pElement);
 
+	// Last session load stage timings (msecs).
+	struct LoadTimes
+	{
+		LoadTimes() : files(0), setup(0), tracks(0), commit(0) {}
+
+		int files;      // Number of pre-fetched files (background).
+		int setup;      // Session properties and state.
+		int tracks;     // Track, clip and plug-in instantiation.
+		int commit;     // Final session update.
+	};
+
+	const LoadTimes& loadTimes() const
+		{ return m_loadTimes; }
+
 	// Session property structure.
 	struct Properties
 	{
@@ -388,6 +406,13 @@ private:
 
 	Properties     m_props;             // Session properties.
 
+	LoadTimes      m_loadTimes;         // Last load stage timings.
+
+	// Cancel and wait for any (detached) file pre-fetcher.
+	void stopPrefetch();
+
+	qtractorSessionPrefetch *m_pPrefetch; // Detached file pre-fetcher.
+
 	unsigned long  m_iSessionStart;     // Session start in frames.
 	unsigned long  m_iSessionEnd;		// Session end in frames.
 
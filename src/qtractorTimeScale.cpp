@@ -27,6 +27,17 @@
 // class qtractorTimeScale -- Time scale conversion helper class.
 //
 
+// Destructor.
+qtractorTimeScale::~qtractorTimeScale (void)
+{
+	reclaimIndexes(true);
+
+	Index *pIndex = m_pIndex.fetchAndStoreOrdered(0);
+	if (pIndex)
+		delete pIndex;
+}
+
+
 // Node list cleaner.
 void qtractorTimeScale::reset (void)
 {
@@ -209,6 +220,11 @@ qtractorTimeScale::Node *qtractorTimeScale::Cursor::seekFrame (
 			return 0;
 	}
 
+	// Still on the current node?...
+	Node *pNext = node->next();
+	if (iFrame >= node->frame && (pNext == 0 || iFrame < pNext->frame))
+		return node;
+
 	if (iFrame > node->frame) {
 		// Seek frame forward...
 		while (node && node->next() && iFrame >= (node->next())->frame)
@@ -293,6 +309,11 @@ qtractorTimeScale::Node *qtractorTimeScale::Cursor::seekTick (
 			return 0;
 	}
 
+	// Still on the current node?...
+	Node *pNext = node->next();
+	if (iTick >= node->tick && (pNext == 0 || iTick < pNext->tick))
+		return node;
+
 	if (iTick > node->tick) {
 		// Seek tick forward...
 		while (node && node->next() && iTick >= (node->next())->tick)
@@ -409,6 +430,9 @@ void qtractorTimeScale::updateNode ( qtractorTimeScale::Node *pNode )
 		pNext = pNext->next();
 	}
 
+	// Refresh the lookup tables...
+	updateIndex();
+
 	// And update marker/bar positions too...
 	updateMarkers(pNode->prev());
 }
@@ -436,6 +460,9 @@ void qtractorTimeScale::removeNode ( qtractorTimeScale::Node *pNode )
 	// Actually remove/unlink the node...
 	m_nodes.remove(pNode);
 
+	// Refresh the lookup tables...
+	updateIndex();
+
 	// Then update marker/bar positions too...
 	updateMarkers(pNodePrev);
 }
@@ -458,11 +485,177 @@ void qtractorTimeScale::updateScale (void)
 		pNext = pNext->next();
 	}
 
+	// Refresh the lookup tables...
+	updateIndex();
+
 	// Also update all marker/bar positions too...
 	updateMarkers(m_nodes.first());
 }
 
 
+// Rebuild the tempo-map index.
+void qtractorTimeScale::updateIndex (void)
+{
+	// Retire the current one, as it might still be in use...
+	Index *pOldIndex = m_pIndex.fetchAndStoreOrdered(new Index(this));
+	if (pOldIndex)
+		m_retired.append(pOldIndex);
+
+	// Reclaim all retired ones, if no one's reading...
+	reclaimIndexes(false);
+}
+
+
+// Reclaim retired tempo-map indexes, only while there are no
+// readers in (or all). Any reader coming in after the current
+// index was swapped can only get hold of the new one, so those
+// retired before are free to go if no reader was caught inside.
+void qtractorTimeScale::reclaimIndexes ( bool bForce )
+{
+	if (!bForce && m_iIndexReaders.fetchAndAddOrdered(0) > 0)
+		return;
+
+	qDeleteAll(m_retired);
+	m_retired.clear();
+}
+
+
+//----------------------------------------------------------------------
+// class qtractorTimeScale::Index -- Tempo-map lookup tables.
+//
+
+// Constructor.
+qtractorTimeScale::Index::Index ( qtractorTimeScale *pTimeScale )
+	: m_iCount(0), m_pItems(0)
+{
+	const qtractorList<Node>& nodes = pTimeScale->nodes();
+
+	m_fFrameRate = pTimeScale->frameRate();
+
+	m_pItems = new Item [nodes.count() + 1];
+
+	Node *pNode = nodes.first();
+	while (pNode) {
+		Item *pItem = &m_pItems[m_iCount++];
+		pItem->frame = pNode->frame;
+		pItem->tick = pNode->tick;
+		pItem->tempo = pNode->tempo;
+		pItem->ticksPerBeat = pNode->ticksPerBeat;
+		pItem->tickRate = pNode->tickRate;
+		pItem->beatRate = pNode->beatRate;
+		pNode = pNode->next();
+	}
+}
+
+
+// Destructor.
+qtractorTimeScale::Index::~Index (void)
+{
+	delete [] m_pItems;
+}
+
+
+// Frame/tick convertors.
+unsigned long qtractorTimeScale::Index::tickFromFrame (
+	unsigned long iFrame ) const
+{
+	return tickFromFrame(seekFrame(iFrame), iFrame);
+}
+
+
+unsigned long qtractorTimeScale::Index::frameFromTick (
+	unsigned long iTick ) const
+{
+	return frameFromTick(seekTick(iTick), iTick);
+}
+
+
+unsigned long qtractorTimeScale::Index::tickFromFrame (
+	const Item *pItem, unsigned long iFrame ) const
+{
+	if (pItem == 0)
+		return 0;
+
+	return pItem->tick + uroundf(
+		(pItem->tickRate * (iFrame - pItem->frame)) / m_fFrameRate);
+}
+
+
+unsigned long qtractorTimeScale::Index::frameFromTick (
+	const Item *pItem, unsigned long iTick ) const
+{
+	if (pItem == 0)
+		return 0;
+
+	return pItem->frame + uroundf(
+		(m_fFrameRate * (iTick - pItem->tick)) / pItem->tickRate);
+}
+
+
+// Tick/Frame range conversion (delta conversion).
+unsigned long qtractorTimeScale::Index::frameFromTickRange (
+	unsigned long iTickStart, unsigned long iTickEnd, bool bOffset ) const
+{
+	const Item *pItem = seekTick(iTickStart);
+	const unsigned long iFrameStart = frameFromTick(pItem, iTickStart);
+	if (!bOffset) pItem = seekTick(iTickEnd);
+	const unsigned long iFrameEnd = frameFromTick(pItem, iTickEnd);
+	return (iFrameEnd > iFrameStart ? iFrameEnd - iFrameStart : 0);
+}
+
+
+unsigned long qtractorTimeScale::Index::tickFromFrameRange (
+	unsigned long iFrameStart, unsigned long iFrameEnd, bool bOffset ) const
+{
+	const Item *pItem = seekFrame(iFrameStart);
+	const unsigned long iTickStart = tickFromFrame(pItem, iFrameStart);
+	if (!bOffset) pItem = seekFrame(iFrameEnd);
+	const unsigned long iTickEnd = tickFromFrame(pItem, iFrameEnd);
+	return (iTickEnd > iTickStart ? iTickEnd - iTickStart : 0);
+}
+
+
+// Seek methods: last item not past the given position.
+const qtractorTimeScale::Index::Item *qtractorTimeScale::Index::seekFrame (
+	unsigned long iFrame ) const
+{
+	if (m_iCount < 1)
+		return 0;
+
+	unsigned int lo = 1;
+	unsigned int hi = m_iCount;
+	while (lo < hi) {
+		const unsigned int mid = (lo + hi) >> 1;
+		if (m_pItems[mid].frame > iFrame)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return &m_pItems[lo - 1];
+}
+
+
+const qtractorTimeScale::Index::Item *qtractorTimeScale::Index::seekTick (
+	unsigned long iTick ) const
+{
+	if (m_iCount < 1)
+		return 0;
+
+	unsigned int lo = 1;
+	unsigned int hi = m_iCount;
+	while (lo < hi) {
+		const unsigned int mid = (lo + hi) >> 1;
+		if (m_pItems[mid].tick > iTick)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return &m_pItems[lo - 1];
+}
+
+
 // Convert frames to time string and vice-versa.
 unsigned long qtractorTimeScale::frameFromTextEx (
 	DisplayFormat displayFormat,
@@ -691,28 +884,16 @@ QStringList qtractorTimeScale::snapItems ( int iSnap )
 
 // Tick/Frame range conversion (delta conversion).
 unsigned long qtractorTimeScale::frameFromTickRange (
-	unsigned long iTickStart, unsigned long iTickEnd, bool bOffset )
-{
-	Node *pNode = m_cursor.seekTick(iTickStart);
-	const unsigned long iFrameStart
-		= (pNode ? pNode->frameFromTick(iTickStart) : 0);
-	if (!bOffset) pNode = m_cursor.seekTick(iTickEnd);
-	const unsigned long iFrameEnd
-		= (pNode ? pNode->frameFromTick(iTickEnd) : 0);
-	return (iFrameEnd > iFrameStart ? iFrameEnd - iFrameStart : 0);
+	unsigned long iTickStart, unsigned long iTickEnd, bool bOffset ) const
+{
+	return IndexReader(this)->frameFromTickRange(iTickStart, iTickEnd, bOffset);
 }
 
 
 unsigned long qtractorTimeScale::tickFromFrameRange (
-	unsigned long iFrameStart, unsigned long iFrameEnd, bool bOffset )
-{
-	Node *pNode = m_cursor.seekFrame(iFrameStart);
-	const unsigned long iTickStart
-		= (pNode ? pNode->tickFromFrame(iFrameStart) : 0);
-	if (!bOffset) pNode = m_cursor.seekFrame(iFrameEnd);
-	const unsigned long iTickEnd
-		= (pNode ? pNode->tickFromFrame(iFrameEnd) : 0);
-	return (iTickEnd > iTickStart ? iTickEnd - iTickStart : 0);
+	unsigned long iFrameStart, unsigned long iFrameEnd, bool bOffset ) const
+{
+	return IndexReader(this)->tickFromFrameRange(iFrameStart, iFrameEnd, bOffset);
 }
 
 
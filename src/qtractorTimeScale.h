@@ -27,6 +27,9 @@
 #include <QStringList>
 #include <QColor>
 
+#include <QAtomicPointer>
+#include <QAtomicInt>
+
 
 //----------------------------------------------------------------------
 // class qtractorTimeScale -- Time scale conversion helper class.
@@ -41,11 +44,16 @@ public:
 
 	// Default constructor.
 	qtractorTimeScale() : m_displayFormat(Frames),
-		m_cursor(this), m_markerCursor(this) { clear(); }
+		m_cursor(this), m_pIndex(0), m_iIndexReaders(0),
+		m_markerCursor(this) { clear(); }
 
 	// Copy constructor.
 	qtractorTimeScale(const qtractorTimeScale& ts)
-		: m_cursor(this), m_markerCursor(this) { copy(ts); }
+		: m_cursor(this), m_pIndex(0), m_iIndexReaders(0),
+		m_markerCursor(this) { copy(ts); }
+
+	// Destructor.
+	~qtractorTimeScale();
 
 	// Assignment operator,
 	qtractorTimeScale& operator=(const qtractorTimeScale& ts)
@@ -104,6 +112,9 @@ public:
 	// Beat divisor (snap index) text item list.
 	static QStringList snapItems(int iSnap = 0);
 
+	// Tempo-map index (forward decl).
+	class Index;
+
 	// Time scale node declaration.
 	class Node : public qtractorList<Node>::Link
 	{
@@ -242,6 +253,8 @@ public:
 		// Node cached coefficients.
 		float tickRate;
 		float beatRate;
+
+		friend class Index;
 	};
 
 	// Node list accessor.
@@ -280,6 +293,93 @@ public:
 	// Internal cursor accessor.
 	Cursor& cursor() { return m_cursor; }
 
+	// Immutable tempo-map index, for random access lookups
+	// (binary search over a by-value copy of the node tables,
+	// holding no references to the mutable node list at all).
+	class Index
+	{
+	public:
+
+		// Constructor.
+		Index(qtractorTimeScale *pTimeScale);
+
+		// Destructor.
+		~Index();
+
+		// Frame/tick convertors.
+		unsigned long tickFromFrame(unsigned long iFrame) const;
+		unsigned long frameFromTick(unsigned long iTick) const;
+
+		// Tick/Frame range conversion (delta conversion).
+		unsigned long frameFromTickRange(unsigned long iTickStart,
+			unsigned long iTickEnd, bool bOffset) const;
+		unsigned long tickFromFrameRange(unsigned long iFrameStart,
+			unsigned long iFrameEnd, bool bOffset) const;
+
+	protected:
+
+		// Node item (by value).
+		struct Item
+		{
+			unsigned long  frame;
+			unsigned long  tick;
+			float          tempo;
+			unsigned short ticksPerBeat;
+			float          tickRate;
+			float          beatRate;
+		};
+
+		// Seek methods: last item not past the given position.
+		const Item *seekFrame(unsigned long iFrame) const;
+		const Item *seekTick(unsigned long iTick) const;
+
+		// Item frame/tick convertors.
+		unsigned long tickFromFrame(
+			const Item *pItem, unsigned long iFrame) const;
+		unsigned long frameFromTick(
+			const Item *pItem, unsigned long iTick) const;
+
+	private:
+
+		// Member variables.
+		unsigned int m_iCount;
+		Item        *m_pItems;
+		float        m_fFrameRate;
+	};
+
+	// Tempo-map index read section (any thread, lock-free):
+	// retired indexes are only reclaimed while no reader is inside,
+	// so the index must not be held past this guard lifetime.
+	class IndexReader
+	{
+	public:
+
+		// Constructor: enter the read section.
+		IndexReader(const qtractorTimeScale *pTimeScale)
+			: m_pTimeScale(pTimeScale)
+		{
+			m_pTimeScale->m_iIndexReaders.fetchAndAddOrdered(1);
+		#if QT_VERSION >= 0x050000
+			m_pIndex = m_pTimeScale->m_pIndex.loadAcquire();
+		#else
+			m_pIndex = m_pTimeScale->m_pIndex;
+		#endif
+		}
+
+		// Destructor: leave the read section.
+		~IndexReader()
+			{ m_pTimeScale->m_iIndexReaders.fetchAndAddOrdered(-1); }
+
+		// Current tempo-map index accessor (read-only).
+		const Index *operator-> () const { return m_pIndex; }
+
+	private:
+
+		// Member variables.
+		const qtractorTimeScale *m_pTimeScale;
+		const Index *m_pIndex;
+	};
+
 	// Node list specifics.
 	Node *addNode(
 		unsigned long iFrame = 0,
@@ -325,18 +425,12 @@ public:
 		return (pNode ? pNode->frameFromBeat(iBeat) : 0);
 	}
 
-	// Frame/tick general converters.
-	unsigned long tickFromFrame(unsigned long iFrame)
-	{
-		Node *pNode = m_cursor.seekFrame(iFrame);
-		return (pNode ? pNode->tickFromFrame(iFrame) : 0);
-	}
-
-	unsigned long frameFromTick(unsigned long iTick)
-	{
-		Node *pNode = m_cursor.seekTick(iTick);
-		return (pNode ? pNode->frameFromTick(iTick) : 0);
-	}
+	// Frame/tick general converters
+	// (stateless, safe for real-time threads).
+	unsigned long tickFromFrame(unsigned long iFrame) const
+		{ return IndexReader(this)->tickFromFrame(iFrame); }
+	unsigned long frameFromTick(unsigned long iTick) const
+		{ return IndexReader(this)->frameFromTick(iTick); }
 
 	// Tick/pixel general converters.
 	unsigned long tickFromPixel(int x)
@@ -480,9 +574,9 @@ public:
 
 	// Tick/Frame range conversion (delta conversion).
 	unsigned long frameFromTickRange(
-		unsigned long iTickStart, unsigned long iTickEnd, bool bOffset);
+		unsigned long iTickStart, unsigned long iTickEnd, bool bOffset) const;
 	unsigned long tickFromFrameRange(
-		unsigned long iFrameStart, unsigned long iFrameEnd, bool bOffset);
+		unsigned long iFrameStart, unsigned long iFrameEnd, bool bOffset) const;
 
 	// Location marker declaration.
 	class Marker : public qtractorList<Marker>::Link
@@ -561,6 +655,14 @@ protected:
 	float pixelRate() const { return m_fPixelRate; }
 	float frameRate() const { return m_fFrameRate; }
 
+	// Rebuild the tempo-map index.
+	void updateIndex();
+
+	// Reclaim retired tempo-map indexes.
+	void reclaimIndexes(bool bForce);
+
+	friend class IndexReader;
+
 private:
 
 	unsigned short m_iSnapPerBeat;      // Snap per beat (divisor).
@@ -579,6 +681,13 @@ private:
 	// Internal node cursor.
 	Cursor m_cursor;
 
+	// Tempo-map index (current and retired).
+	QAtomicPointer<Index> m_pIndex;
+	QList<Index *> m_retired;
+
+	// Tempo-map index readers (in read section).
+	mutable QAtomicInt m_iIndexReaders;
+
 	// Tempo-map independent coefficients.
 	float m_fPixelRate;
 	float m_fFrameRate;
@@ -51,6 +51,10 @@
 #include <QFileInfo>
 
 
+// MIDI record buffer size (in events; power of two).
+#define QTRACTOR_TRACK_RECORD_ITEMS	1024
+
+
 //------------------------------------------------------------------------
 // qtractorTrack::StateObserver -- Local track state observer.
 
@@ -318,6 +322,11 @@ qtractorTrack::qtractorTrack ( qtractorSession *pSession, TrackType trackType )
 
 	m_bClipRecordEx = false;
 
+	m_pRecordItems = new RecordItem [QTRACTOR_TRACK_RECORD_ITEMS];
+	m_iRecordMask  = QTRACTOR_TRACK_RECORD_ITEMS - 1;
+	ATOMIC_SET(&m_iRecordRead,  0);
+	ATOMIC_SET(&m_iRecordWrite, 0);
+
 	m_clips.setAutoDelete(true);
 
 	m_pSyncThread = NULL;
@@ -390,6 +399,10 @@ qtractorTrack::~qtractorTrack (void)
 		delete m_pPluginList;
 	if (m_pMonitor)
 		delete m_pMonitor;
+
+	// Discard any leftovers...
+	drainRecord();
+	delete [] m_pRecordItems;
 }
 
 
@@ -1109,6 +1122,17 @@ void qtractorTrack::removeClip ( qtractorClip *pClip )
 // Current clip on record (capture).
 void qtractorTrack::setClipRecord ( qtractorClip *pClipRecord )
 {
+	// Get pending record events into the current one first,
+	// while the MIDI output thread is being held back...
+	if (ATOMIC_GET(&m_iRecordRead) != ATOMIC_GET(&m_iRecordWrite)) {
+		qtractorMidiEngine *pMidiEngine = m_pSession->midiEngine();
+		if (pMidiEngine)
+			pMidiEngine->lockOutput();
+		drainRecord();
+		if (pMidiEngine)
+			pMidiEngine->unlockOutput();
+	}
+
 	if (!m_bClipRecordEx && m_pClipRecord)
 		delete m_pClipRecord;
 
@@ -1129,6 +1153,57 @@ qtractorClip *qtractorTrack::clipRecord (void) const
 }
 
 
+// MIDI record buffering (MIDI input thread): events are taken
+// as owned, tagged with the clip on record they were meant for.
+bool qtractorTrack::recordEvent (
+	qtractorClip *pClipRecord, qtractorMidiEvent *pEvent )
+{
+	const unsigned int w = ATOMIC_GET(&m_iRecordWrite);
+	const unsigned int w1 = (w + 1) & m_iRecordMask;
+	if (w1 == (unsigned int) ATOMIC_GET(&m_iRecordRead)) {
+		delete pEvent;	// Overflow!
+		return false;
+	}
+
+	RecordItem *pItem = &m_pRecordItems[w];
+	pItem->clip  = pClipRecord;
+	pItem->event = pEvent;
+
+	ATOMIC_SET(&m_iRecordWrite, w1);
+	return true;
+}
+
+
+// Drain all pending record events into the current clip on
+// record, in one go (MIDI output thread, or locked as such);
+// stale ones, meant for a former clip on record, are dropped.
+void qtractorTrack::drainRecord (void)
+{
+	unsigned int r = ATOMIC_GET(&m_iRecordRead);
+	const unsigned int w = ATOMIC_GET(&m_iRecordWrite);
+	if (r == w)
+		return;
+
+	qtractorMidiSequence *pSeq = NULL;
+	if (m_props.trackType == qtractorTrack::Midi && m_pClipRecord) {
+		qtractorMidiClip *pMidiClip
+			= static_cast<qtractorMidiClip *> (m_pClipRecord);
+		pSeq = pMidiClip->sequence();
+	}
+
+	while (r != w) {
+		RecordItem *pItem = &m_pRecordItems[r];
+		if (pSeq && pItem->clip == m_pClipRecord)
+			pSeq->addEvent(pItem->event);
+		else
+			delete pItem->event;
+		++r &= m_iRecordMask;
+	}
+
+	ATOMIC_SET(&m_iRecordRead, r);
+}
+
+
 // Current clip on record absolute start frame (capture).
 void qtractorTrack::setClipRecordStart ( unsigned long iClipRecordStart )
 {
@@ -1272,6 +1347,9 @@ void qtractorTrack::process ( qtractorClip *pClip,
 		// Plugin chain post-processing...
 		if (m_pPluginList->isActivated())
 			m_pPluginList->process(pOutputBus->buffer(), nframes);
+		// Latency compensation...
+		m_pPluginList->process_latency(pOutputBus->buffer(),
+			nframes, pOutputBus->trackLatency());
 		// Monitor passthru...
 		pAudioMonitor->process(pOutputBus->buffer(), nframes);
 		// Actually render it...
@@ -1315,6 +1393,9 @@ void qtractorTrack::process_export ( qtractorClip *pClip,
 		// Plugin chain post-processing...
 		if (m_pPluginList->isActivated())
 			m_pPluginList->process(pOutputBus->buffer(), nframes);
+		// Latency compensation...
+		m_pPluginList->process_latency(pOutputBus->buffer(),
+			nframes, pOutputBus->trackLatency());
 		// Monitor passthru...
 		pAudioMonitor->process(pOutputBus->buffer(), nframes);
 		// Actually render it...
@@ -2174,6 +2255,7 @@ void qtractorTrack::saveCurveFile ( qtractorDocument *pDocument,
 		pCurveItem->locked = pCurve->isLocked();
 		pCurveItem->logarithmic = pCurve->isLogarithmic();
 		pCurveItem->color = pCurve->color();
+		pCurveItem->tolerance = pCurve->tolerance();
 		pCurveItem->subject = pCurve->subject();
 		pCurveFile->addItem(pCurveItem);
 	}
@@ -2192,6 +2274,7 @@ void qtractorTrack::saveCurveFile ( qtractorDocument *pDocument,
 		pCurveItem->locked = pCurve->isLocked();
 		pCurveItem->logarithmic = pCurve->isLogarithmic();
 		pCurveItem->color = pCurve->color();
+		pCurveItem->tolerance = pCurve->tolerance();
 		pCurveItem->subject = pCurve->subject();
 		pCurveFile->addItem(pCurveItem);
 	}
@@ -2210,6 +2293,7 @@ void qtractorTrack::saveCurveFile ( qtractorDocument *pDocument,
 		pCurveItem->locked = pCurve->isLocked();
 		pCurveItem->logarithmic = pCurve->isLogarithmic();
 		pCurveItem->color = pCurve->color();
+		pCurveItem->tolerance = pCurve->tolerance();
 		pCurveItem->subject = pCurve->subject();
 		pCurveFile->addItem(pCurveItem);
 	}
@@ -2228,6 +2312,7 @@ void qtractorTrack::saveCurveFile ( qtractorDocument *pDocument,
 		pCurveItem->locked = pCurve->isLocked();
 		pCurveItem->logarithmic = pCurve->isLogarithmic();
 		pCurveItem->color = pCurve->color();
+		pCurveItem->tolerance = pCurve->tolerance();
 		pCurveItem->subject = pCurve->subject();
 		pCurveFile->addItem(pCurveItem);
 	}
@@ -2246,6 +2331,7 @@ void qtractorTrack::saveCurveFile ( qtractorDocument *pDocument,
 		pCurveItem->locked = pCurve->isLocked();
 		pCurveItem->logarithmic = pCurve->isLogarithmic();
 		pCurveItem->color = pCurve->color();
+		pCurveItem->tolerance = pCurve->tolerance();
 		pCurveItem->subject = pCurve->subject();
 		pCurveFile->addItem(pCurveItem);
 	}
@@ -2264,6 +2350,7 @@ void qtractorTrack::saveCurveFile ( qtractorDocument *pDocument,
 		pCurveItem->locked = pCurve->isLocked();
 		pCurveItem->logarithmic = pCurve->isLogarithmic();
 		pCurveItem->color = pCurve->color();
+		pCurveItem->tolerance = pCurve->tolerance();
 		pCurveItem->subject = pCurve->subject();
 		pCurveFile->addItem(pCurveItem);
 	}
@@ -2273,7 +2360,8 @@ void qtractorTrack::saveCurveFile ( qtractorDocument *pDocument,
 
 	const QString sBaseName(trackName() + "_curve");
 	const int iClipNo = (pCurveFile->filename().isEmpty() ? 0 : 1);
-	pCurveFile->setFilename(pSession->createFilePath(sBaseName, "mid", iClipNo));
+	pCurveFile->setFilename(pSession->createFilePath(
+		sBaseName, qtractorCurveFile::defaultExt(), iClipNo));
 
 	pCurveFile->save(pDocument, pElement, pSession->timeScale());
 }
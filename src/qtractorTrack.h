@@ -23,6 +23,7 @@
 #define __qtractorTrack_h
 
 #include "qtractorList.h"
+#include "qtractorAtomic.h"
 
 #include "qtractorMidiControl.h"
 
@@ -44,6 +45,7 @@ class qtractorAudioBufferThread;
 class qtractorCurveList;
 class qtractorCurveFile;
 class qtractorCurve;
+class qtractorMidiEvent;
 
 // Special forward declarations.
 class QDomElement;
@@ -190,6 +192,12 @@ public:
 	void setClipRecordEx(bool bClipRecordEx);
 	bool isClipRecordEx() const;
 
+	// MIDI record buffering: events are pushed as captured
+	// (MIDI input thread) and drained into the clip on record
+	// in batch (MIDI output thread, or before record clip changes).
+	bool recordEvent(qtractorClip *pClipRecord, qtractorMidiEvent *pEvent);
+	void drainRecord();
+
 	// Background color accessors.
 	void setBackground(const QColor& bg);
 	const QColor& background() const;
@@ -360,6 +368,18 @@ private:
 
 	bool m_bClipRecordEx;               // Current clip on record/overdub flag.
 
+	// MIDI record buffer (single-producer/single-consumer ring).
+	struct RecordItem
+	{
+		qtractorClip      *clip;
+		qtractorMidiEvent *event;
+	};
+
+	RecordItem    *m_pRecordItems;
+	unsigned int   m_iRecordMask;
+	qtractorAtomic m_iRecordRead;
+	qtractorAtomic m_iRecordWrite;
+
 	qtractorPluginList *m_pPluginList;	// Plugin chain (audio).
 
 	// Audio buffer ring-cache (playlist).
@@ -908,15 +908,38 @@ void qtractorVstPlugin::process (
 }
 
 
-// Parameter update method.
-void qtractorVstPlugin::updateParam (
-	qtractorPluginParam *pParam, float fValue, bool /*bUpdate*/ )
+// Plugin latency (in frames), as of the effect initial delay.
+unsigned long qtractorVstPlugin::latency (void) const
+{
+	if (instances() < 1)
+		return 0;
+
+	AEffect *pVstEffect = vst_effect(0);
+	if (pVstEffect == NULL || pVstEffect->initialDelay < 1)
+		return 0;
+
+	return pVstEffect->initialDelay;
+}
+
+
+// Real-time parameter change applier
+// (VST 2.x parameters aren't sample-accurate).
+//
+// NOTE: This is called on the audio thread, in between process
+// calls (or from the activating thread, while not processing),
+// which is where VST 2.x hosts are expected to call setParameter
+// anyway: plugins must handle it there, as automation does, and
+// their editors get notified on the GUI thread idle timer.
+void qtractorVstPlugin::processParam (
+	qtractorPluginParam *pParam, float fValue, unsigned long /*iOffset*/ )
 {
 #ifdef CONFIG_DEBUG_0
-	qDebug("qtractorVstPlugin[%p]::updateParam(%lu, %g, %d)",
-		this, pParam->index(), fValue, int(bUpdate));
+	qDebug("qtractorVstPlugin[%p]::processParam(%lu, %g)",
+		this, pParam->index(), fValue);
 #endif
 
+	*pParam->data() = fValue;
+
 	// Maybe we're not pretty instantiated yet...
 	for (unsigned short i = 0; i < instances(); ++i) {
 		AEffect *pVstEffect = vst_effect(i);
@@ -948,7 +971,8 @@ void qtractorVstPlugin::selectProgram ( int iBank, int iProg )
 	for (unsigned short i = 0; i < instances(); ++i)
 		vst_dispatch(i, effSetProgram, 0, iIndex, NULL, 0.0f);
 
-	// Reset parameters default value...
+	// Reset parameters default value,
+	// through the usual parameter change queue...
 	AEffect *pVstEffect = vst_effect(0);
 	if (pVstEffect) {
 		const qtractorPlugin::Params& params = qtractorPlugin::params();
@@ -956,9 +980,10 @@ void qtractorVstPlugin::selectProgram ( int iBank, int iProg )
 		const qtractorPlugin::Params::ConstIterator param_end = params.constEnd();
 		for ( ; param != param_end; ++param) {
 			qtractorPluginParam *pParam = param.value();
-			float *pfValue = pParam->subject()->data();
-			*pfValue = pVstEffect->getParameter(pVstEffect, pParam->index());
-			pParam->setDefaultValue(*pfValue);
+			const float fValue
+				= pVstEffect->getParameter(pVstEffect, pParam->index());
+			pParam->setDefaultValue(fValue);
+			pParam->setValue(fValue, false);
 		}
 	}
 }
@@ -1016,6 +1041,9 @@ void qtractorVstPlugin::configure ( const QString& sKey, const QString& sValue )
 // Plugin configuration/state snapshot.
 void qtractorVstPlugin::freezeConfigs (void)
 {
+	// Any pending changes, while deactivated, go first...
+	flushParams();
+
 	// HACK: Make sure all parameter values are in sync,
 	// provided freezeConfigs() are always called when
 	// saving plugin's state and before parameter values.
@@ -130,8 +130,8 @@ public:
 	// The main plugin processing procedure.
 	void process(float **ppIBuffer, float **ppOBuffer, unsigned int nframes);
 
-	// Parameter update method.
-	void updateParam(qtractorPluginParam *pParam, float fValue, bool bUpdate);
+	// Plugin latency (in frames), as of the effect initial delay.
+	unsigned long latency() const;
 
 	// Bank/program selector override.
 	void selectProgram(int iBank, int iProg);
@@ -193,6 +193,12 @@ public:
 	// Parameter update method.
 	void updateParamValues(bool bUpdate);
 
+protected:
+
+	// Real-time parameter change applier.
+	void processParam(qtractorPluginParam *pParam,
+		float fValue, unsigned long iOffset);
+
 private:
 
 	// Instance variables.
@@ -43,6 +43,10 @@
 #include <QDir>
 #include <QHash>
 
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+
 #include <zlib.h>
 
 #include <sys/stat.h>
@@ -74,6 +78,11 @@
 
 #define BUFF_SIZE 16384
 
+// Largest entry to get deflated in memory, by a worker thread;
+// and maximum memory held by those, while pending to be written.
+#define DEFLATE_MAX_SIZE  (16 * 1024 * 1024)
+#define DEFLATE_MAX_COST  (128 * 1024 * 1024)
+
 
 static inline unsigned int read_uint ( const unsigned char *data )
 {
@@ -272,6 +281,26 @@ struct FileHeader
 };
 
 
+// Entry compression policy: already compressed (or barely
+// compressible) media files are just stored, not deflated.
+static bool store_entry ( const QString& sFilename )
+{
+	static const char *s_pszStoreExts[] = {
+		"wav", "wave", "aif", "aiff", "aifc", "au", "snd", "caf",
+		"w64", "rf64", "flac", "ogg", "oga", "opus", "mp3", "m4a",
+		"wv", "zip", "qtz", "gz", "bz2", "xz", "png", "jpg", NULL
+	};
+
+	const QString& sSuffix = QFileInfo(sFilename).suffix().toLower();
+	for (int i = 0; s_pszStoreExts[i]; ++i) {
+		if (sSuffix == s_pszStoreExts[i])
+			return true;
+	}
+
+	return false;
+}
+
+
 static void copy_header ( LocalFileHeader& lfh, const CentralFileHeader& h )
 {
 	write_uint(lfh.signature, 0x04034b50);
@@ -287,10 +316,192 @@ static void copy_header ( LocalFileHeader& lfh, const CentralFileHeader& h )
 }
 
 
+//----------------------------------------------------------------------------
+// qtractorZipJob  -- ZIP entry job, to be run by a worker thread.
+//
+
+class qtractorZipJob
+{
+public:
+
+	qtractorZipJob (unsigned int iCost = 0)
+		: cost(iCost), done(false), result(false) {}
+
+	virtual ~qtractorZipJob() {}
+
+	virtual bool process() = 0;
+
+	unsigned int cost;
+	bool done;
+	bool result;
+};
+
+
+//----------------------------------------------------------------------------
+// qtractorZipThreadPool  -- ZIP entry job worker threads.
+//
+
+class qtractorZipThreadPool
+{
+public:
+
+	qtractorZipThreadPool(const QList<qtractorZipJob *>& jobs,
+		unsigned int max_cost = 0);
+
+	~qtractorZipThreadPool();
+
+	// Wait for a job to complete (main thread).
+	bool wait(qtractorZipJob *job);
+
+	// Job done with, give back its cost (main thread).
+	void release(qtractorZipJob *job);
+
+	// Next job to run (worker threads).
+	qtractorZipJob *dequeue();
+
+	// Job has completed (worker threads).
+	void done(qtractorZipJob *job, bool result);
+
+private:
+
+	QList<qtractorZipJob *> jobs;
+	int next_job;
+	unsigned int cost;
+	unsigned int max_cost;
+	bool exiting;
+
+	QMutex mutex;
+	QWaitCondition cond_ready;
+	QWaitCondition cond_done;
+
+	QList<QThread *> threads;
+};
+
+
+//----------------------------------------------------------------------------
+// qtractorZipThread  -- ZIP entry job worker thread.
+//
+
+class qtractorZipThread : public QThread
+{
+public:
+
+	qtractorZipThread (qtractorZipThreadPool *pPool)
+		: QThread(), pool(pPool) {}
+
+protected:
+
+	void run()
+	{
+		qtractorZipJob *job;
+		while ((job = pool->dequeue()) != NULL)
+			pool->done(job, job->process());
+	}
+
+private:
+
+	qtractorZipThreadPool *pool;
+};
+
+
+//----------------------------------------------------------------------------
+// qtractorZipThreadPool  -- ZIP entry job worker threads.
+//
+
+qtractorZipThreadPool::qtractorZipThreadPool (
+	const QList<qtractorZipJob *>& jobs_list, unsigned int max_cost_bytes )
+	: jobs(jobs_list), next_job(0), cost(0),
+		max_cost(max_cost_bytes), exiting(false)
+{
+	int nthreads = QThread::idealThreadCount();
+	if (nthreads > jobs.count())
+		nthreads = jobs.count();
+	if (nthreads > 8)
+		nthreads = 8;
+
+	for (int i = 0; i < nthreads; ++i) {
+		QThread *pThread = new qtractorZipThread(this);
+		pThread->start();
+		threads.append(pThread);
+	}
+}
+
+qtractorZipThreadPool::~qtractorZipThreadPool (void)
+{
+	mutex.lock();
+	exiting = true;
+	cond_ready.wakeAll();
+	mutex.unlock();
+
+	QListIterator<QThread *> iter(threads);
+	while (iter.hasNext()) {
+		QThread *pThread = iter.next();
+		pThread->wait();
+		delete pThread;
+	}
+
+	qDeleteAll(jobs);
+}
+
+
+bool qtractorZipThreadPool::wait ( qtractorZipJob *job )
+{
+	QMutexLocker locker(&mutex);
+
+	while (!job->done)
+		cond_done.wait(&mutex);
+
+	return job->result;
+}
+
+
+void qtractorZipThreadPool::release ( qtractorZipJob *job )
+{
+	QMutexLocker locker(&mutex);
+
+	cost -= job->cost;
+	job->cost = 0;
+
+	cond_ready.wakeAll();
+}
+
+
+qtractorZipJob *qtractorZipThreadPool::dequeue (void)
+{
+	QMutexLocker locker(&mutex);
+
+	while (!exiting && next_job < jobs.count()) {
+		qtractorZipJob *job = jobs.at(next_job);
+		// Never too much in memory at once...
+		if (cost == 0 || max_cost == 0 || cost + job->cost <= max_cost) {
+			cost += job->cost;
+			++next_job;
+			return job;
+		}
+		cond_ready.wait(&mutex);
+	}
+
+	return NULL;
+}
+
+
+void qtractorZipThreadPool::done ( qtractorZipJob *job, bool result )
+{
+	QMutexLocker locker(&mutex);
+
+	job->result = result;
+	job->done = true;
+
+	cond_done.wakeAll();
+}
+
+
 //----------------------------------------------------------------------------
 // qtractorZipDevice  -- Common ZIP I/O device class.
 //
 
+class qtractorZipDeflateJob;
+
 class qtractorZipDevice
 {
 public:
@@ -331,7 +542,8 @@ public:
 	bool addEntry(EntryType type, const QString& sFilename,
 		const QString& sAlias = QString());
 
-	bool processEntry(const QString& sFilename, FileHeader& fh);
+	bool processEntry(const QString& sFilename, FileHeader& fh,
+		qtractorZipDeflateJob *pJob = NULL);
 	bool processAll();
 
 	QIODevice *device;
@@ -353,6 +565,96 @@ public:
 };
 
 
+//----------------------------------------------------------------------------
+// qtractorZipExtractJob  -- Extract one zip entry (read-only).
+//
+
+class qtractorZipExtractJob : public qtractorZipJob
+{
+public:
+
+	qtractorZipExtractJob (const QString& sZipname,
+		const QString& sFilename, const FileHeader& fh )
+		: qtractorZipJob(), zip_name(sZipname),
+			file_name(sFilename), file_header(fh) {}
+
+	// Each one on its own device (file descriptor).
+	bool process()
+	{
+		qtractorZipDevice zip(new QFile(zip_name), /*bOwnDevice=*/true);
+	#ifdef QTRACTOR_PROGRESS_BAR
+		zip.progress_bar = NULL;
+	#endif
+		zip.total_uncompressed = read_uint(file_header.h.uncompressed_size);
+		return zip.extractEntry(file_name, file_header);
+	}
+
+private:
+
+	QString    zip_name;
+	QString    file_name;
+	FileHeader file_header;
+};
+
+
+//----------------------------------------------------------------------------
+// qtractorZipDeflateJob  -- Deflate one zip entry in memory (write-only).
+//
+
+class qtractorZipDeflateJob : public qtractorZipJob
+{
+public:
+
+	qtractorZipDeflateJob (const QString& sFilename, unsigned int size)
+		: qtractorZipJob(size), file_name(sFilename),
+			uncompressed_size(size), crc_32(0) {}
+
+	bool process()
+	{
+		QFile file(file_name);
+		if (!file.open(QIODevice::ReadOnly))
+			return false;
+		const QByteArray& in = file.read(uncompressed_size);
+		file.close();
+		if ((unsigned int) in.size() != uncompressed_size)
+			return false;
+
+		crc_32 = ::crc32(::crc32(0, 0, 0),
+			(const uchar *) in.constData(),
+			(ulong) uncompressed_size);
+
+		z_stream zstream;
+		memset(&zstream, 0, sizeof(zstream));
+		if (::deflateInit2(&zstream,
+				Z_DEFAULT_COMPRESSION,
+				Z_DEFLATED, -MAX_WBITS, 8,
+				Z_DEFAULT_STRATEGY) != Z_OK)
+			return false;
+
+		data.resize(::deflateBound(&zstream, uncompressed_size));
+		zstream.next_in   = (uchar *) in.constData();
+		zstream.avail_in  = (uint) uncompressed_size;
+		zstream.next_out  = (uchar *) data.data();
+		zstream.avail_out = (uint) data.size();
+		const int zrc = ::deflate(&zstream, Z_FINISH);
+		data.resize(zstream.total_out);
+		::deflateEnd(&zstream);
+
+		if (zrc != Z_STREAM_END) {
+			data.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	QString      file_name;
+	unsigned int uncompressed_size;
+	unsigned int crc_32;
+	QByteArray   data;
+};
+
+
 //----------------------------------------------------------------------------
 // qtractorZipDevice -- Common ZIP I/O device class.
 //
@@ -557,10 +859,29 @@ bool qtractorZipDevice::extractEntry (
 		if (crc_32 != read_uint(lfh.crc_32))
 			qWarning("qtractorZipDevice::extractEntry: bad CRC32!");
 	} else {
-		// No compression...
-		QByteArray data = device->read(compressed_size);
-		data.truncate(uncompressed_size);
-		pFile->write(data);
+		// No compression (stored)...
+		unsigned int nread = 0;
+		unsigned int crc_32 = ::crc32(0, 0, 0);
+		while (nread < uncompressed_size) {
+			unsigned int nbuff = BUFF_SIZE;
+			if (nread + BUFF_SIZE > uncompressed_size)
+				nbuff = uncompressed_size - nread;
+			const int nget = device->read((char *) buff_read, nbuff);
+			if (nget <= 0)
+				break;
+			pFile->write((const char *) buff_read, nget);
+			crc_32 = ::crc32(crc_32,
+				(const uchar *) buff_read,
+				(ulong) nget);
+			nread += nget;
+			total_processed += nget;
+		#ifdef QTRACTOR_PROGRESS_BAR
+			if (progress_bar) progress_bar->setValue(
+				(100.0f * float(total_processed)) / float(total_uncompressed));
+		#endif
+		}
+		if (crc_32 != read_uint(lfh.crc_32))
+			qWarning("qtractorZipDevice::extractEntry: bad CRC32!");
 	}
 
 	pFile->setPermissions(permissions_from_mode(S_IRUSR | S_IWUSR | mode));
@@ -604,6 +925,35 @@ bool qtractorZipDevice::extractAll (void)
 		= file_headers.constBegin();
 	const QHash<QString, FileHeader>::ConstIterator& iter_end
 		= file_headers.constEnd();
+
+	// Entries may be extracted in parallel,
+	// each one through its own file descriptor...
+	QFile *pZipFile = qobject_cast<QFile *> (device);
+	if (pZipFile && QThread::idealThreadCount() > 1) {
+		const QString& sZipname
+			= QFileInfo(pZipFile->fileName()).absoluteFilePath();
+		QList<qtractorZipJob *> jobs;
+		for ( ; iter != iter_end; ++iter) {
+			// Make all paths first, serially...
+			const QFileInfo info(iter.key());
+			if (!info.dir().exists())
+				QDir().mkpath(info.dir().path());
+			jobs.append(new qtractorZipExtractJob(
+				sZipname, iter.key(), iter.value()));
+		}
+		qtractorZipThreadPool pool(jobs);
+		QListIterator<qtractorZipJob *> job_iter(jobs);
+		for (iter = file_headers.constBegin(); job_iter.hasNext(); ++iter) {
+			if (pool.wait(job_iter.next()))
+				++iExtracted;
+			total_processed += read_uint(iter.value().h.uncompressed_size);
+		#ifdef QTRACTOR_PROGRESS_BAR
+			if (progress_bar) progress_bar->setValue(
+				(100.0f * float(total_processed)) / float(total_uncompressed));
+		#endif
+		}
+	}
+	else
 	for ( ; iter != iter_end; ++iter) {
 		if (extractEntry(iter.key(), iter.value()))
 			++iExtracted;
@@ -709,7 +1059,8 @@ bool qtractorZipDevice::addEntry ( EntryType type,
 
 
 // Process contents of zip archive entry (write-only).
-bool qtractorZipDevice::processEntry ( const QString& sFilename, FileHeader& fh )
+bool qtractorZipDevice::processEntry (
+	const QString& sFilename, FileHeader& fh, qtractorZipDeflateJob *pJob )
 {
 	if (!(device->isOpen() || device->open(QIODevice::WriteOnly))) {
 		status = qtractorZipFile::FileOpenError;
@@ -744,6 +1095,51 @@ bool qtractorZipDevice::processEntry ( const QString& sFilename, FileHeader& fh
 
 	unsigned int crc_32 = ::crc32(0, 0, 0);
 
+	if (pFile && pJob && pJob->result) {
+		// Already deflated by a worker thread...
+		write_ushort(fh.h.compression_method, 8); /* DEFERRED */
+		device->write(pJob->data);
+		compressed_size = pJob->data.size();
+		crc_32 = pJob->crc_32;
+		total_processed += uncompressed_size;
+	#ifdef QTRACTOR_PROGRESS_BAR
+		if (progress_bar) progress_bar->setValue(
+			(100.0f * float(total_processed)) / float(total_uncompressed));
+	#endif
+		pJob->data.clear();
+		pFile->close();
+		delete pFile;
+	}
+	else
+	if (pFile && store_entry(sFilename)) {
+		// No compression (stored)...
+		write_ushort(fh.h.compression_method, 0); /* DEFERRED */
+		unsigned int nread = 0;
+		while (nread < uncompressed_size) {
+			unsigned int nbuff = BUFF_SIZE;
+			if (nread + BUFF_SIZE > uncompressed_size)
+				nbuff = uncompressed_size - nread;
+			const int nget = pFile->read((char *) buff_read, nbuff);
+			if (nget <= 0)
+				break;
+			device->write((const char *) buff_read, nget);
+			crc_32 = ::crc32(crc_32,
+				(const uchar *) buff_read,
+				(ulong) nget);
+			nread += nget;
+			total_processed += nget;
+		#ifdef QTRACTOR_PROGRESS_BAR
+			if (progress_bar) progress_bar->setValue(
+				(100.0f * float(total_processed)) / float(total_uncompressed));
+		#endif
+		}
+		compressed_size = nread;
+		if (nread < uncompressed_size)
+			write_uint(fh.h.uncompressed_size, nread);
+		pFile->close();
+		delete pFile;
+	}
+	else
 	if (pFile) {
 		write_ushort(fh.h.compression_method, 8); /* DEFERRED */
 		unsigned int nread  = 0;
@@ -833,8 +1229,34 @@ bool qtractorZipDevice::processAll (void)
 
 	QHash<QString, FileHeader>::Iterator iter = file_headers.begin();
 	const QHash<QString, FileHeader>::Iterator& iter_end = file_headers.end();
+
+	// Smaller compressible entries get deflated in parallel,
+	// in memory, while the archive is still written in order...
+	QList<qtractorZipJob *> jobs;
+	QHash<QString, qtractorZipDeflateJob *> deflate_jobs;
 	for ( ; iter != iter_end; ++iter) {
-		if (!processEntry(iter.key(), iter.value()))
+		const FileHeader& fh = iter.value();
+		const unsigned int mode = read_uint(fh.h.external_file_attributes) >> 16;
+		const unsigned int size = read_uint(fh.h.uncompressed_size);
+		if (!S_ISREG(mode) || size > DEFLATE_MAX_SIZE
+			|| store_entry(iter.key()))
+			continue;
+		qtractorZipDeflateJob *pJob
+			= new qtractorZipDeflateJob(iter.key(), size);
+		deflate_jobs.insert(iter.key(), pJob);
+		jobs.append(pJob);
+	}
+
+	qtractorZipThreadPool pool(jobs, DEFLATE_MAX_COST);
+
+	for (iter = file_headers.begin(); iter != iter_end; ++iter) {
+		qtractorZipDeflateJob *pJob = deflate_jobs.value(iter.key(), NULL);
+		if (pJob)
+			pool.wait(pJob);
+		const bool bProcessed = processEntry(iter.key(), iter.value(), pJob);
+		if (pJob)
+			pool.release(pJob);
+		if (!bProcessed)
 			break;
 		++iProcessed;
 	}
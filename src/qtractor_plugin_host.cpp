@@ -0,0 +1,273 @@
+// qtractor_plugin_host.cpp
+//
+/****************************************************************************
+   Copyright (C) 2016, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+#include "config.h"
+
+#include "qtractor_plugin_host.h"
+
+#include <QCoreApplication>
+#include <QLibrary>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <stdlib.h>
+
+
+#ifdef CONFIG_LADSPA
+
+#include <ladspa.h>
+
+
+//----------------------------------------------------------------------
+// class qtractor_plugin_host -- LADSPA plugin (bare bones) bridge host.
+//
+
+class qtractor_plugin_host
+{
+public:
+
+	// Constructor.
+	qtractor_plugin_host(qtractor_plugin_host_shm *shm)
+		: m_shm(shm), m_pLibrary(NULL), m_pDescriptor(NULL),
+			m_handle(NULL), m_bActivated(false) {}
+
+	// Destructor.
+	~qtractor_plugin_host() { close(); }
+
+	// Command dispatcher.
+	int command(int iCommand)
+	{
+		switch (iCommand) {
+		case PluginHostOpen:
+			return (open() ? 0 : -1);
+		case PluginHostActivate:
+			if (m_handle && m_pDescriptor->activate && !m_bActivated)
+				(*m_pDescriptor->activate)(m_handle);
+			m_bActivated = true;
+			return 0;
+		case PluginHostDeactivate:
+			if (m_handle && m_pDescriptor->deactivate && m_bActivated)
+				(*m_pDescriptor->deactivate)(m_handle);
+			m_bActivated = false;
+			return 0;
+		case PluginHostRun:
+			if (m_handle == NULL)
+				return -1;
+			(*m_pDescriptor->run)(m_handle, m_shm->nframes);
+			return 0;
+		case PluginHostClose:
+			close();
+			return 0;
+		default:
+			return -1;
+		}
+	}
+
+protected:
+
+	// Load, instantiate and connect to all shared port slots.
+	bool open()
+	{
+		close();
+
+		m_pLibrary = new QLibrary(QString::fromLocal8Bit(m_shm->filename));
+		LADSPA_Descriptor_Function pfnDescriptor
+			= (LADSPA_Descriptor_Function) m_pLibrary->resolve("ladspa_descriptor");
+		if (pfnDescriptor)
+			m_pDescriptor = (*pfnDescriptor)(m_shm->index);
+		if (m_pDescriptor == NULL
+			|| m_pDescriptor->PortCount != m_shm->port_count) {
+			close();
+			return false;
+		}
+
+		m_handle = (*m_pDescriptor->instantiate)(
+			m_pDescriptor, m_shm->sample_rate);
+		if (m_handle == NULL) {
+			close();
+			return false;
+		}
+
+		for (unsigned long i = 0; i < m_pDescriptor->PortCount; ++i) {
+			(*m_pDescriptor->connect_port)(m_handle, i,
+				qtractor_plugin_host_port(m_shm, i));
+		}
+
+		return true;
+	}
+
+	// Cleanup.
+	void close()
+	{
+		if (m_handle) {
+			if (m_pDescriptor->deactivate && m_bActivated)
+				(*m_pDescriptor->deactivate)(m_handle);
+			if (m_pDescriptor->cleanup)
+				(*m_pDescriptor->cleanup)(m_handle);
+			m_handle = NULL;
+		}
+
+		m_bActivated = false;
+		m_pDescriptor = NULL;
+
+		if (m_pLibrary) {
+			m_pLibrary->unload();
+			delete m_pLibrary;
+			m_pLibrary = NULL;
+		}
+	}
+
+private:
+
+	// Instance variables.
+	qtractor_plugin_host_shm *m_shm;
+
+	QLibrary *m_pLibrary;
+
+	const LADSPA_Descriptor *m_pDescriptor;
+	LADSPA_Handle m_handle;
+
+	bool m_bActivated;
+};
+
+#endif	// CONFIG_LADSPA
+
+
+//-------------------------------------------------------------------------
+// Whether the engine has gone away: our standard input is a pipe that
+// the engine never writes to, so it only gets ready on hang-up (EOF);
+// unlike getppid() this doesn't depend on who reaps orphans, and unlike
+// PR_SET_PDEATHSIG on which engine thread happened to start us.
+//
+
+static bool qtractor_plugin_host_orphan (void)
+{
+	struct pollfd pfd;
+	pfd.fd = STDIN_FILENO;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+
+	if (::poll(&pfd, 1, 0) < 1)
+		return false;
+
+	if (pfd.revents & (POLLHUP | POLLERR | POLLNVAL))
+		return true;
+
+	char ch;
+	return (::read(STDIN_FILENO, &ch, 1) < 1);
+}
+
+
+//-------------------------------------------------------------------------
+// main - The main program trunk.
+//
+
+int main ( int argc, char **argv )
+{
+	QCoreApplication app(argc, argv);
+
+	if (argc < 2) {
+		qWarning("usage: %s <shm-name> [<rt-priority>]", argv[0]);
+		return 1;
+	}
+
+	// Map the engine provided shared-memory segment...
+	const int fd = ::shm_open(argv[1], O_RDWR, 0);
+	if (fd < 0) {
+		qWarning("%s: could not open \"%s\".", argv[0], argv[1]);
+		return 2;
+	}
+
+	struct stat st;
+	void *addr = MAP_FAILED;
+	if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+		addr = ::mmap(NULL, st.st_size,
+			PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	}
+	::close(fd);
+
+	if (addr == MAP_FAILED) {
+		qWarning("%s: could not map \"%s\".", argv[0], argv[1]);
+		return 3;
+	}
+
+	qtractor_plugin_host_shm *shm = (qtractor_plugin_host_shm *) addr;
+	if (shm->magic != QTRACTOR_PLUGIN_HOST_MAGIC
+		|| shm->size != (unsigned int) st.st_size) {
+		qWarning("%s: invalid segment \"%s\".", argv[0], argv[1]);
+		::munmap(addr, st.st_size);
+		return 4;
+	}
+
+	// Run as close as possible to the engine (real-time) thread...
+	if (argc > 2) {
+		struct sched_param param;
+		param.sched_priority = ::atoi(argv[2]);
+		if (param.sched_priority > 0)
+			::sched_setscheduler(0, SCHED_FIFO, &param);
+	}
+
+	::mlockall(MCL_CURRENT | MCL_FUTURE);
+
+#ifdef CONFIG_DEBUG
+	qDebug("%s: hello.", argv[0]);
+#endif
+
+#ifdef CONFIG_LADSPA
+	qtractor_plugin_host host(shm);
+#endif
+
+	// Serve requests until closed (or orphaned)...
+	int iResponse = ATOMIC_GET(&shm->response);
+	int iCommand = 0;
+	while (iCommand != PluginHostClose) {
+		const int iRequest = ATOMIC_GET(&shm->request);
+		if (iRequest == iResponse) {
+			// Engine gone away? bail out...
+			if (qtractor_plugin_host_orphan())
+				break;
+			qtractor_plugin_host_wait(&shm->request, iRequest, 1000000000L);
+			continue;
+		}
+		iCommand = shm->command;
+	#ifdef CONFIG_LADSPA
+		shm->result = host.command(iCommand);
+	#else
+		shm->result = -1;
+	#endif
+		iResponse = iRequest;
+		ATOMIC_SET(&shm->response, iResponse);
+		qtractor_plugin_host_wake(&shm->response);
+	}
+
+	::munmap(addr, st.st_size);
+
+#ifdef CONFIG_DEBUG
+	qDebug("%s: bye.", argv[0]);
+#endif
+
+	return 0;
+}
+
+
+// end of qtractor_plugin_host.cpp
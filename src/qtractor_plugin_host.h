@@ -0,0 +1,128 @@
+// qtractor_plugin_host.h
+//
+/****************************************************************************
+   Copyright (C) 2016, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __qtractor_plugin_host_h
+#define __qtractor_plugin_host_h
+
+#include "qtractorAtomic.h"
+
+#include <stddef.h>
+#include <time.h>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+//----------------------------------------------------------------------
+// qtractor_plugin_host -- Plug-in bridge shared-memory protocol.
+//
+// The engine side owns a POSIX shared-memory segment laid out as:
+//
+//   [qtractor_plugin_host_shm][port offsets][(aligned) float data]
+//
+// Each plug-in port gets its own data slot (one float for controls,
+// a whole buffer for audio). Every command is a synchronous handshake:
+// the engine bumps the request word and wakes the host; the host does
+// the job and sets the response word to the very same value.
+
+#define QTRACTOR_PLUGIN_HOST_MAGIC 0x71706862
+
+enum qtractor_plugin_host_command
+{
+	PluginHostOpen = 1,
+	PluginHostActivate,
+	PluginHostDeactivate,
+	PluginHostRun,
+	PluginHostClose
+};
+
+struct qtractor_plugin_host_shm
+{
+	unsigned int magic;
+	unsigned int size;
+
+	// Handshake (futex) words.
+	qtractorAtomic request;
+	qtractorAtomic response;
+
+	// Current command and its result (0=ok).
+	int command;
+	int result;
+
+	// Plug-in identification.
+	char filename[1024];
+	unsigned int index;
+
+	// Run-time parameters.
+	unsigned int sample_rate;
+	unsigned int buffer_size;
+	unsigned int nframes;
+
+	// Number of port slots (offsets follow).
+	unsigned int port_count;
+};
+
+
+// Port slot offsets (in floats), right after the header.
+static inline unsigned int *qtractor_plugin_host_offsets (
+	struct qtractor_plugin_host_shm *shm )
+{
+	return (unsigned int *) (shm + 1);
+}
+
+// Start of port data area (16-byte aligned).
+static inline size_t qtractor_plugin_host_data_offset ( unsigned int port_count )
+{
+	return (sizeof(struct qtractor_plugin_host_shm)
+		+ port_count * sizeof(unsigned int) + 15) & ~size_t(15);
+}
+
+static inline float *qtractor_plugin_host_port (
+	struct qtractor_plugin_host_shm *shm, unsigned int port )
+{
+	float *data = (float *) ((char *) shm
+		+ qtractor_plugin_host_data_offset(shm->port_count));
+	return data + qtractor_plugin_host_offsets(shm)[port];
+}
+
+
+// Handshake word wait/wake (shared futex; timeout in nanoseconds);
+// words are read and written with ATOMIC_GET/ATOMIC_SET as usual.
+static inline void qtractor_plugin_host_wait (
+	qtractorAtomic *word, int val, long timeout )
+{
+	struct timespec ts;
+	ts.tv_sec  = timeout / 1000000000L;
+	ts.tv_nsec = timeout % 1000000000L;
+	::syscall(SYS_futex, (int *) word, FUTEX_WAIT, val,
+		(timeout > 0 ? &ts : NULL), NULL, 0);
+}
+
+static inline void qtractor_plugin_host_wake ( qtractorAtomic *word )
+{
+	::syscall(SYS_futex, (int *) word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+
+#endif	// __qtractor_plugin_host_h
+
+// end of qtractor_plugin_host.h
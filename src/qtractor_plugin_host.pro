@@ -0,0 +1,26 @@
+# qtractor_plugin_host.pro
+#
+NAME = qtractor_plugin_host
+
+TARGET = $${NAME}
+TEMPLATE = app
+
+include(qtractor_plugin_host.pri)
+
+HEADERS += qtractor_plugin_host.h qtractorAtomic.h config.h
+SOURCES += qtractor_plugin_host.cpp
+
+unix {
+
+	isEmpty(PREFIX) {
+		PREFIX = /usr/local
+	}
+
+	# make install
+	INSTALLS += target
+
+	target.path = $${PREFIX}/bin
+}
+
+# No GUI support
+QT -= gui
@@ -380,7 +380,7 @@ static void qtractor_vst_scan_file ( const QString& sFilename )
 	qtractor_vst_scan plugin;
 	while (plugin.open(sFilename, i)) {
 		sout << "VST|";
-		sout << plugin.name() << '|';
+		sout << QString(plugin.name()).replace('|', '/') << '|';
 		sout << plugin.numInputs()     << ':' << plugin.numOutputs()     << '|';
 		sout << plugin.numMidiInputs() << ':' << plugin.numMidiOutputs() << '|';
 		sout << plugin.numParams()     << ':' << 0                       << '|';
@@ -391,7 +391,9 @@ static void qtractor_vst_scan_file ( const QString& sFilename )
 			flags.append("EXT");
 		flags.append("RT");
 		sout << flags.join(",") << '|';
-		sout << sFilename << '|' << i << '|';
+		// Filename escaped as in qtractorDummyPluginType::escapeText()...
+		sout << QString(sFilename).replace('%', "%25").replace('|', "%7C");
+		sout << '|' << i << '|';
 		sout << "0x" << QString::number(plugin.uniqueID(), 16) << '\n';
 		plugin.close();
 		++i;
@@ -418,13 +420,16 @@ int main ( int argc, char **argv )
 		const QString& sLine = sin.readLine();
 		if (sLine.isEmpty())
 			break;
-		const QStringList& req = sLine.split(':');
-		const QString& sHint = req.at(0).toUpper();
-		const QString& sFilename = req.at(1);
+		const QString& sHint = sLine.section(':', 0, 0).toUpper();
+		const QString& sFilename = sLine.section(':', 1);
 	#ifdef CONFIG_VST
 		if (sHint == "VST")
 			qtractor_vst_scan_file(sFilename);
 	#endif
+		// Tell this request is over...
+		QTextStream sout(stdout);
+		sout << '@' << sLine << '\n';
+		sout.flush();
 	}
 #ifdef CONFIG_DEBUG
 	qDebug("%s: bye.", argv[0]);
@@ -16,6 +16,7 @@ HEADERS += config.h \
 	qtractorAudioBuffer.h \
 	qtractorAudioClip.h \
 	qtractorAudioConnect.h \
+	qtractorAudioDelay.h \
 	qtractorAudioEngine.h \
 	qtractorAudioFile.h \
 	qtractorAudioListView.h \
@@ -91,6 +92,7 @@ HEADERS += config.h \
 	qtractorObserverWidget.h \
 	qtractorOptions.h \
 	qtractorPlugin.h \
+	qtractorPluginBridge.h \
 	qtractorPluginFactory.h \
 	qtractorPluginCommand.h \
 	qtractorPluginListView.h \
@@ -146,6 +148,7 @@ SOURCES += \
 	qtractorAudioBuffer.cpp \
 	qtractorAudioClip.cpp \
 	qtractorAudioConnect.cpp \
+	qtractorAudioDelay.cpp \
 	qtractorAudioEngine.cpp \
 	qtractorAudioFile.cpp \
 	qtractorAudioListView.cpp \
@@ -196,6 +199,7 @@ SOURCES += \
 	qtractorMidiEditTime.cpp \
 	qtractorMidiEditView.cpp \
 	qtractorMidiEngine.cpp \
+	qtractorMidiEvent.cpp \
 	qtractorMidiEventList.cpp \
 	qtractorMidiFile.cpp \
 	qtractorMidiFileTempo.cpp \
@@ -214,6 +218,7 @@ SOURCES += \
 	qtractorObserverWidget.cpp \
 	qtractorOptions.cpp \
 	qtractorPlugin.cpp \
+	qtractorPluginBridge.cpp \
 	qtractorPluginFactory.cpp \
 	qtractorPluginCommand.cpp \
 	qtractorPluginListView.cpp \